@@ -89,6 +89,26 @@
 
 %include <base-typemaps.i>
 
+// The multi-date balance functions return a GArray of gnc_numeric,
+// which becomes a list of them.
+%typemap(out) GArray *xaccAccountGetBalancesAsOfDates,
+              GArray *xaccAccountGetBalanceChangesForPeriods {
+    guint i;
+    PyObject *list = PyList_New(0);
+    for (i = 0; $1 && i < $1->len; i++)
+    {
+        gnc_numeric *n = (gnc_numeric *) calloc(1, sizeof(gnc_numeric));
+        *n = g_array_index($1, gnc_numeric, i);
+        PyObject *o = SWIG_NewPointerObj(n, $descriptor(gnc_numeric *),
+                                         SWIG_POINTER_OWN);
+        PyList_Append(list, o);
+        Py_DECREF(o);
+    }
+    if ($1)
+        g_array_free($1, TRUE);
+    $result = list;
+}
+
 %include <engine-common.i>
 
 %include <qofbackend.h>
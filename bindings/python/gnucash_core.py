@@ -702,6 +702,8 @@ account_dict =  {
 methods_return_instance(Account, account_dict)
 methods_return_instance_lists(
     Account, { 'GetSplitList': Split,
+               'GetBalancesAsOfDates': GncNumeric,
+               'GetBalanceChangesForPeriods': GncNumeric,
                'get_children': Account,
                'get_children_sorted': Account,
                'get_descendants': Account,
@@ -81,3 +81,30 @@
                                          t.tm_mday, t.tm_hour, t.tm_min,
                                          t.tm_sec, 0);
 }
+
+// A typemap for converting a python list of dates to the array of
+// time64 taken by functions such as xaccAccountGetBalancesAsOfDates.
+%typemap(in) (const time64 *dates, gsize n_dates) {
+    gsize i;
+    if (!PyList_Check($input)) {
+        PyErr_SetString(PyExc_TypeError, "not a list");
+        return NULL;
+    }
+    PyDateTime_IMPORT;
+    $2 = PyList_Size($input);
+    $1 = g_new(time64, $2);
+    for (i = 0; i < $2; i++) {
+        PyObject *o = PyList_GetItem($input, i);
+        struct tm time = {PyDateTime_DATE_GET_SECOND(o),
+                          PyDateTime_DATE_GET_MINUTE(o),
+                          PyDateTime_DATE_GET_HOUR(o),
+                          PyDateTime_GET_DAY(o),
+                          PyDateTime_GET_MONTH(o) - 1,
+                          PyDateTime_GET_YEAR(o) - 1900};
+        $1[i] = gnc_mktime(&time);
+    }
+}
+
+%typemap(freearg) (const time64 *dates, gsize n_dates) {
+    g_free($1);
+}
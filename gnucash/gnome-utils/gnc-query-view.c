@@ -121,6 +121,7 @@ gnc_query_view_construct (GNCQueryView *qview, GList *param_list, Query *query)
 
     /* more configuration */
     qview->query = qof_query_copy (query);
+    qof_query_set_cache_results (qview->query, TRUE);
     qview->column_params = param_list;
 
     /* cache the function to get the guid of this query type */
@@ -194,6 +195,7 @@ void gnc_query_view_reset_query (GNCQueryView *qview, Query *query)
 
     qof_query_destroy (qview->query);
     qview->query = qof_query_copy (query);
+    qof_query_set_cache_results (qview->query, TRUE);
 
     gnc_query_view_set_query_sort (qview, TRUE);
 }
@@ -239,7 +239,16 @@ std::string GncImportPrice::verify_essentials (void)
         return std::string();
 }
 
-Result GncImportPrice::create_price (QofBook* book, GNCPriceDB *pdb, bool over)
+static PendingPrices::key_type
+pending_key (gnc_commodity* comm, gnc_commodity* curr, const Timespec& date)
+{
+    if (comm < curr)
+        return std::make_tuple (comm, curr, date.tv_sec);
+    return std::make_tuple (curr, comm, date.tv_sec);
+}
+
+Result GncImportPrice::create_price (QofBook* book, GNCPriceDB *pdb, bool over,
+                                     PendingPrices& pending)
 {
     /* Gently refuse to create the price if the basics are not set correctly
      * This should have been tested before calling this function though!
@@ -259,13 +268,26 @@ Result GncImportPrice::create_price (QofBook* book, GNCPriceDB *pdb, bool over)
     auto amount = *m_amount;
     Result ret_val = ADDED;
 
-    GNCPrice *old_price = gnc_pricedb_lookup_day (pdb, *m_from_commodity, *m_to_currency, date);
+    // An earlier line of this import may have the day's price already
+    auto key = pending_key (*m_from_commodity, *m_to_currency, date);
+    auto pending_it = pending.find (key);
+    GNCPrice *old_price = nullptr;
+    if (pending_it != pending.end())
+    {
+        old_price = pending_it->second.price.get();
+        gnc_price_ref (old_price);
+    }
+    else
+        old_price = gnc_pricedb_lookup_day (pdb, *m_from_commodity, *m_to_currency, date);
 
     // Should old price be over writen
     if ((old_price != nullptr) && (over == true))
     {
         DEBUG("Over write");
-        gnc_pricedb_remove_price (pdb, old_price);
+        if (pending_it != pending.end())
+            pending.erase (pending_it);
+        else
+            gnc_pricedb_remove_price (pdb, old_price);
         gnc_price_unref (old_price);
         old_price = nullptr;
         ret_val = REPLACED;
@@ -317,12 +339,9 @@ Result GncImportPrice::create_price (QofBook* book, GNCPriceDB *pdb, bool over)
         gnc_price_set_typestr (price, PRICE_TYPE_LAST);
         gnc_price_commit_edit (price);
 
-        bool perr = gnc_pricedb_add_price (pdb, price);
-
-        gnc_price_unref (price);
-
-        if (perr == false)
-            throw std::invalid_argument (_("Failed to create price from selected columns."));
+        // GncPriceImport::create_prices adds them all to the pricedb at the end
+        pending.emplace (key, PendingPrice {std::unique_ptr<GNCPrice, GncPriceUnref> (price),
+                                            ret_val});
     }
     else
     {
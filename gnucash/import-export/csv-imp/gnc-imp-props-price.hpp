@@ -38,6 +38,7 @@ extern "C" {
 #include <string>
 #include <map>
 #include <memory>
+#include <tuple>
 #include <boost/optional.hpp>
 #include <gnc-datetime.hpp>
 #include <gnc-numeric.hpp>
@@ -57,6 +58,24 @@ enum class GncPricePropType {
 
 enum Result { FAILED, ADDED, DUPLICATED, REPLACED };
 
+/** Drops a reference to a price, for holding prices in smart pointers. */
+struct GncPriceUnref
+{
+    void operator()(GNCPrice* price) const { gnc_price_unref (price); }
+};
+
+/** A price created by GncImportPrice::create_price that still has to be
+ *  added to the pricedb, with how the line that made it was counted. */
+struct PendingPrice
+{
+    std::unique_ptr<GNCPrice, GncPriceUnref> price;
+    Result result;
+};
+
+/** The pending prices, keyed by their commodity pair (either way round)
+ *  and date. */
+using PendingPrices = std::map<std::tuple<gnc_commodity*, gnc_commodity*, time64>, PendingPrice>;
+
 /** Maps all column types to a string representation.
  *  The actual definition is in gnc-imp-props-price.cpp.
  *  Attention: that definition should be adjusted for any
@@ -91,7 +110,7 @@ public:
     void set_currency_format (int currency_format) { m_currency_format = currency_format ;}
     void reset (GncPricePropType prop_type);
     std::string verify_essentials (void);
-    Result create_price (QofBook* book, GNCPriceDB *pdb, bool over);
+    Result create_price (QofBook* book, GNCPriceDB *pdb, bool over, PendingPrices& pending);
 
     gnc_commodity* get_from_commodity () { if (m_from_commodity) return *m_from_commodity; else return nullptr; }
     void set_from_commodity (gnc_commodity* comm) { if (comm) m_from_commodity = comm; else m_from_commodity = boost::none; }
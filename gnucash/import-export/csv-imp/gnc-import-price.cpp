@@ -528,7 +528,8 @@ static void price_properties_verify_essentials (std::vector<parse_line_t>::itera
         throw std::invalid_argument(error_message);
 }
 
-void GncPriceImport::create_price (std::vector<parse_line_t>::iterator& parsed_line)
+void GncPriceImport::create_price (std::vector<parse_line_t>::iterator& parsed_line,
+                                   PendingPrices& pending)
 {
     StrVec line;
     std::string error_message;
@@ -584,7 +585,7 @@ void GncPriceImport::create_price (std::vector<parse_line_t>::iterator& parsed_l
         GNCPriceDB *pdb = gnc_pricedb_get_db (book);
 
         /* If all went well, add this price to the list. */
-        auto price_created = price_props->create_price (book, pdb, m_over_write);
+        auto price_created = price_props->create_price (book, pdb, m_over_write, pending);
         if (price_created == ADDED)
             m_prices_added++;
         else if (price_created == DUPLICATED)
@@ -618,21 +619,66 @@ void GncPriceImport::create_prices ()
     m_prices_replaced = 0;
 
     /* Iterate over all parsed lines */
-    for (auto parsed_lines_it = m_parsed_lines.begin();
-            parsed_lines_it != m_parsed_lines.end();
-            ++parsed_lines_it)
+    PendingPrices pending;
+    try
     {
-        /* Skip current line if the user specified so */
-        if ((std::get<PL_SKIP>(*parsed_lines_it)))
-            continue;
+        for (auto parsed_lines_it = m_parsed_lines.begin();
+                parsed_lines_it != m_parsed_lines.end();
+                ++parsed_lines_it)
+        {
+            /* Skip current line if the user specified so */
+            if ((std::get<PL_SKIP>(*parsed_lines_it)))
+                continue;
 
-        /* Should not throw anymore, otherwise verify needs revision */
-        create_price (parsed_lines_it);
+            /* Should not throw anymore, otherwise verify needs revision */
+            create_price (parsed_lines_it, pending);
+        }
+    }
+    catch (...)
+    {
+        /* Keep the prices of the lines that were counted. */
+        add_pending_prices (pending);
+        throw;
     }
+
+    add_pending_prices (pending);
     PINFO("Number of lines is %d, added %d, duplicated %d, replaced %d",
          (int)m_parsed_lines.size(), m_prices_added, m_prices_duplicated, m_prices_replaced);
 }
 
+void GncPriceImport::add_pending_prices (PendingPrices& pending)
+{
+    /* Add the new prices to the pricedb in one go */
+    GList *prices = nullptr;
+    for (auto& pending_price : pending)
+        prices = g_list_prepend (prices, pending_price.second.price.get());
+    auto pdb = gnc_pricedb_get_db (gnc_get_current_book());
+    auto added = gnc_pricedb_add_prices (pdb, prices);
+    g_list_free (prices);
+
+    if (added != static_cast<int>(pending.size()))
+    {
+        PWARN("Only %d of %d new prices could be added", added, (int)pending.size());
+        for (auto& pending_price : pending)
+        {
+            auto price = pending_price.second.price.get();
+            auto in_db = gnc_pricedb_lookup_day (pdb, gnc_price_get_commodity (price),
+                                                 gnc_price_get_currency (price),
+                                                 gnc_price_get_time (price));
+            if (in_db != price)
+            {
+                if (pending_price.second.result == ADDED)
+                    m_prices_added--;
+                else if (pending_price.second.result == REPLACED)
+                    m_prices_replaced--;
+            }
+            if (in_db)
+                gnc_price_unref (in_db);
+        }
+    }
+    pending.clear();
+}
+
 bool
 GncPriceImport::check_for_column_type (GncPricePropType type)
 {
@@ -150,9 +150,16 @@ public:
 private:
     /** A helper function used by create_prices. It will attempt
      *  to convert a single tokenized line into a price using
-     *  the column types the user has set.
+     *  the column types the user has set. The price is added to
+     *  pending rather than to the pricedb.
      */
-    void create_price (std::vector<parse_line_t>::iterator& parsed_line);
+    void create_price (std::vector<parse_line_t>::iterator& parsed_line,
+                       PendingPrices& pending);
+
+    /** Adds the pending prices to the pricedb and empties pending. Lines
+     *  whose price couldn't be added are taken off the counts.
+     */
+    void add_pending_prices (PendingPrices& pending);
 
     void verify_column_selections (ErrorListPrice& error_msg);
 
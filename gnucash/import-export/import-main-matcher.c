@@ -157,8 +157,9 @@ on_matcher_ok_clicked (GtkButton *button,
         return;
 
     /* Don't run any queries and/or split sorts while processing the matcher
-    results. */
+    results, and let each object changed tell the handlers just once. */
     gnc_suspend_gui_refresh();
+    qof_event_begin_batch();
 
     do
     {
@@ -179,6 +180,7 @@ on_matcher_ok_clicked (GtkButton *button,
     while (gtk_tree_model_iter_next (model, &iter));
 
     /* Allow GUI refresh again. */
+    qof_event_end_batch();
     gnc_resume_gui_refresh();
 
     gnc_gen_trans_list_delete (info);
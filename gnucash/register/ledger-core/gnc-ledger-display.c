@@ -636,6 +636,10 @@ gnc_ledger_display_make_query (GNCLedgerDisplay *ld,
     qof_query_destroy (ld->query);
     ld->query = qof_query_create_for(GNC_ID_SPLIT);
 
+    /* The register refreshes on every event, most of which don't
+     * change the splits it shows. */
+    qof_query_set_cache_results (ld->query, TRUE);
+
     /* This is a bit of a hack. The number of splits should be
      * configurable, or maybe we should go back a time range instead
      * of picking a number, or maybe we should be able to exclude
@@ -768,7 +772,10 @@ gnc_ledger_display_internal (Account *lead_account, Query *q,
 
     /* set up the query filter */
     if (q)
+    {
         ld->query = qof_query_copy (q);
+        qof_query_set_cache_results (ld->query, TRUE);
+    }
     else
         gnc_ledger_display_make_query (ld, limit, reg_type);
 
@@ -805,6 +812,7 @@ gnc_ledger_display_set_query (GNCLedgerDisplay *ledger_display, Query *q)
 
     qof_query_destroy (ledger_display->query);
     ledger_display->query = qof_query_copy (q);
+    qof_query_set_cache_results (ledger_display->query, TRUE);
 }
 
 GNCLedgerDisplay *
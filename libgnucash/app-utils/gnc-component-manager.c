@@ -40,8 +40,6 @@ typedef struct
 {
     GHashTable * event_masks;
     GHashTable * entity_events;
-
-    gboolean match;
 } ComponentEventInfo;
 
 typedef struct
@@ -64,8 +62,20 @@ static guint  suspend_counter = 0;
 static gint   next_component_id = 1;
 static GList *components = NULL;
 
-static ComponentEventInfo changes = { NULL, NULL, FALSE };
-static ComponentEventInfo changes_backup = { NULL, NULL, FALSE };
+static ComponentEventInfo changes = { NULL, NULL };
+static ComponentEventInfo changes_backup = { NULL, NULL };
+
+/* The components watching each entity, as a GncGUID --> GList of
+ * ComponentInfo hash, and each entity type, as a string --> GList of
+ * ComponentInfo hash, so that a refresh can go straight from the
+ * changes to the components they affect. */
+static GHashTable *entity_watchers = NULL;
+static GHashTable *type_watchers = NULL;
+
+/* What refreshing has cost, for gnc_gui_refresh_cost */
+static guint64 refresh_count = 0;
+static guint64 refresh_lookups = 0;
+static guint64 refresh_handlers_called = 0;
 
 
 /* This static indicates the debugging module that this .o belongs to.  */
@@ -167,6 +177,80 @@ destroy_event_hash (GHashTable *hash)
     g_hash_table_destroy (hash);
 }
 
+static void
+watchers_add (GHashTable *index, gpointer key, ComponentInfo *ci)
+{
+    GList *list = g_hash_table_lookup (index, key);
+
+    if (list)
+        g_hash_table_insert (index, key, g_list_prepend (list, ci));
+    else if (index == entity_watchers)
+    {
+        GncGUID *guid = guid_malloc ();
+        *guid = *(GncGUID *) key;
+        g_hash_table_insert (index, guid, g_list_prepend (NULL, ci));
+    }
+    else
+        g_hash_table_insert (index, qof_string_cache_insert (key),
+                             g_list_prepend (NULL, ci));
+}
+
+static void
+watchers_remove (GHashTable *index, gconstpointer key, ComponentInfo *ci)
+{
+    gpointer orig_key;
+    gpointer value;
+    GList *list;
+
+    if (!g_hash_table_lookup_extended (index, key, &orig_key, &value))
+        return;
+
+    list = g_list_remove (value, ci);
+    if (list)
+    {
+        g_hash_table_insert (index, orig_key, list);
+        return;
+    }
+
+    g_hash_table_remove (index, key);
+    if (index == entity_watchers)
+        guid_free (orig_key);
+    else
+        qof_string_cache_remove (orig_key);
+}
+
+static void
+init_watchers (void)
+{
+    if (entity_watchers)
+        return;
+
+    entity_watchers = guid_hash_table_new ();
+    type_watchers = g_hash_table_new (g_str_hash, g_str_equal);
+}
+
+static void
+unwatch_entity_helper (gpointer key, gpointer value, gpointer user_data)
+{
+    watchers_remove (entity_watchers, key, user_data);
+}
+
+static void
+unwatch_type_helper (gpointer key, gpointer value, gpointer user_data)
+{
+    watchers_remove (type_watchers, key, user_data);
+}
+
+static void
+destroy_watchers_helper (gpointer key, gpointer value, gpointer user_data)
+{
+    g_list_free (value);
+    if (user_data)
+        guid_free (key);
+    else
+        qof_string_cache_remove (key);
+}
+
 static void
 clear_event_info (ComponentEventInfo *cei)
 {
@@ -300,6 +384,8 @@ gnc_component_manager_init (void)
     changes_backup.event_masks = g_hash_table_new (g_str_hash, g_str_equal);
     changes_backup.entity_events = guid_hash_table_new ();
 
+    init_watchers ();
+
     handler_id = qof_event_register_handler (gnc_cm_event_handler, NULL);
 }
 
@@ -324,6 +410,15 @@ gnc_component_manager_shutdown (void)
     destroy_event_hash (changes_backup.entity_events);
     changes_backup.entity_events = NULL;
 
+    g_hash_table_foreach (entity_watchers, destroy_watchers_helper,
+                          GINT_TO_POINTER (TRUE));
+    g_hash_table_destroy (entity_watchers);
+    entity_watchers = NULL;
+
+    g_hash_table_foreach (type_watchers, destroy_watchers_helper, NULL);
+    g_hash_table_destroy (type_watchers);
+    type_watchers = NULL;
+
     qof_event_unregister_handler (handler_id);
 }
 
@@ -454,6 +549,7 @@ gnc_gui_component_watch_entity (gint component_id,
                                 QofEventId event_mask)
 {
     ComponentInfo *ci;
+    gboolean watched;
 
     if (entity == NULL)
         return;
@@ -465,7 +561,14 @@ gnc_gui_component_watch_entity (gint component_id,
         return;
     }
 
+    watched = g_hash_table_lookup (ci->watch_info.entity_events, entity) != NULL;
     add_event (&ci->watch_info, entity, event_mask, FALSE);
+
+    init_watchers ();
+    if (event_mask && !watched)
+        watchers_add (entity_watchers, (gpointer) entity, ci);
+    else if (!event_mask && watched)
+        watchers_remove (entity_watchers, entity, ci);
 }
 
 void
@@ -482,6 +585,13 @@ gnc_gui_component_watch_entity_type (gint component_id,
         return;
     }
 
+    /* A type stays in the index until the component goes, even when
+     * its mask is cleared. */
+    init_watchers ();
+    if (entity_type &&
+        !g_hash_table_lookup (ci->watch_info.event_masks, entity_type))
+        watchers_add (type_watchers, (gpointer) entity_type, ci);
+
     add_event_type (&ci->watch_info, entity_type, event_mask, FALSE);
 }
 
@@ -506,6 +616,9 @@ gnc_gui_component_clear_watches (gint component_id)
         return;
     }
 
+    if (entity_watchers)
+        g_hash_table_foreach (ci->watch_info.entity_events,
+                              unwatch_entity_helper, ci);
     clear_event_info (&ci->watch_info);
 }
 
@@ -528,6 +641,9 @@ gnc_unregister_gui_component (gint component_id)
 #endif
 
     gnc_gui_component_clear_watches (component_id);
+    if (type_watchers)
+        g_hash_table_foreach (ci->watch_info.event_masks,
+                              unwatch_type_helper, ci);
 
     components = g_list_remove (components, ci);
 
@@ -599,67 +715,56 @@ gnc_resume_gui_refresh (void)
 static void
 match_type_helper (gpointer key, gpointer value, gpointer user_data)
 {
-    ComponentEventInfo *cei = user_data;
-    QofIdType id_type = key;
+    GHashTable *matched = user_data;
     QofEventId * et = value;
-    QofEventId * et_2;
+    GList *node;
 
-    et_2 = g_hash_table_lookup (cei->event_masks, id_type);
-    if (!et_2)
+    if (*et == 0)
         return;
 
-    if (*et & *et_2)
-        cei->match = TRUE;
+    refresh_lookups++;
+    for (node = g_hash_table_lookup (type_watchers, key); node; node = node->next)
+    {
+        ComponentInfo *ci = node->data;
+        QofEventId * et_2 = g_hash_table_lookup (ci->watch_info.event_masks, key);
+
+        refresh_lookups++;
+        if (et_2 && (*et & *et_2))
+            g_hash_table_add (matched, GINT_TO_POINTER (ci->component_id));
+    }
 }
 
 static void
 match_helper (gpointer key, gpointer value, gpointer user_data)
 {
-    GncGUID *guid = key;
+    GHashTable *matched = user_data;
     EventInfo *ei_1 = value;
-    EventInfo *ei_2;
-    ComponentEventInfo *cei = user_data;
+    GList *node;
 
-    ei_2 = g_hash_table_lookup (cei->entity_events, guid);
-    if (!ei_2)
-        return;
+    refresh_lookups++;
+    for (node = g_hash_table_lookup (entity_watchers, key); node; node = node->next)
+    {
+        ComponentInfo *ci = node->data;
+        EventInfo *ei_2 = g_hash_table_lookup (ci->watch_info.entity_events, key);
 
-    if (ei_1->event_mask & ei_2->event_mask)
-        cei->match = TRUE;
+        refresh_lookups++;
+        if (ei_2 && (ei_1->event_mask & ei_2->event_mask))
+            g_hash_table_add (matched, GINT_TO_POINTER (ci->component_id));
+    }
 }
 
-static gboolean
-changes_match (ComponentEventInfo *cei, ComponentEventInfo *changes)
+/* Return the ids of the components watching the types or entities
+ * that changed, looking each change up in the watch indexes rather
+ * than each component's watches up in the changes. */
+static GHashTable *
+find_changed_components (ComponentEventInfo *changes)
 {
-    ComponentEventInfo *big_cei;
-    GHashTable *smalltable;
-
-    if (cei == NULL)
-        return FALSE;
-
-    /* check types first, for efficiency */
-    cei->match = FALSE;
-    g_hash_table_foreach (changes->event_masks, match_type_helper, cei);
-    if (cei->match)
-        return TRUE;
-
-    if (g_hash_table_size (cei->entity_events) <=
-            g_hash_table_size (changes->entity_events))
-    {
-        smalltable = cei->entity_events;
-        big_cei = changes;
-    }
-    else
-    {
-        smalltable = changes->entity_events;
-        big_cei = cei;
-    }
+    GHashTable *matched = g_hash_table_new (g_direct_hash, g_direct_equal);
 
-    big_cei->match = FALSE;
+    g_hash_table_foreach (changes->event_masks, match_type_helper, matched);
+    g_hash_table_foreach (changes->entity_events, match_helper, matched);
 
-    g_hash_table_foreach (smalltable, match_helper, big_cei);
-
-    return big_cei->match;
+    return matched;
 }
 
 static void
@@ -667,11 +772,13 @@ gnc_gui_refresh_internal (gboolean force)
 {
     GList *list;
     GList *node;
+    GHashTable *matched = NULL;
 
     if (!got_events && !force)
         return;
 
     gnc_suspend_gui_refresh ();
+    refresh_count++;
 
     {
         GHashTable *table;
@@ -689,6 +796,9 @@ gnc_gui_refresh_internal (gboolean force)
     fprintf (stderr, "%srefresh!\n", force ? "forced " : "");
 #endif
 
+    if (!force)
+        matched = find_changed_components (&changes_backup);
+
     list = find_component_ids_by_class (NULL);
     // reverse the list so class GncPluginPageRegister is before register-single
     list = g_list_reverse (list);
@@ -715,16 +825,18 @@ gnc_gui_refresh_internal (gboolean force)
 #if CM_DEBUG
                 fprintf (stderr, "calling %s:%d C handler\n", ci->component_class, ci->component_id);
 #endif
+                refresh_handlers_called++;
                 ci->refresh_handler (NULL, ci->user_data);
             }
         }
-        else if (changes_match (&ci->watch_info, &changes_backup))
+        else if (g_hash_table_contains (matched, GINT_TO_POINTER (ci->component_id)))
         {
             if (ci->refresh_handler)
             {
 #if CM_DEBUG
                 fprintf (stderr, "calling %s:%d C handler\n", ci->component_class, ci->component_id);
 #endif
+                refresh_handlers_called++;
                 ci->refresh_handler (changes_backup.entity_events, ci->user_data);
             }
         }
@@ -740,6 +852,8 @@ gnc_gui_refresh_internal (gboolean force)
     got_events = FALSE;
 
     g_list_free (list);
+    if (matched)
+        g_hash_table_destroy (matched);
 
     gnc_resume_gui_refresh ();
 }
@@ -762,6 +876,18 @@ gnc_gui_refresh_suspended (void)
     return suspend_counter != 0;
 }
 
+void
+gnc_gui_refresh_cost (guint64 *refreshes, guint64 *lookups,
+                      guint64 *handlers_called)
+{
+    if (refreshes)
+        *refreshes = refresh_count;
+    if (lookups)
+        *lookups = refresh_lookups;
+    if (handlers_called)
+        *handlers_called = refresh_handlers_called;
+}
+
 void
 gnc_close_gui_component (gint component_id)
 {
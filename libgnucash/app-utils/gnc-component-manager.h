@@ -253,6 +253,15 @@ void gnc_gui_refresh_all (void);
  */
 gboolean gnc_gui_refresh_suspended (void);
 
+/* gnc_gui_refresh_cost
+ *   For profiling: return the number of refreshes so far, the
+ *   number of watch lookups they made to find the components the
+ *   changes affect and the number of refresh handlers they called.
+ *   Any of the arguments may be NULL.
+ */
+void gnc_gui_refresh_cost (guint64 *refreshes, guint64 *lookups,
+                           guint64 *handlers_called);
+
 /* gnc_close_gui_component
  *   Invoke the close handler for the indicated component.
  *
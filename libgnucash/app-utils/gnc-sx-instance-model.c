@@ -566,6 +566,7 @@ gnc_sx_instance_model_dispose(GObject *object)
     model->disposed = TRUE;
 
     qof_event_unregister_handler(model->qof_event_handler_id);
+    qof_event_unregister_handler(model->qof_sxes_event_handler_id);
 
     G_OBJECT_CLASS(parent_class)->dispose(object);
 }
@@ -682,7 +683,13 @@ gnc_sx_instance_model_init(GTypeInstance *instance, gpointer klass)
 
     g_date_clear(&inst->range_end, 1);
     inst->sx_instance_list = NULL;
-    inst->qof_event_handler_id = qof_event_register_handler(_gnc_sx_instance_event_handler, inst);
+    inst->qof_event_handler_id
+        = qof_event_register_type_handler(GNC_ID_SCHEDXACTION, QOF_EVENT_MODIFY,
+                                          _gnc_sx_instance_event_handler, inst);
+    inst->qof_sxes_event_handler_id
+        = qof_event_register_type_handler(GNC_ID_SXES,
+                                          GNC_EVENT_ITEM_ADDED | GNC_EVENT_ITEM_REMOVED,
+                                          _gnc_sx_instance_event_handler, inst);
 }
 
 static gint
@@ -0,0 +1,205 @@
+/********************************************************************
+ * test-gnc-component-manager.c: GLib g_test test suite for         *
+ * gnc-component-manager.c.                                         *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, you can retrieve it from        *
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html            *
+ * or contact:                                                      *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ ********************************************************************/
+
+#include <config.h>
+#include <glib.h>
+#include <unittest-support.h>
+#include <qof.h>
+#include <gnc-engine.h>
+
+#include "../gnc-component-manager.h"
+
+static const gchar *suitename = "/app-utils/gnc-component-manager";
+void test_suite_gnc_component_manager (void);
+
+/* What one registered component has been told. */
+typedef struct
+{
+    gint id;
+    const GncGUID *acct;
+    guint refreshes;
+    QofEventId acct_events;     /* acct's events in the last refresh */
+} Watcher;
+
+typedef struct
+{
+    QofBook *book;
+    QofInstance *acct;
+    QofInstance *other_acct;
+    QofInstance *trans;
+    Watcher by_entity;          /* watches acct for modifications */
+    Watcher by_type;            /* watches transactions for modifications */
+    Watcher idle;               /* watches nothing */
+} Fixture;
+
+static void
+refresh_handler (GHashTable *changes, gpointer user_data)
+{
+    Watcher *watcher = user_data;
+    const EventInfo *info = gnc_gui_get_entity_events (changes, watcher->acct);
+
+    watcher->refreshes++;
+    watcher->acct_events = info ? info->event_mask : QOF_EVENT_NONE;
+}
+
+static void
+watcher_register (Watcher *watcher, const char *component_class,
+                  QofInstance *acct)
+{
+    watcher->acct = qof_instance_get_guid (acct);
+    watcher->refreshes = 0;
+    watcher->acct_events = QOF_EVENT_NONE;
+    watcher->id = gnc_register_gui_component (component_class,
+                                              refresh_handler, NULL,
+                                              watcher);
+    g_assert_cmpint (watcher->id, !=, NO_COMPONENT);
+}
+
+static QofInstance*
+entity_new (QofIdType type, QofBook *book)
+{
+    QofInstance *inst = g_object_new (QOF_TYPE_INSTANCE, NULL);
+    qof_instance_init_data (inst, type, book);
+    return inst;
+}
+
+static void
+setup (Fixture *fixture, gconstpointer pData)
+{
+    fixture->book = qof_book_new ();
+    fixture->acct = entity_new (GNC_ID_ACCOUNT, fixture->book);
+    fixture->other_acct = entity_new (GNC_ID_ACCOUNT, fixture->book);
+    fixture->trans = entity_new (GNC_ID_TRANS, fixture->book);
+
+    watcher_register (&fixture->by_entity, "test-by-entity", fixture->acct);
+    gnc_gui_component_watch_entity (fixture->by_entity.id,
+                                    qof_instance_get_guid (fixture->acct),
+                                    QOF_EVENT_MODIFY);
+    watcher_register (&fixture->by_type, "test-by-type", fixture->acct);
+    gnc_gui_component_watch_entity_type (fixture->by_type.id, GNC_ID_TRANS,
+                                         QOF_EVENT_MODIFY);
+    watcher_register (&fixture->idle, "test-idle", fixture->acct);
+}
+
+static void
+teardown (Fixture *fixture, gconstpointer pData)
+{
+    gnc_unregister_gui_component (fixture->by_entity.id);
+    gnc_unregister_gui_component (fixture->by_type.id);
+    gnc_unregister_gui_component (fixture->idle.id);
+    g_object_unref (fixture->acct);
+    g_object_unref (fixture->other_acct);
+    g_object_unref (fixture->trans);
+    qof_book_destroy (fixture->book);
+}
+
+/* Fire one event and return how many refresh handlers it ran. */
+static guint64
+fire (QofInstance *inst, QofEventId event)
+{
+    guint64 before, after;
+
+    gnc_gui_refresh_cost (NULL, NULL, &before);
+    qof_event_gen (inst, event, NULL);
+    gnc_gui_refresh_cost (NULL, NULL, &after);
+    return after - before;
+}
+
+static void
+test_refresh_matching (Fixture *fixture, gconstpointer pData)
+{
+    /* Only the component watching the account hears it change. */
+    g_assert_cmpuint (fire (fixture->acct, QOF_EVENT_MODIFY), ==, 1);
+    g_assert_cmpuint (fixture->by_entity.refreshes, ==, 1);
+    g_assert_cmpuint (fixture->by_entity.acct_events, ==, QOF_EVENT_MODIFY);
+    g_assert_cmpuint (fixture->by_type.refreshes, ==, 0);
+    g_assert_cmpuint (fixture->idle.refreshes, ==, 0);
+
+    /* Neither another account of the same type nor an event outside the
+     * watched mask refreshes anything. */
+    g_assert_cmpuint (fire (fixture->other_acct, QOF_EVENT_MODIFY), ==, 0);
+    g_assert_cmpuint (fire (fixture->acct, QOF_EVENT_ADD), ==, 0);
+    g_assert_cmpuint (fire (fixture->trans, QOF_EVENT_CREATE), ==, 0);
+
+    /* Any transaction reaches the component watching the type. */
+    g_assert_cmpuint (fire (fixture->trans, QOF_EVENT_MODIFY), ==, 1);
+    g_assert_cmpuint (fixture->by_type.refreshes, ==, 1);
+    g_assert_cmpuint (fixture->by_type.acct_events, ==, QOF_EVENT_NONE);
+    g_assert_cmpuint (fixture->by_entity.refreshes, ==, 1);
+    g_assert_cmpuint (fixture->idle.refreshes, ==, 0);
+
+    /* While suspended the changes gather, and each interested component
+     * is refreshed once when refreshing resumes. */
+    gnc_suspend_gui_refresh ();
+    g_assert_cmpuint (fire (fixture->acct, QOF_EVENT_MODIFY), ==, 0);
+    g_assert_cmpuint (fire (fixture->trans, QOF_EVENT_MODIFY), ==, 0);
+    g_assert_cmpuint (fire (fixture->acct, QOF_EVENT_MODIFY), ==, 0);
+    gnc_resume_gui_refresh ();
+    g_assert_cmpuint (fixture->by_entity.refreshes, ==, 2);
+    g_assert_cmpuint (fixture->by_entity.acct_events, ==, QOF_EVENT_MODIFY);
+    g_assert_cmpuint (fixture->by_type.refreshes, ==, 2);
+    g_assert_cmpuint (fixture->by_type.acct_events, ==, QOF_EVENT_MODIFY);
+    g_assert_cmpuint (fixture->idle.refreshes, ==, 0);
+}
+
+static void
+test_refresh_cleared_masks (Fixture *fixture, gconstpointer pData)
+{
+    /* Clearing the entity watch leaves the type watch working. */
+    gnc_gui_component_watch_entity (fixture->by_entity.id,
+                                    qof_instance_get_guid (fixture->acct), 0);
+    g_assert_cmpuint (fire (fixture->acct, QOF_EVENT_MODIFY), ==, 0);
+    g_assert_cmpuint (fire (fixture->trans, QOF_EVENT_MODIFY), ==, 1);
+    g_assert_cmpuint (fixture->by_entity.refreshes, ==, 0);
+    g_assert_cmpuint (fixture->by_type.refreshes, ==, 1);
+
+    /* Watching again picks the entity up again. */
+    gnc_gui_component_watch_entity (fixture->by_entity.id,
+                                    qof_instance_get_guid (fixture->acct),
+                                    QOF_EVENT_MODIFY);
+    g_assert_cmpuint (fire (fixture->acct, QOF_EVENT_MODIFY), ==, 1);
+    g_assert_cmpuint (fixture->by_entity.refreshes, ==, 1);
+
+    /* A cleared type mask stays in the index but matches nothing. */
+    gnc_gui_component_watch_entity_type (fixture->by_type.id, GNC_ID_TRANS, 0);
+    g_assert_cmpuint (fire (fixture->trans, QOF_EVENT_MODIFY), ==, 0);
+    g_assert_cmpuint (fire (fixture->acct, QOF_EVENT_MODIFY), ==, 1);
+    g_assert_cmpuint (fixture->by_type.refreshes, ==, 1);
+    g_assert_cmpuint (fixture->by_entity.refreshes, ==, 2);
+
+    /* Clearing all of a component's watches silences it. */
+    gnc_gui_component_clear_watches (fixture->by_entity.id);
+    g_assert_cmpuint (fire (fixture->acct, QOF_EVENT_MODIFY), ==, 0);
+    g_assert_cmpuint (fixture->by_entity.refreshes, ==, 2);
+    g_assert_cmpuint (fixture->idle.refreshes, ==, 0);
+}
+
+void
+test_suite_gnc_component_manager (void)
+{
+    GNC_TEST_ADD (suitename, "refresh matching", Fixture, NULL, setup,
+                  test_refresh_matching, teardown);
+    GNC_TEST_ADD (suitename, "refresh cleared masks", Fixture, NULL, setup,
+                  test_refresh_cleared_masks, teardown);
+}
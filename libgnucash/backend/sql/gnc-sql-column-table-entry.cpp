@@ -103,8 +103,12 @@ GncSqlColumnTableEntry::add_objectref_guid_to_query (QofIdTypeConst obj_name,
     if (inst == nullptr) return;
     auto guid = qof_instance_get_guid (inst);
     if (guid != nullptr)
+    {
+        char guid_buf[GUID_ENCODING_LENGTH + 1];
+        guid_to_string_buff (guid, guid_buf);
         vec.emplace_back (std::make_pair (std::string{m_col_name},
-                                          quote_string(guid_to_string(guid))));
+                                          quote_string(guid_buf)));
+    }
 }
 
 void
@@ -361,8 +365,10 @@ GncSqlColumnTableEntryImpl<CT_GUID>::add_to_query(QofIdTypeConst obj_name,
     if (s != nullptr)
     {
 
+        char guid_buf[GUID_ENCODING_LENGTH + 1];
+        guid_to_string_buff (s, guid_buf);
         vec.emplace_back (std::make_pair (std::string{m_col_name},
-                                          quote_string(guid_to_string(s))));
+                                          quote_string(guid_buf)));
         return;
     }
 }
@@ -689,24 +695,6 @@ GncSqlColumnTableEntryImpl<CT_NUMERIC>::add_to_query(QofIdTypeConst obj_name,
     vec.emplace_back (denom_col, buf.str ());
 }
 
-static void
-_retrieve_guid_ (gpointer pObject,  gpointer pValue)
-{
-    GncGUID* pGuid = (GncGUID*)pObject;
-    GncGUID* guid = (GncGUID*)pValue;
-
-    g_return_if_fail (pObject != NULL);
-    g_return_if_fail (pValue != NULL);
-
-    memcpy (pGuid, guid, sizeof (GncGUID));
-}
-
-// Table to retrieve just the guid
-static EntryVec guid_table
-{
-    gnc_sql_make_table_entry<CT_GUID>("guid", 0, 0, nullptr, _retrieve_guid_)
-};
-
 const GncGUID*
 gnc_sql_load_guid (const GncSqlBackend* sql_be, GncSqlRow& row)
 {
@@ -714,7 +702,16 @@ gnc_sql_load_guid (const GncSqlBackend* sql_be, GncSqlRow& row)
 
     g_return_val_if_fail (sql_be != NULL, NULL);
 
-    gnc_sql_load_object (sql_be, row, NULL, &guid, guid_table);
+    /* Every object load starts here, so parse the column directly
+     * instead of going through a one-column EntryVec. */
+    try
+    {
+        auto str = row.get_string_at_col ("guid");
+        string_to_guid (str.c_str(), &guid);
+    }
+    catch (std::invalid_argument)
+    {
+    }
 
     return &guid;
 }
@@ -266,6 +266,8 @@ load_splits_for_tx_list (GncSqlBackend* sql_be, InstanceVec& transactions)
     auto result = sql_be->execute_select_statement (stmt);
     InstanceVec instances;
 
+    auto col = qof_book_get_collection (sql_be->book(), GNC_ID_SPLIT);
+    qof_collection_reserve (col, qof_collection_count (col) + result->size());
     for (auto row : *result)
     {
         Split* s = load_single_split (sql_be, row);
@@ -364,6 +366,8 @@ query_transactions (GncSqlBackend* sql_be, const GncSqlStatementPtr& stmt)
 
     // Load the transactions
     InstanceVec instances;
+    auto col = qof_book_get_collection (sql_be->book(), GNC_ID_TRANS);
+    qof_collection_reserve (col, qof_collection_count (col) + result->size());
     for (auto row : *result)
     {
         tx = load_single_tx (sql_be, row);
@@ -415,10 +415,18 @@ gnc_counter_end_handler (gpointer data_for_children,
     else if (g_strcmp0 (type, "transaction") == 0)
     {
         sixdata->counter.transactions_total = val;
+        /* There are no split counts, but every transaction has at least
+         * two of them. */
+        qof_collection_reserve (qof_book_get_collection (sixdata->book,
+                                                         GNC_ID_TRANS), val);
+        qof_collection_reserve (qof_book_get_collection (sixdata->book,
+                                                         GNC_ID_SPLIT), 2 * val);
     }
     else if (g_strcmp0 (type, "account") == 0)
     {
         sixdata->counter.accounts_total = val;
+        qof_collection_reserve (qof_book_get_collection (sixdata->book,
+                                                         GNC_ID_ACCOUNT), val);
     }
     else if (g_strcmp0 (type, "book") == 0)
     {
@@ -439,6 +447,8 @@ gnc_counter_end_handler (gpointer data_for_children,
     else if (g_strcmp0 (type, "price") == 0)
     {
         sixdata->counter.prices_total = val;
+        qof_collection_reserve (qof_book_get_collection (sixdata->book,
+                                                         GNC_ID_PRICE), val);
     }
     else
     {
@@ -61,12 +61,24 @@ dom_tree_to_guid (xmlNodePtr node)
         /* handle new and guid the same for the moment */
         if ((g_strcmp0 ("guid", type) == 0) || (g_strcmp0 ("new", type) == 0))
         {
-            auto gid = guid_new ();
-            char* guid_str;
+            auto gid = guid_malloc ();
+            auto text = node->xmlChildrenNode;
 
-            guid_str = (char*)xmlNodeGetContent (node->xmlChildrenNode);
-            string_to_guid (guid_str, gid);
-            xmlFree (guid_str);
+            /* Books have millions of these, so parse a lone text node's
+             * content in place rather than copying it. */
+            if (text && text->type == XML_TEXT_NODE && !text->next &&
+                text->content)
+            {
+                if (!string_to_guid ((char*)text->content, gid))
+                    guid_replace (gid);
+            }
+            else
+            {
+                auto guid_str = (char*)xmlNodeGetContent (text);
+                if (!string_to_guid (guid_str, gid))
+                    guid_replace (gid);
+                xmlFree (guid_str);
+            }
             xmlFree (type);
             return gid;
         }
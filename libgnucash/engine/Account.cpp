@@ -40,10 +40,17 @@
 #include "gnc-lot.h"
 #include "gnc-pricedb.h"
 #include "qofinstance-p.h"
+#include "qofquery-p.h"
 #include "gnc-features.h"
 #include "guid.hpp"
 
+#include <algorithm>
+#include <map>
+#include <memory>
 #include <numeric>
+#include <string>
+#include <tuple>
+#include <unordered_map>
 
 static QofLogModule log_module = GNC_MOD_ACCOUNT;
 
@@ -243,6 +250,329 @@ mark_account (Account *acc)
     qof_instance_set_dirty(&acc->inst);
 }
 
+/********************************************************************\
+ * The per-book index behind the gnc_account_lookup_by_* functions. *
+ * It maps each name, code and full name to the accounts that have  *
+ * it, and is built the first time a book's accounts are looked up. *
+ * From then on the account setters and the reparenting functions   *
+ * keep it up to date.                                              *
+\********************************************************************/
+
+#define GNC_ACCOUNT_INDEX "gnc-account-index"
+
+typedef std::unordered_map<std::string, std::vector<Account*>> AccountMap;
+
+/* The keys under which an account is filed. */
+struct AccountKeys
+{
+    std::string name;
+    std::string code;
+    std::string full_name;
+    bool has_name;
+    bool has_code;
+    bool has_full_name;
+};
+
+struct AccountIndex
+{
+    AccountMap by_name;
+    AccountMap by_code;
+    AccountMap by_full_name;
+    std::unordered_map<Account*, AccountKeys> keys;
+    std::string separator;
+};
+
+static void
+account_map_remove (AccountMap& map, const std::string& key, Account *acc)
+{
+    auto entry = map.find (key);
+    if (entry == map.end())
+        return;
+    auto& accounts = entry->second;
+    accounts.erase (std::remove (accounts.begin(), accounts.end(), acc),
+                    accounts.end());
+    if (accounts.empty())
+        map.erase (entry);
+}
+
+/* The full name by which gnc_account_lookup_by_full_name can reach acc:
+ * the names from below the top of its tree down to it.  Tops of trees,
+ * and accounts with a separator in their name or an ancestor's, can't
+ * be reached. */
+static bool
+account_index_full_name (const Account *acc, const std::string& separator,
+                         std::string& full_name)
+{
+    std::vector<const char*> names;
+    for (auto priv = GET_PRIVATE(acc); priv->parent;
+         priv = GET_PRIVATE(priv->parent))
+    {
+        if (!priv->accountName ||
+            strstr (priv->accountName, separator.c_str()))
+            return false;
+        names.push_back (priv->accountName);
+    }
+    if (names.empty())
+        return false;
+
+    full_name.clear();
+    for (auto name = names.rbegin(); name != names.rend(); ++name)
+    {
+        if (name != names.rbegin())
+            full_name += separator;
+        full_name += *name;
+    }
+    return true;
+}
+
+static void
+account_index_forget (AccountIndex *index, Account *acc)
+{
+    auto entry = index->keys.find (acc);
+    if (entry == index->keys.end())
+        return;
+    auto& keys = entry->second;
+    if (keys.has_name)
+        account_map_remove (index->by_name, keys.name, acc);
+    if (keys.has_code)
+        account_map_remove (index->by_code, keys.code, acc);
+    if (keys.has_full_name)
+        account_map_remove (index->by_full_name, keys.full_name, acc);
+    index->keys.erase (entry);
+}
+
+static void
+account_index_learn (AccountIndex *index, Account *acc)
+{
+    auto priv = GET_PRIVATE(acc);
+    AccountKeys keys {};
+
+    keys.has_name = priv->accountName != NULL;
+    if (keys.has_name)
+    {
+        keys.name = priv->accountName;
+        index->by_name[keys.name].push_back (acc);
+    }
+    keys.has_code = priv->accountCode != NULL;
+    if (keys.has_code)
+    {
+        keys.code = priv->accountCode;
+        index->by_code[keys.code].push_back (acc);
+    }
+    keys.has_full_name = account_index_full_name (acc, index->separator,
+                                                  keys.full_name);
+    if (keys.has_full_name)
+        index->by_full_name[keys.full_name].push_back (acc);
+    index->keys[acc] = std::move (keys);
+}
+
+static void
+account_index_destroy (QofBook *book, gpointer key, gpointer data)
+{
+    delete static_cast<AccountIndex*>(data);
+}
+
+static void
+account_index_learn_cb (QofInstance *inst, gpointer data)
+{
+    account_index_learn (static_cast<AccountIndex*>(data), GNC_ACCOUNT(inst));
+}
+
+/* The book's index, if anything has been looked up in it yet.  A book
+ * that is being destroyed has none. */
+static AccountIndex *
+account_index_lookup (QofBook *book)
+{
+    if (!book || qof_book_shutting_down (book))
+        return NULL;
+    return static_cast<AccountIndex*>(qof_book_get_data (book,
+                                                         GNC_ACCOUNT_INDEX));
+}
+
+/* The book's index, built if need be, with its full names made with the
+ * current account separator.  A book that is being destroyed has none,
+ * and its data can no longer hold one, so callers have to search the
+ * tree themselves. */
+static AccountIndex *
+account_index_get (QofBook *book)
+{
+    if (!book || qof_book_shutting_down (book))
+        return NULL;
+
+    auto index = account_index_lookup (book);
+    if (index && index->separator == gnc_get_account_separator_string())
+        return index;
+
+    if (index)
+    {
+        index->by_name.clear();
+        index->by_code.clear();
+        index->by_full_name.clear();
+        index->keys.clear();
+    }
+    else
+    {
+        index = new AccountIndex;
+        qof_book_set_data_fin (book, GNC_ACCOUNT_INDEX, index,
+                               account_index_destroy);
+    }
+    index->separator = gnc_get_account_separator_string();
+    qof_collection_foreach (qof_book_get_collection (book, GNC_ID_ACCOUNT),
+                            account_index_learn_cb, index);
+    return index;
+}
+
+/* Refile acc, and if subtree is set all of its descendants, after a
+ * change to its name, code or place in the tree. */
+static void
+account_index_update (Account *acc, bool subtree)
+{
+    auto index = account_index_lookup (gnc_account_get_book (acc));
+    if (!index)
+        return;
+
+    account_index_forget (index, acc);
+    account_index_learn (index, acc);
+    if (!subtree)
+        return;
+    gnc_account_foreach_descendant (acc, [](Account *child, gpointer data)
+                                    {
+                                        auto index =
+                                            static_cast<AccountIndex*>(data);
+                                        account_index_forget (index, child);
+                                        account_index_learn (index, child);
+                                    }, index);
+}
+
+static void
+account_index_remove (Account *acc)
+{
+    auto index = account_index_lookup (gnc_account_get_book (acc));
+    if (index)
+        account_index_forget (index, acc);
+}
+
+/********************************************************************\
+ * Each book keeps its account trees flattened into depth-first     *
+ * arrays, so that the descendants of an account are the slice of   *
+ * its tree's array that follows it.  Any change to the hierarchy,  *
+ * or to the names, codes and types that the sorted order depends   *
+ * on, starts a new generation and the arrays are rebuilt the next  *
+ * time they are wanted.                                            *
+\********************************************************************/
+
+#define GNC_ACCOUNT_TREES "gnc-account-trees"
+
+struct AccountTree : std::enable_shared_from_this<AccountTree>
+{
+    std::vector<Account*> accounts;     /* children in list order */
+    std::vector<Account*> sorted;       /* children by xaccAccountOrder */
+};
+
+/* The book's trees, by their topmost account. */
+typedef std::unordered_map<const Account*,
+                           std::shared_ptr<AccountTree>> AccountTrees;
+
+/* Shared by all books so that an account's cached position can never
+ * be mistaken for one in a newer tree. */
+static guint64 account_tree_generation = 1;
+
+static void
+account_trees_destroy (QofBook *book, gpointer key, gpointer data)
+{
+    ++account_tree_generation;
+    delete static_cast<AccountTrees*>(data);
+}
+
+static void
+account_tree_changed (const Account *acc)
+{
+    auto book = gnc_account_get_book (acc);
+
+    ++account_tree_generation;
+    if (!book || qof_book_shutting_down (book))
+        return;
+    auto trees = static_cast<AccountTrees*>(qof_book_get_data (book,
+                                                               GNC_ACCOUNT_TREES));
+    if (trees)
+        trees->clear();
+}
+
+static void
+account_tree_add (AccountTree *tree, Account *acc)
+{
+    auto priv = GET_PRIVATE(acc);
+
+    priv->tree = tree;
+    priv->tree_generation = account_tree_generation;
+    priv->tree_pos = tree->accounts.size();
+    tree->accounts.push_back (acc);
+    for (auto node = priv->children; node; node = node->next)
+        account_tree_add (tree, static_cast<Account*>(node->data));
+    priv->tree_end = tree->accounts.size();
+}
+
+static void
+account_tree_add_sorted (AccountTree *tree, Account *acc)
+{
+    auto priv = GET_PRIVATE(acc);
+    std::vector<Account*> children;
+
+    priv->tree_sorted_pos = tree->sorted.size();
+    tree->sorted.push_back (acc);
+    for (auto node = priv->children; node; node = node->next)
+        children.push_back (static_cast<Account*>(node->data));
+    std::stable_sort (children.begin(), children.end(),
+                      [](const Account *a, const Account *b)
+                      { return xaccAccountOrder (a, b) < 0; });
+    for (auto child : children)
+        account_tree_add_sorted (tree, child);
+}
+
+/* The current tree holding acc, built if need be.  There is none while
+ * the book is being destroyed. */
+static AccountTree *
+account_tree_get (const Account *acc, bool sorted)
+{
+    auto priv = GET_PRIVATE(acc);
+    auto book = gnc_account_get_book (acc);
+
+    if (!book || qof_book_shutting_down (book))
+        return NULL;
+
+    if (!priv->tree || priv->tree_generation != account_tree_generation)
+    {
+        auto trees = static_cast<AccountTrees*>(qof_book_get_data (book,
+                                                                   GNC_ACCOUNT_TREES));
+        if (!trees)
+        {
+            trees = new AccountTrees;
+            qof_book_set_data_fin (book, GNC_ACCOUNT_TREES, trees,
+                                   account_trees_destroy);
+        }
+
+        auto top = const_cast<Account*>(acc);
+        while (GET_PRIVATE(top)->parent)
+            top = GET_PRIVATE(top)->parent;
+        auto tree = std::make_shared<AccountTree>();
+        account_tree_add (tree.get(), top);
+        (*trees)[top] = tree;
+
+        /* Only while a child is being removed is it missing from the
+         * children of the parent it still points to. */
+        if (priv->tree_generation != account_tree_generation)
+            return NULL;
+    }
+
+    auto tree = priv->tree;
+    if (sorted && tree->sorted.empty())
+    {
+        tree->sorted.reserve (tree->accounts.size());
+        account_tree_add_sorted (tree, tree->accounts.front());
+    }
+    return tree;
+}
+
 /********************************************************************\
 \********************************************************************/
 
@@ -257,6 +587,8 @@ gnc_account_init(Account* acc)
     priv = GET_PRIVATE(acc);
     priv->parent   = NULL;
     priv->children = NULL;
+    priv->tree = NULL;
+    priv->tree_generation = 0;
 
     priv->accountName = static_cast<char*>(qof_string_cache_insert(""));
     priv->accountCode = static_cast<char*>(qof_string_cache_insert(""));
@@ -281,8 +613,13 @@ gnc_account_init(Account* acc)
     priv->starting_reconciled_balance = gnc_numeric_zero();
     priv->balance_dirty = FALSE;
 
-    priv->splits = NULL;
+    /* GObject only zeroes the private area, so the C++ members have to
+     * be constructed by hand; gnc_account_finalize destroys them. */
+    new (&priv->splits) SplitsVec ();
     priv->sort_dirty = FALSE;
+    priv->split_list = NULL;
+    new (&priv->split_nodes) std::vector<GList*> ();
+    new (&priv->pending_splits) std::unordered_set<Split*> ();
 }
 
 static void
@@ -294,6 +631,13 @@ gnc_account_dispose (GObject *acctp)
 static void
 gnc_account_finalize(GObject* acctp)
 {
+    AccountPrivate *priv = GET_PRIVATE(acctp);
+
+    g_list_free (priv->split_list);
+    priv->split_list = NULL;
+    priv->split_nodes.~vector ();
+    priv->splits.~SplitsVec ();
+    priv->pending_splits.~unordered_set ();
     G_OBJECT_CLASS(gnc_account_parent_class)->finalize(acctp);
 }
 
@@ -1111,6 +1455,8 @@ gnc_account_create_root (QofBook *book)
     xaccAccountBeginEdit(root);
     rpriv->type = ACCT_TYPE_ROOT;
     rpriv->accountName = qof_string_cache_replace(rpriv->accountName, "Root Account");
+    account_tree_changed (root);
+    account_index_update (root, false);
     mark_account (root);
     xaccAccountCommitEdit(root);
     gnc_book_set_root_account(book, root);
@@ -1232,27 +1578,26 @@ xaccFreeAccount (Account *acc)
     /* NB there shouldn't be any splits by now ... they should
      * have been all been freed by CommitEdit().  We can remove this
      * check once we know the warning isn't occurring any more. */
-    if (priv->splits)
+    if (!priv->splits.empty())
     {
-        GList *slist;
         PERR (" instead of calling xaccFreeAccount(), please call \n"
               " xaccAccountBeginEdit(); xaccAccountDestroy(); \n");
 
         qof_instance_reset_editlevel(acc);
 
-        slist = g_list_copy(priv->splits);
-        for (lp = slist; lp; lp = lp->next)
+        auto slist = priv->splits;
+        for (auto s : slist)
         {
-            Split *s = (Split *) lp->data;
             g_assert(xaccSplitGetAccount(s) == acc);
             xaccSplitDestroy (s);
         }
-        g_list_free(slist);
-/* Nothing here (or in xaccAccountCommitEdit) NULLs priv->splits, so this asserts every time.
-        g_assert(priv->splits == NULL);
+/* Nothing here (or in xaccAccountCommitEdit) empties priv->splits, so this asserts every time.
+        g_assert(priv->splits.empty());
 */
     }
 
+    account_tree_changed (acc);
+    account_index_remove (acc);
     qof_string_cache_remove(priv->accountName);
     qof_string_cache_remove(priv->accountCode);
     qof_string_cache_remove(priv->description);
@@ -1338,7 +1683,7 @@ xaccAccountCommitEdit (Account *acc)
     priv = GET_PRIVATE(acc);
     if (qof_instance_get_destroying(acc))
     {
-        GList *lp, *slist;
+        GList *lp;
         QofCollection *col;
 
         qof_instance_increase_editlevel(acc);
@@ -1355,18 +1700,16 @@ xaccAccountCommitEdit (Account *acc)
            themselves will be destroyed by the transaction code */
         if (!qof_book_shutting_down(book))
         {
-            slist = g_list_copy(priv->splits);
-            for (lp = slist; lp; lp = lp->next)
-            {
-                Split *s = static_cast<Split *>(lp->data);
+            auto slist = priv->splits;
+            for (auto s : slist)
                 xaccSplitDestroy (s);
-            }
-            g_list_free(slist);
         }
         else
         {
-            g_list_free(priv->splits);
-            priv->splits = NULL;
+            priv->splits.clear();
+            priv->split_nodes.clear();
+            g_list_free(priv->split_list);
+            priv->split_list = NULL;
         }
 
         /* It turns out there's a case where this assertion does not hold:
@@ -1374,7 +1717,7 @@ xaccAccountCommitEdit (Account *acc)
            deleting all the splits in it.  The splits will just get
            recreated and put right back into the same account!
 
-           g_assert(priv->splits == NULL || qof_book_shutting_down(acc->inst.book));
+           g_assert(priv->splits.empty() || qof_book_shutting_down(acc->inst.book));
         */
 
         if (!qof_book_shutting_down(book))
@@ -1646,39 +1989,30 @@ xaccAccountEqual(const Account *aa, const Account *ab, gboolean check_guids)
     /* no parent; always compare downwards. */
 
     {
-        GList *la = priv_aa->splits;
-        GList *lb = priv_ab->splits;
+        const auto& la = priv_aa->splits;
+        const auto& lb = priv_ab->splits;
 
-        if ((la && !lb) || (!la && lb))
+        if (la.empty() != lb.empty())
         {
             PWARN ("only one has splits");
             return FALSE;
         }
 
-        if (la && lb)
+        /* presume that the splits are in the same order */
+        for (size_t i = 0; i < la.size() && i < lb.size(); ++i)
         {
-            /* presume that the splits are in the same order */
-            while (la && lb)
+            if (!xaccSplitEqual(la[i], lb[i], check_guids, TRUE, FALSE))
             {
-                Split *sa = (Split *) la->data;
-                Split *sb = (Split *) lb->data;
-
-                if (!xaccSplitEqual(sa, sb, check_guids, TRUE, FALSE))
-                {
-                    PWARN ("splits differ");
-                    return(FALSE);
-                }
-
-                la = la->next;
-                lb = lb->next;
-            }
-
-            if ((la != NULL) || (lb != NULL))
-            {
-                PWARN ("number of splits differs");
+                PWARN ("splits differ");
                 return(FALSE);
             }
         }
+
+        if (la.size() != lb.size())
+        {
+            PWARN ("number of splits differs");
+            return(FALSE);
+        }
     }
 
     if (!xaccAcctChildrenEqual(priv_aa->children, priv_ab->children, check_guids))
@@ -1692,6 +2026,18 @@ xaccAccountEqual(const Account *aa, const Account *ab, gboolean check_guids)
 
 /********************************************************************\
 \********************************************************************/
+
+/* Note that the running balances from position pos of the split array
+ * on need recomputing.  While balance_dirty is FALSE balance_dirty_from
+ * is kept at 0, so that setting balance_dirty alone means "all". */
+static void
+account_balance_dirty_from (AccountPrivate *priv, size_t pos)
+{
+    if (!priv->balance_dirty || pos < priv->balance_dirty_from)
+        priv->balance_dirty_from = pos;
+    priv->balance_dirty = TRUE;
+}
+
 void
 gnc_account_set_sort_dirty (Account *acc)
 {
@@ -1717,34 +2063,134 @@ gnc_account_set_balance_dirty (Account *acc)
         return;
 
     priv = GET_PRIVATE(acc);
-    priv->balance_dirty = TRUE;
+    account_balance_dirty_from (priv, 0);
 }
 
 /********************************************************************\
 \********************************************************************/
 
+/* The order in which an account keeps its splits. */
+static bool
+split_less (const Split *a, const Split *b)
+{
+    return xaccSplitOrder (a, b) < 0;
+}
+
+void
+gnc_account_split_changed (Account *acc, Split *s)
+{
+    AccountPrivate *priv;
+
+    g_return_if_fail(GNC_IS_ACCOUNT(acc));
+
+    if (qof_instance_get_destroying(acc))
+        return;
+
+    priv = GET_PRIVATE(acc);
+    auto& splits = priv->splits;
+    /* It's usually a recent split that is being edited, so look for it
+     * from the end; that costs no more than recomputing the balances
+     * after it will. */
+    auto rpos = std::find (splits.rbegin(), splits.rend(), s);
+    /* Not (yet) one of ours; inserting it will dirty what it has to. */
+    if (rpos == splits.rend())
+        return;
+
+    auto pos = rpos.base() - 1;
+    account_balance_dirty_from (priv, pos - splits.begin());
+    if ((pos != splits.begin() && split_less (s, *(pos - 1))) ||
+        (pos + 1 != splits.end() && split_less (*(pos + 1), s)))
+        priv->sort_dirty = TRUE;
+}
+
+/* Insert s at position pos of priv->splits, keeping the GList view, if
+ * one has been handed out, in step. */
+static void
+account_splits_insert (AccountPrivate *priv, SplitsVec::iterator pos, Split *s)
+{
+    auto idx = pos - priv->splits.begin();
+    priv->splits.insert (pos, s);
+    if (!priv->split_list)
+        return;
+
+    auto node = g_list_alloc ();
+    auto next = static_cast<size_t>(idx) < priv->split_nodes.size() ?
+        priv->split_nodes[idx] : nullptr;
+    auto prev = next ? next->prev : priv->split_nodes.back();
+    node->data = s;
+    node->next = next;
+    node->prev = prev;
+    if (next)
+        next->prev = node;
+    if (prev)
+        prev->next = node;
+    else
+        priv->split_list = node;
+    priv->split_nodes.insert (priv->split_nodes.begin() + idx, node);
+}
+
+static void
+account_splits_erase (AccountPrivate *priv, SplitsVec::iterator pos)
+{
+    auto idx = pos - priv->splits.begin();
+    priv->splits.erase (pos);
+    if (!priv->split_list)
+        return;
+
+    priv->split_list = g_list_delete_link (priv->split_list,
+                                           priv->split_nodes[idx]);
+    priv->split_nodes.erase (priv->split_nodes.begin() + idx);
+}
+
+/* Find s in the account.  While the splits are known to be in order
+ * this is a binary search; otherwise it falls back to a scan of the
+ * pointer array, which at least never calls xaccSplitOrder(). */
+static SplitsVec::iterator
+account_find_split (AccountPrivate *priv, const Split *s)
+{
+    auto& splits = priv->splits;
+    if (!priv->sort_dirty)
+    {
+        auto pos = std::lower_bound (splits.begin(), splits.end(), s,
+                                     split_less);
+        if (pos != splits.end() && *pos == s)
+            return pos;
+    }
+    return std::find (splits.begin(), splits.end(), s);
+}
+
 gboolean
 gnc_account_insert_split (Account *acc, Split *s)
 {
     AccountPrivate *priv;
-    GList *node;
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), FALSE);
     g_return_val_if_fail(GNC_IS_SPLIT(s), FALSE);
 
     priv = GET_PRIVATE(acc);
-    node = g_list_find(priv->splits, s);
-    if (node)
-        return FALSE;
-
     if (qof_instance_get_editlevel(acc) == 0)
     {
-        priv->splits = g_list_insert_sorted(priv->splits, s,
-                                            (GCompareFunc)xaccSplitOrder);
+        xaccAccountSortSplits (acc, FALSE);
+        auto pos = std::lower_bound (priv->splits.begin(), priv->splits.end(),
+                                     s, split_less);
+        if (pos != priv->splits.end() && *pos == s)
+            return FALSE;
+        account_balance_dirty_from (priv, pos - priv->splits.begin());
+        account_splits_insert (priv, pos, s);
     }
     else
     {
-        priv->splits = g_list_prepend(priv->splits, s);
+        /* Bulk loads add many splits to an account that is being
+         * edited, so just append and sort once when the edit is
+         * committed.  Once the splits are out of order a duplicate
+         * can't be found cheaply; xaccAccountSortSplits drops any it
+         * finds. */
+        if (!priv->sort_dirty && std::binary_search (priv->splits.begin(),
+                                                     priv->splits.end(),
+                                                     s, split_less))
+            return FALSE;
+        account_balance_dirty_from (priv, priv->splits.size());
+        account_splits_insert (priv, priv->splits.end(), s);
         priv->sort_dirty = TRUE;
     }
 
@@ -1753,7 +2199,6 @@ gnc_account_insert_split (Account *acc, Split *s)
     /* Also send an event based on the account */
     qof_event_gen(&acc->inst, GNC_EVENT_ITEM_ADDED, s);
 
-    priv->balance_dirty = TRUE;
 //  DRH: Should the below be added? It is present in the delete path.
 //  xaccAccountRecomputeBalance(acc);
     return TRUE;
@@ -1763,27 +2208,55 @@ gboolean
 gnc_account_remove_split (Account *acc, Split *s)
 {
     AccountPrivate *priv;
-    GList *node;
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), FALSE);
     g_return_val_if_fail(GNC_IS_SPLIT(s), FALSE);
 
     priv = GET_PRIVATE(acc);
-    node = g_list_find(priv->splits, s);
-    if (NULL == node)
+    auto pos = account_find_split (priv, s);
+    if (pos == priv->splits.end())
         return FALSE;
 
-    priv->splits = g_list_delete_link(priv->splits, node);
+    account_balance_dirty_from (priv, pos - priv->splits.begin());
+    account_splits_erase (priv, pos);
     //FIXME: find better event type
     qof_event_gen(&acc->inst, QOF_EVENT_MODIFY, NULL);
     // And send the account-based event, too
     qof_event_gen(&acc->inst, GNC_EVENT_ITEM_REMOVED, s);
 
-    priv->balance_dirty = TRUE;
     xaccAccountRecomputeBalance(acc);
     return TRUE;
 }
 
+void
+gnc_account_add_pending_split (Account *acc, Split *s)
+{
+    g_return_if_fail(GNC_IS_ACCOUNT(acc));
+    g_return_if_fail(s);
+
+    GET_PRIVATE(acc)->pending_splits.insert (s);
+}
+
+void
+gnc_account_remove_pending_split (Account *acc, Split *s)
+{
+    g_return_if_fail(GNC_IS_ACCOUNT(acc));
+
+    GET_PRIVATE(acc)->pending_splits.erase (s);
+}
+
+void
+gnc_account_foreach_pending_split (const Account *acc,
+                                   QofInstanceForeachCB thunk,
+                                   gpointer user_data)
+{
+    g_return_if_fail(GNC_IS_ACCOUNT(acc));
+    g_return_if_fail(thunk);
+
+    for (auto s : GET_PRIVATE(acc)->pending_splits)
+        thunk (QOF_INSTANCE(s), user_data);
+}
+
 void
 xaccAccountSortSplits (Account *acc, gboolean force)
 {
@@ -1794,9 +2267,46 @@ xaccAccountSortSplits (Account *acc, gboolean force)
     priv = GET_PRIVATE(acc);
     if (!priv->sort_dirty || (!force && qof_instance_get_editlevel(acc) > 0))
         return;
-    priv->splits = g_list_sort(priv->splits, (GCompareFunc)xaccSplitOrder);
+
+    auto& splits = priv->splits;
+    auto from = splits.size();
+    auto unsorted = std::is_sorted_until (splits.begin(), splits.end(),
+                                          split_less);
+    if (unsorted != splits.end())
+    {
+        /* Nothing ahead of where the lowest of the out of order splits
+         * belongs has to move, and the balances there stay good. */
+        auto lowest = *std::min_element (unsorted, splits.end(), split_less);
+        auto first = std::upper_bound (splits.begin(), unsorted, lowest,
+                                       split_less);
+        from = first - splits.begin();
+        std::sort (first, splits.end(), split_less);
+    }
+    /* A split appended twice can sit next to itself in what already
+     * looked sorted, so check the whole vector for duplicates. */
+    auto dup = std::adjacent_find (splits.begin(), splits.end());
+    if (dup != splits.end())
+    {
+        from = std::min (from, static_cast<size_t>(dup - splits.begin()));
+        auto last = std::unique (dup, splits.end());
+        PERR ("Account %s holds %ld duplicate splits.", priv->accountName,
+              static_cast<long>(splits.end() - last));
+        splits.erase (last, splits.end());
+        while (priv->split_nodes.size() > splits.size())
+        {
+            priv->split_list = g_list_delete_link (priv->split_list,
+                                                   priv->split_nodes.back());
+            priv->split_nodes.pop_back();
+        }
+    }
+    if (from < splits.size())
+    {
+        /* The view keeps its nodes; only their contents move. */
+        for (size_t i = from; i < priv->split_nodes.size(); ++i)
+            priv->split_nodes[i]->data = splits[i];
+        account_balance_dirty_from (priv, from);
+    }
     priv->sort_dirty = FALSE;
-    priv->balance_dirty = TRUE;
 }
 
 static void
@@ -1994,7 +2504,7 @@ xaccAccountMoveAllSplits (Account *accfrom, Account *accto)
 
     /* optimizations */
     from_priv = GET_PRIVATE(accfrom);
-    if (!from_priv->splits || accfrom == accto)
+    if (from_priv->splits.empty() || accfrom == accto)
         return;
 
     /* check for book mix-up */
@@ -2004,7 +2514,8 @@ xaccAccountMoveAllSplits (Account *accfrom, Account *accto)
     xaccAccountBeginEdit(accfrom);
     xaccAccountBeginEdit(accto);
     /* Begin editing both accounts and all transactions in accfrom. */
-    g_list_foreach(from_priv->splits, (GFunc)xaccPreSplitMove, NULL);
+    for (auto s : from_priv->splits)
+        xaccPreSplitMove (s, NULL);
 
     /* Concatenate accfrom's lists of splits and lots to accto's lists. */
     //to_priv->splits = g_list_concat(to_priv->splits, from_priv->splits);
@@ -2021,10 +2532,12 @@ xaccAccountMoveAllSplits (Account *accfrom, Account *accto)
      * Convert each split's amount to accto's commodity.
      * Commit to editing each transaction.
      */
-    g_list_foreach(from_priv->splits, (GFunc)xaccPostSplitMove, (gpointer)accto);
+    auto splits = from_priv->splits;
+    for (auto s : splits)
+        xaccPostSplitMove (s, accto);
 
     /* Finally empty accfrom. */
-    g_assert(from_priv->splits == NULL);
+    g_assert(from_priv->splits.empty());
     g_assert(from_priv->lots == NULL);
     xaccAccountCommitEdit(accfrom);
     xaccAccountCommitEdit(accto);
@@ -2068,7 +2581,6 @@ xaccAccountRecomputeBalance (Account * acc)
     gnc_numeric  balance;
     gnc_numeric  cleared_balance;
     gnc_numeric  reconciled_balance;
-    GList *lp;
 
     if (NULL == acc) return;
 
@@ -2078,15 +2590,28 @@ xaccAccountRecomputeBalance (Account * acc)
     if (qof_instance_get_destroying(acc)) return;
     if (qof_book_shutting_down(qof_instance_get_book(acc))) return;
 
-    balance            = priv->starting_balance;
-    cleared_balance    = priv->starting_cleared_balance;
-    reconciled_balance = priv->starting_reconciled_balance;
+    /* Pick up from the running balance just before the first split
+     * that has changed. */
+    auto from = std::min (priv->balance_dirty_from, priv->splits.size());
+    if (from == 0)
+    {
+        balance            = priv->starting_balance;
+        cleared_balance    = priv->starting_cleared_balance;
+        reconciled_balance = priv->starting_reconciled_balance;
+    }
+    else
+    {
+        auto prev = priv->splits[from - 1];
+        balance            = prev->balance;
+        cleared_balance    = prev->cleared_balance;
+        reconciled_balance = prev->reconciled_balance;
+    }
 
     PINFO ("acct=%s starting baln=%" G_GINT64_FORMAT "/%" G_GINT64_FORMAT,
            priv->accountName, balance.num, balance.denom);
-    for (lp = priv->splits; lp; lp = lp->next)
+    for (auto it = priv->splits.begin() + from; it != priv->splits.end(); ++it)
     {
-        Split *split = (Split *) lp->data;
+        auto split = *it;
         gnc_numeric amt = xaccSplitGetAmount (split);
 
         balance = gnc_numeric_add_fixed(balance, amt);
@@ -2113,6 +2638,7 @@ xaccAccountRecomputeBalance (Account * acc)
     priv->cleared_balance = cleared_balance;
     priv->reconciled_balance = reconciled_balance;
     priv->balance_dirty = FALSE;
+    priv->balance_dirty_from = 0;
 }
 
 /********************************************************************\
@@ -2227,7 +2753,8 @@ xaccAccountSetType (Account *acc, GNCAccountType tip)
 
     xaccAccountBeginEdit(acc);
     priv->type = tip;
-    priv->balance_dirty = TRUE; /* new type may affect balance computation */
+    account_tree_changed (acc);
+    account_balance_dirty_from (priv, 0); /* new type may affect balance computation */
     mark_account(acc);
     xaccAccountCommitEdit(acc);
 }
@@ -2248,6 +2775,8 @@ xaccAccountSetName (Account *acc, const char *str)
 
     xaccAccountBeginEdit(acc);
     priv->accountName = qof_string_cache_replace(priv->accountName, str);
+    account_tree_changed (acc);
+    account_index_update (acc, true);
     mark_account (acc);
     xaccAccountCommitEdit(acc);
 }
@@ -2267,6 +2796,8 @@ xaccAccountSetCode (Account *acc, const char *str)
 
     xaccAccountBeginEdit(acc);
     priv->accountCode = qof_string_cache_replace(priv->accountCode, str ? str : "");
+    account_tree_changed (acc);
+    account_index_update (acc, false);
     mark_account (acc);
     xaccAccountCommitEdit(acc);
 }
@@ -2379,7 +2910,6 @@ void
 xaccAccountSetCommodity (Account * acc, gnc_commodity * com)
 {
     AccountPrivate *priv;
-    GList *lp;
 
     /* errors */
     g_return_if_fail(GNC_IS_ACCOUNT(acc));
@@ -2398,9 +2928,8 @@ xaccAccountSetCommodity (Account * acc, gnc_commodity * com)
     priv->non_standard_scu = FALSE;
 
     /* iterate over splits */
-    for (lp = priv->splits; lp; lp = lp->next)
+    for (auto s : priv->splits)
     {
-        Split *s = (Split *) lp->data;
         Transaction *trans = xaccSplitGetParent (s);
 
         xaccTransBeginEdit (trans);
@@ -2409,7 +2938,7 @@ xaccAccountSetCommodity (Account * acc, gnc_commodity * com)
     }
 
     priv->sort_dirty = TRUE;  /* Not needed. */
-    priv->balance_dirty = TRUE;
+    account_balance_dirty_from (priv, 0);
     mark_account (acc);
 
     xaccAccountCommitEdit(acc);
@@ -2553,6 +3082,8 @@ gnc_account_append_child (Account *new_parent, Account *child)
              */
             PWARN ("reparenting accounts across books is not correctly supported\n");
 
+            account_tree_changed (child);
+            account_index_remove (child);
             qof_event_gen (&child->inst, QOF_EVENT_DESTROY, NULL);
             col = qof_book_get_collection (qof_instance_get_book(new_parent),
                                            GNC_ID_ACCOUNT);
@@ -2562,6 +3093,8 @@ gnc_account_append_child (Account *new_parent, Account *child)
     }
     cpriv->parent = new_parent;
     ppriv->children = g_list_append(ppriv->children, child);
+    account_tree_changed (child);
+    account_index_update (child, true);
     qof_instance_set_dirty(&new_parent->inst);
     qof_instance_set_dirty(&child->inst);
 
@@ -2602,12 +3135,14 @@ gnc_account_remove_child (Account *parent, Account *child)
     ed.idx = g_list_index(ppriv->children, child);
 
     ppriv->children = g_list_remove(ppriv->children, child);
+    account_tree_changed (child);
 
     /* Now send the event. */
     qof_event_gen(&child->inst, QOF_EVENT_REMOVE, &ed);
 
     /* clear the account's parent pointer after REMOVE event generation. */
     cpriv->parent = NULL;
+    account_index_update (child, true);
 
     qof_event_gen (&parent->inst, QOF_EVENT_MODIFY, NULL);
 }
@@ -2697,6 +3232,9 @@ gnc_account_n_descendants (const Account *account)
     g_return_val_if_fail(GNC_IS_ACCOUNT(account), 0);
 
     priv = GET_PRIVATE(account);
+    if (account_tree_get (account, false))
+        return priv->tree_end - priv->tree_pos - 1;
+
     for (node = priv->children; node; node = g_list_next(node))
     {
         count += gnc_account_n_descendants(static_cast<Account*>(node->data)) + 1;
@@ -2744,11 +3282,23 @@ gnc_account_get_tree_depth (const Account *account)
     return depth + 1;
 }
 
+/* Make a list of count accounts from the array. */
+static GList *
+account_list_from (Account * const *accounts, size_t count)
+{
+    GList *list = NULL;
+
+    while (count)
+        list = g_list_prepend (list, accounts[--count]);
+    return list;
+}
+
 GList *
 gnc_account_get_descendants (const Account *account)
 {
     AccountPrivate *priv;
     GList *child, *descendants;
+    AccountTree *tree;
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(account), NULL);
 
@@ -2756,6 +3306,11 @@ gnc_account_get_descendants (const Account *account)
     if (!priv->children)
         return NULL;
 
+    tree = account_tree_get (account, false);
+    if (tree)
+        return account_list_from (&tree->accounts[priv->tree_pos + 1],
+                                  priv->tree_end - priv->tree_pos - 1);
+
     descendants = NULL;
     for (child = priv->children; child; child = g_list_next(child))
     {
@@ -2771,6 +3326,7 @@ gnc_account_get_descendants_sorted (const Account *account)
 {
     AccountPrivate *priv;
     GList *child, *children, *descendants;
+    AccountTree *tree;
 
     /* errors */
     g_return_val_if_fail(GNC_IS_ACCOUNT(account), NULL);
@@ -2780,6 +3336,11 @@ gnc_account_get_descendants_sorted (const Account *account)
     if (!priv->children)
         return NULL;
 
+    tree = account_tree_get (account, true);
+    if (tree)
+        return account_list_from (&tree->sorted[priv->tree_sorted_pos + 1],
+                                  priv->tree_end - priv->tree_pos - 1);
+
     descendants = NULL;
     children = g_list_sort(g_list_copy(priv->children), (GCompareFunc)xaccAccountOrder);
     for (child = children; child; child = g_list_next(child))
@@ -2792,65 +3353,109 @@ gnc_account_get_descendants_sorted (const Account *account)
     return descendants;
 }
 
-Account *
-gnc_account_lookup_by_name (const Account *parent, const char * name)
+/* The accounts leading from just below ancestor down to acc, or false
+ * if acc isn't a descendant of ancestor.  Only follows parent
+ * pointers, so it costs the depth of acc and not the width of the
+ * tree. */
+static bool
+account_path_from (const Account *ancestor, const Account *acc,
+                   std::vector<const Account*>& path)
 {
-    AccountPrivate *cpriv, *ppriv;
-    Account *child, *result;
-    GList *node;
-
-    g_return_val_if_fail(GNC_IS_ACCOUNT(parent), NULL);
-    g_return_val_if_fail(name, NULL);
-
-    /* first, look for accounts hanging off the current node */
-    ppriv = GET_PRIVATE(parent);
-    for (node = ppriv->children; node; node = node->next)
+    path.clear();
+    while (acc != ancestor)
     {
-        child = static_cast<Account*>(node->data);
-        cpriv = GET_PRIVATE(child);
-        if (g_strcmp0(cpriv->accountName, name) == 0)
-            return child;
+        auto parent = GET_PRIVATE(acc)->parent;
+        if (!parent)
+            return false;
+        path.push_back (acc);
+        acc = parent;
     }
+    std::reverse (path.begin(), path.end());
+    return !path.empty();
+}
 
-    /* if we are still here, then we haven't found the account yet.
-     * Recursively search each of the child accounts next */
-    for (node = ppriv->children; node; node = node->next)
+/* Whether sibling a comes before sibling b among their parent's
+ * children.  The cached tree positions say so directly; without a
+ * tree, count along the children list. */
+static bool
+account_sibling_before (const Account *a, const Account *b,
+                        const AccountTree *tree)
+{
+    if (tree)
+        return GET_PRIVATE(a)->tree_pos < GET_PRIVATE(b)->tree_pos;
+    auto children = GET_PRIVATE(GET_PRIVATE(a)->parent)->children;
+    return g_list_index (children, a) < g_list_index (children, b);
+}
+
+/* Whether a tree walk that checks all of a node's children before
+ * searching below each of them in turn reaches path a before path b. */
+static bool
+account_path_searched_first (const Account * const *a, size_t a_len,
+                             const Account * const *b, size_t b_len,
+                             const AccountTree *tree)
+{
+    if (a_len == 1 || b_len == 1)
+        return a_len == 1 &&
+            (b_len > 1 || account_sibling_before (a[0], b[0], tree));
+    if (a[0] != b[0])
+        return account_sibling_before (a[0], b[0], tree);
+    return account_path_searched_first (a + 1, a_len - 1, b + 1, b_len - 1,
+                                        tree);
+}
+
+/* The descendant of parent filed under key that the old recursive
+ * search would have found first.  Sibling order is only needed to
+ * choose between several descendants with the same key. */
+static Account *
+account_index_find (const AccountMap& map, const Account *parent,
+                    const char *key)
+{
+    auto entry = map.find (key);
+    if (entry == map.end())
+        return NULL;
+
+    Account *found = NULL;
+    const AccountTree *tree = NULL;
+    std::vector<const Account*> best, path;
+    for (auto acc : entry->second)
     {
-        child = static_cast<Account*>(node->data);
-        result = gnc_account_lookup_by_name (child, name);
-        if (result)
-            return result;
+        if (!account_path_from (parent, acc, path))
+            continue;
+        if (found)
+        {
+            if (!tree)
+                tree = account_tree_get (parent, false);
+            if (!account_path_searched_first (path.data(), path.size(),
+                                              best.data(), best.size(),
+                                              tree))
+                continue;
+        }
+        found = acc;
+        best.swap (path);
     }
-
-    return NULL;
+    return found;
 }
 
-Account *
-gnc_account_lookup_by_code (const Account *parent, const char * code)
+/* The search the index replaces, for books that can't have one: the
+ * children of parent first, then each of their subtrees in turn. */
+static Account *
+account_lookup_walk (const Account *parent, const char *key,
+                     char *AccountPrivate::*field)
 {
-    AccountPrivate *cpriv, *ppriv;
-    Account *child, *result;
+    const AccountPrivate *ppriv = GET_PRIVATE(parent);
     GList *node;
 
-    g_return_val_if_fail(GNC_IS_ACCOUNT(parent), NULL);
-    g_return_val_if_fail(code, NULL);
-
-    /* first, look for accounts hanging off the current node */
-    ppriv = GET_PRIVATE(parent);
     for (node = ppriv->children; node; node = node->next)
     {
-        child = static_cast<Account*>(node->data);
-        cpriv = GET_PRIVATE(child);
-        if (g_strcmp0(cpriv->accountCode, code) == 0)
+        Account *child = static_cast<Account*>(node->data);
+        if (g_strcmp0(GET_PRIVATE(child)->*field, key) == 0)
             return child;
     }
 
-    /* if we are still here, then we haven't found the account yet.
-     * Recursively search each of the child accounts next */
     for (node = ppriv->children; node; node = node->next)
     {
-        child = static_cast<Account*>(node->data);
-        result = gnc_account_lookup_by_code (child, code);
+        Account *result = account_lookup_walk (static_cast<Account*>(node->data),
+                                               key, field);
         if (result)
             return result;
     }
@@ -2858,6 +3463,30 @@ gnc_account_lookup_by_code (const Account *parent, const char * code)
     return NULL;
 }
 
+Account *
+gnc_account_lookup_by_name (const Account *parent, const char * name)
+{
+    g_return_val_if_fail(GNC_IS_ACCOUNT(parent), NULL);
+    g_return_val_if_fail(name, NULL);
+
+    auto index = account_index_get (gnc_account_get_book (parent));
+    if (!index)
+        return account_lookup_walk (parent, name, &AccountPrivate::accountName);
+    return account_index_find (index->by_name, parent, name);
+}
+
+Account *
+gnc_account_lookup_by_code (const Account *parent, const char * code)
+{
+    g_return_val_if_fail(GNC_IS_ACCOUNT(parent), NULL);
+    g_return_val_if_fail(code, NULL);
+
+    auto index = account_index_get (gnc_account_get_book (parent));
+    if (!index)
+        return account_lookup_walk (parent, code, &AccountPrivate::accountCode);
+    return account_index_find (index->by_code, parent, code);
+}
+
 /********************************************************************\
  * Fetch an account, given its full name                            *
 \********************************************************************/
@@ -2910,8 +3539,6 @@ gnc_account_lookup_by_full_name (const Account *any_acc,
 {
     const AccountPrivate *rpriv;
     const Account *root;
-    Account *found;
-    gchar **names;
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(any_acc), NULL);
     g_return_val_if_fail(name, NULL);
@@ -2923,9 +3550,43 @@ gnc_account_lookup_by_full_name (const Account *any_acc,
         root = rpriv->parent;
         rpriv = GET_PRIVATE(root);
     }
-    names = g_strsplit(name, gnc_get_account_separator_string(), -1);
-    found = gnc_account_lookup_by_full_name_helper(root, names);
-    g_strfreev(names);
+
+    if (!*name)
+        return NULL;
+    auto index = account_index_get (gnc_account_get_book (root));
+    if (!index)
+    {
+        auto names = g_strsplit (name, gnc_get_account_separator_string(), -1);
+        auto found = gnc_account_lookup_by_full_name_helper (root, names);
+        g_strfreev (names);
+        return found;
+    }
+    auto entry = index->by_full_name.find (name);
+    if (entry == index->by_full_name.end())
+        return NULL;
+
+    /* Accounts with the same full name are all at the same depth, so the
+     * first one a depth-first search reaches is the first to branch off
+     * to an earlier sibling. */
+    Account *found = NULL;
+    const AccountTree *tree = NULL;
+    std::vector<const Account*> best, path;
+    for (auto acc : entry->second)
+    {
+        if (!account_path_from (root, acc, path))
+            continue;
+        if (found)
+        {
+            if (!tree)
+                tree = account_tree_get (root, false);
+            auto diff = std::mismatch (path.begin(), path.end(), best.begin());
+            if (diff.first == path.end() ||
+                !account_sibling_before (*diff.first, *diff.second, tree))
+                continue;
+        }
+        found = acc;
+        best.swap (path);
+    }
     return found;
 }
 
@@ -2960,6 +3621,18 @@ gnc_account_foreach_descendant (const Account *acc,
     g_return_if_fail(thunk);
 
     priv = GET_PRIVATE(acc);
+    if (!priv->children)
+        return;
+
+    /* Hold on to the array in case thunk changes the tree. */
+    if (auto tree = account_tree_get (acc, false))
+    {
+        auto hold = tree->shared_from_this();
+        for (auto pos = priv->tree_pos + 1, end = priv->tree_end; pos < end; ++pos)
+            thunk (hold->accounts[pos], user_data);
+        return;
+    }
+
     for (node = priv->children; node; node = node->next)
     {
         child = static_cast<Account*>(node->data);
@@ -2982,6 +3655,18 @@ gnc_account_foreach_descendant_until (const Account *acc,
     g_return_val_if_fail(thunk, NULL);
 
     priv = GET_PRIVATE(acc);
+    if (!priv->children)
+        return NULL;
+
+    if (auto tree = account_tree_get (acc, false))
+    {
+        auto hold = tree->shared_from_this();
+        for (auto pos = priv->tree_pos + 1, end = priv->tree_end; pos < end; ++pos)
+            if ((result = thunk (hold->accounts[pos], user_data)))
+                return result;
+        return NULL;
+    }
+
     for (node = priv->children; node; node = node->next)
     {
         child = static_cast<Account*>(node->data);
@@ -3195,7 +3880,7 @@ gnc_account_set_start_balance (Account *acc, const gnc_numeric start_baln)
 
     priv = GET_PRIVATE(acc);
     priv->starting_balance = start_baln;
-    priv->balance_dirty = TRUE;
+    account_balance_dirty_from (priv, 0);
 }
 
 void
@@ -3208,7 +3893,7 @@ gnc_account_set_start_cleared_balance (Account *acc,
 
     priv = GET_PRIVATE(acc);
     priv->starting_cleared_balance = start_baln;
-    priv->balance_dirty = TRUE;
+    account_balance_dirty_from (priv, 0);
 }
 
 void
@@ -3221,7 +3906,7 @@ gnc_account_set_start_reconciled_balance (Account *acc,
 
     priv = GET_PRIVATE(acc);
     priv->starting_reconciled_balance = start_baln;
-    priv->balance_dirty = TRUE;
+    account_balance_dirty_from (priv, 0);
 }
 
 gnc_numeric
@@ -3245,36 +3930,78 @@ xaccAccountGetReconciledBalance (const Account *acc)
     return GET_PRIVATE(acc)->reconciled_balance;
 }
 
+/* Return the first split in the account, from start on, posted after
+ * date, or at or after it if include_date is false.  The splits are
+ * sorted by posted date first, and splits without a transaction sort
+ * last, so this is a binary search. */
+static SplitsVec::const_iterator
+account_first_split_after (const AccountPrivate *priv,
+                           SplitsVec::const_iterator start, time64 date,
+                           bool include_date)
+{
+    return std::partition_point (start, priv->splits.cend(),
+                                 [date, include_date](const Split *s)
+                                 {
+                                     auto trans = xaccSplitGetParent (s);
+                                     if (!trans)
+                                         return false;
+                                     auto posted = xaccTransGetDate (trans);
+                                     return include_date ? posted <= date :
+                                         posted < date;
+                                 });
+}
+
+/* The one place that works out a balance at a point in time.  Each
+ * split carries the running balances up to and including itself, so
+ * the balance at date is that of the last split posted before it.
+ *
+ * The split list is sorted and the running balances brought up to date
+ * first; like xaccAccountGetSplitList this casts away the const. */
+static gnc_numeric
+account_balance_at (const Account *acc, time64 date, bool include_date,
+                    gnc_numeric (*split_balance) (const Split*),
+                    gnc_numeric AccountPrivate::*start_balance)
+{
+    auto priv = GET_PRIVATE(acc);
+
+    xaccAccountSortSplits (const_cast<Account*>(acc), TRUE);
+    xaccAccountRecomputeBalance (const_cast<Account*>(acc));
+
+    auto after = account_first_split_after (priv, priv->splits.cbegin(), date,
+                                            include_date);
+    if (after == priv->splits.begin())
+        return priv->*start_balance;
+    return split_balance (*(after - 1));
+}
+
 gnc_numeric
 xaccAccountGetProjectedMinimumBalance (const Account *acc)
 {
     AccountPrivate *priv;
-    GList *node;
     time64 today;
-    gnc_numeric lowest = gnc_numeric_zero ();
-    int seen_a_transaction = 0;
+    gnc_numeric lowest;
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
 
     priv = GET_PRIVATE(acc);
     today = gnc_time64_get_today_end();
-    for (node = g_list_last(priv->splits); node; node = node->prev)
-    {
-        Split *split = static_cast<Split*>(node->data);
 
-        if (!seen_a_transaction)
-        {
-            lowest = xaccSplitGetBalance (split);
-            seen_a_transaction = 1;
-        }
-        else if (gnc_numeric_compare(xaccSplitGetBalance (split), lowest) < 0)
-        {
-            lowest = xaccSplitGetBalance (split);
-        }
-
-        if (xaccTransGetDate (xaccSplitGetParent (split)) <= today)
-            return lowest;
+    /* The lowest of the present balance and every future one.  Getting
+     * the present balance also sorts the splits and brings their
+     * running balances up to date. */
+    lowest = account_balance_at (acc, today, true, xaccSplitGetBalance,
+                                 &AccountPrivate::starting_balance);
+    auto it = account_first_split_after (priv, priv->splits.cbegin(), today,
+                                         true);
+    if (it == priv->splits.begin())
+    {
+        if (it == priv->splits.end())
+            return gnc_numeric_zero ();
+        lowest = xaccSplitGetBalance (*it);
     }
+    for (; it != priv->splits.end(); ++it)
+        if (gnc_numeric_compare(xaccSplitGetBalance (*it), lowest) < 0)
+            lowest = xaccSplitGetBalance (*it);
 
     return lowest;
 }
@@ -3286,99 +4013,45 @@ xaccAccountGetProjectedMinimumBalance (const Account *acc)
 gnc_numeric
 xaccAccountGetBalanceAsOfDate (Account *acc, time64 date)
 {
-    /* Ideally this could use xaccAccountForEachSplit, but
-     * it doesn't exist yet and I'm uncertain of exactly how
-     * it would work at this time, since it differs from
-     * xaccAccountForEachTransaction by using gpointer return
-     * values rather than gints.
-     */
-    AccountPrivate *priv;
-    GList   *lp;
-    gboolean found = FALSE;
-    gnc_numeric balance;
-
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
 
-    xaccAccountSortSplits (acc, TRUE); /* just in case, normally a noop */
-    xaccAccountRecomputeBalance (acc); /* just in case, normally a noop */
-
-    priv = GET_PRIVATE(acc);
-    balance = priv->balance;
-
-    /* Since transaction post times are stored as a Timespec,
-     * convert date into a Timespec as well rather than converting
-     * each transaction's Timespec into a time64.
-     *
-     * FIXME: CAS: I think this comment is a bogus justification for
-     * using xaccTransGetDatePostedTS.  There's no benefit to using
-     * Timespec when the input argument is time64, and it's hard to
-     * imagine that casting long long to long and comparing two longs is
-     * worse than comparing two long longs every time.  IMO,
-     * xaccAccountGetPresentBalance gets this right, and its algorithm
-     * should be used here.
-     */
+    return account_balance_at (acc, date, false, xaccSplitGetBalance,
+                               &AccountPrivate::starting_balance);
+}
 
-    lp = priv->splits;
-    while ( lp && !found )
-    {
-        time64 trans_time = xaccTransRetDatePosted( xaccSplitGetParent( (Split *)lp->data ));
-        if ( trans_time >= date )
-            found = TRUE;
-        else
-            lp = lp->next;
-    }
+gnc_numeric
+xaccAccountGetClearedBalanceAsOfDate (Account *acc, time64 date)
+{
+    g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
 
-    if ( lp )
-    {
-        if ( lp->prev )
-        {
-            /* Since lp is now pointing to a split which was past the reconcile
-             * date, get the running balance of the previous split.
-             */
-            balance = xaccSplitGetBalance( (Split *)lp->prev->data );
-        }
-        else
-        {
-            /* AsOf date must be before any entries, return zero. */
-            balance = gnc_numeric_zero();
-        }
-    }
+    return account_balance_at (acc, date, false, xaccSplitGetClearedBalance,
+                               &AccountPrivate::starting_cleared_balance);
+}
 
-    /* Otherwise there were no splits posted after the given date,
-     * so the latest account balance should be good enough.
-     */
+gnc_numeric
+xaccAccountGetReconciledBalanceAsOfDate (Account *acc, time64 date)
+{
+    g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
 
-    return( balance );
+    return account_balance_at (acc, date, false,
+                               xaccSplitGetReconciledBalance,
+                               &AccountPrivate::starting_reconciled_balance);
 }
 
 /*
  * Originally gsr_account_present_balance in gnc-split-reg.c
  *
- * How does this routine compare to xaccAccountGetBalanceAsOfDate just
- * above?  These two routines should eventually be collapsed into one.
- * Perhaps the startup logic from that one, and the logic from this
- * one that walks from the tail of the split list.
+ * Unlike xaccAccountGetBalanceAsOfDate this includes the splits posted
+ * on the given time, the end of today.
  */
 gnc_numeric
 xaccAccountGetPresentBalance (const Account *acc)
 {
-    AccountPrivate *priv;
-    GList *node;
-    time64 today;
-
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
 
-    priv = GET_PRIVATE(acc);
-    today = gnc_time64_get_today_end();
-    for (node = g_list_last(priv->splits); node; node = node->prev)
-    {
-        Split *split = static_cast<Split*>(node->data);
-
-        if (xaccTransGetDate (xaccSplitGetParent (split)) <= today)
-            return xaccSplitGetBalance (split);
-    }
-
-    return gnc_numeric_zero ();
+    return account_balance_at (acc, gnc_time64_get_today_end(), true,
+                               xaccSplitGetBalance,
+                               &AccountPrivate::starting_balance);
 }
 
 
@@ -3441,6 +4114,51 @@ xaccAccountConvertBalanceToCurrencyAsOfDate(const Account *acc, /* for book */
     return balance;
 }
 
+/*
+ * The conversion rates looked up while working out one total over an
+ * account tree, keyed by commodity, currency and date.  Most of the
+ * accounts in a tree share a few commodities, so this saves going to
+ * the price database for every account.  INT64_MAX stands for the
+ * latest price, as it does in the price database.
+ */
+typedef std::map<std::tuple<const gnc_commodity*, const gnc_commodity*,
+                            time64>, gnc_numeric> ConversionRates;
+
+/*
+ * Convert a balance as xaccAccountConvertBalanceToCurrency (or, given a
+ * date, xaccAccountConvertBalanceToCurrencyAsOfDate) does, looking the
+ * rate up in rates first.
+ */
+static gnc_numeric
+xaccAccountConvertBalanceWithRates (const Account *acc, ConversionRates *rates,
+                                    gnc_numeric balance,
+                                    const gnc_commodity *balance_currency,
+                                    const gnc_commodity *new_currency,
+                                    time64 date)
+{
+    if (gnc_numeric_zero_p (balance) ||
+            gnc_commodity_equiv (balance_currency, new_currency))
+        return balance;
+
+    auto key = std::make_tuple (balance_currency, new_currency, date);
+    auto rate = rates->find (key);
+    if (rate == rates->end())
+    {
+        auto pdb = gnc_pricedb_get_db (gnc_account_get_book (acc));
+        auto price = date == INT64_MAX ?
+            gnc_pricedb_get_latest_price (pdb, balance_currency, new_currency) :
+            gnc_pricedb_get_nearest_price (pdb, balance_currency, new_currency,
+                                           date);
+        rate = rates->emplace (key, price).first;
+    }
+    if (gnc_numeric_check (rate->second))
+        return gnc_numeric_zero ();
+
+    return gnc_numeric_mul (balance, rate->second,
+                            gnc_commodity_get_fraction (new_currency),
+                            GNC_HOW_RND_ROUND);
+}
+
 /*
  * Given an account and a GetBalanceFn pointer, extract the requested
  * balance from the account and then convert it to the desired
@@ -3449,7 +4167,8 @@ xaccAccountConvertBalanceToCurrencyAsOfDate(const Account *acc, /* for book */
 static gnc_numeric
 xaccAccountGetXxxBalanceInCurrency (const Account *acc,
                                     xaccGetBalanceFn fn,
-                                    const gnc_commodity *report_currency)
+                                    const gnc_commodity *report_currency,
+                                    ConversionRates *rates)
 {
     AccountPrivate *priv;
     gnc_numeric balance;
@@ -3460,16 +4179,17 @@ xaccAccountGetXxxBalanceInCurrency (const Account *acc,
 
     priv = GET_PRIVATE(acc);
     balance = fn(acc);
-    balance = xaccAccountConvertBalanceToCurrency(acc, balance,
+    balance = xaccAccountConvertBalanceWithRates(acc, rates, balance,
               priv->commodity,
-              report_currency);
+              report_currency, INT64_MAX);
     return balance;
 }
 
 static gnc_numeric
 xaccAccountGetXxxBalanceAsOfDateInCurrency(Account *acc, time64 date,
         xaccGetBalanceAsOfDateFn fn,
-        const gnc_commodity *report_commodity)
+        const gnc_commodity *report_commodity,
+        ConversionRates *rates)
 {
     AccountPrivate *priv;
 
@@ -3478,8 +4198,9 @@ xaccAccountGetXxxBalanceAsOfDateInCurrency(Account *acc, time64 date,
     g_return_val_if_fail(GNC_IS_COMMODITY(report_commodity), gnc_numeric_zero());
 
     priv = GET_PRIVATE(acc);
-    return xaccAccountConvertBalanceToCurrency(
-               acc, fn(acc, date), priv->commodity, report_commodity);
+    return xaccAccountConvertBalanceWithRates(
+               acc, rates, fn(acc, date), priv->commodity, report_commodity,
+               INT64_MAX);
 }
 
 /*
@@ -3492,6 +4213,7 @@ typedef struct
     xaccGetBalanceFn fn;
     xaccGetBalanceAsOfDateFn asOfDateFn;
     time64 date;
+    ConversionRates *rates;
 } CurrencyBalance;
 
 
@@ -3508,7 +4230,8 @@ xaccAccountBalanceHelper (Account *acc, gpointer data)
 
     if (!cb->fn || !cb->currency)
         return;
-    balance = xaccAccountGetXxxBalanceInCurrency (acc, cb->fn, cb->currency);
+    balance = xaccAccountGetXxxBalanceInCurrency (acc, cb->fn, cb->currency,
+                                                  cb->rates);
     cb->balance = gnc_numeric_add (cb->balance, balance,
                                    gnc_commodity_get_fraction (cb->currency),
                                    GNC_HOW_RND_ROUND_HALF_UP);
@@ -3523,7 +4246,7 @@ xaccAccountBalanceAsOfDateHelper (Account *acc, gpointer data)
     g_return_if_fail (cb->asOfDateFn && cb->currency);
 
     balance = xaccAccountGetXxxBalanceAsOfDateInCurrency (
-                  acc, cb->date, cb->asOfDateFn, cb->currency);
+                  acc, cb->date, cb->asOfDateFn, cb->currency, cb->rates);
     cb->balance = gnc_numeric_add (cb->balance, balance,
                                    gnc_commodity_get_fraction (cb->currency),
                                    GNC_HOW_RND_ROUND_HALF_UP);
@@ -3538,6 +4261,9 @@ xaccAccountBalanceAsOfDateHelper (Account *acc, gpointer data)
  * 'fn' for extracting the balance.  This function may extract the
  * current value, the reconciled value, etc.
  *
+ * The conversion rates are looked up once for each commodity in the
+ * tree rather than once for each account.
+ *
  * If 'report_commodity' is NULL, just use the account's commodity.
  * If 'include_children' is FALSE, this function doesn't recurse at all.
  */
@@ -3548,6 +4274,7 @@ xaccAccountGetXxxBalanceInCurrencyRecursive (const Account *acc,
         gboolean include_children)
 {
     gnc_numeric balance;
+    ConversionRates rates;
 
     if (!acc) return gnc_numeric_zero ();
     if (!report_commodity)
@@ -3555,7 +4282,8 @@ xaccAccountGetXxxBalanceInCurrencyRecursive (const Account *acc,
     if (!report_commodity)
         return gnc_numeric_zero();
 
-    balance = xaccAccountGetXxxBalanceInCurrency (acc, fn, report_commodity);
+    balance = xaccAccountGetXxxBalanceInCurrency (acc, fn, report_commodity,
+                                                  &rates);
 
     /* If needed, sum up the children converting to the *requested*
        commodity. */
@@ -3565,10 +4293,10 @@ xaccAccountGetXxxBalanceInCurrencyRecursive (const Account *acc,
         /* MSVC compiler: Somehow, the struct initialization containing a
            gnc_numeric doesn't work. As an exception, we hand-initialize
            that member afterwards. */
-        CurrencyBalance cb = { report_commodity, { 0 }, fn, NULL, 0 };
+        CurrencyBalance cb = { report_commodity, { 0 }, fn, NULL, 0, &rates };
         cb.balance = balance;
 #else
-        CurrencyBalance cb = { report_commodity, balance, fn, NULL, 0 };
+        CurrencyBalance cb = { report_commodity, balance, fn, NULL, 0, &rates };
 #endif
 
         gnc_account_foreach_descendant (acc, xaccAccountBalanceHelper, &cb);
@@ -3584,6 +4312,7 @@ xaccAccountGetXxxBalanceAsOfDateInCurrencyRecursive (
     gnc_commodity *report_commodity, gboolean include_children)
 {
     gnc_numeric balance;
+    ConversionRates rates;
 
     g_return_val_if_fail(acc, gnc_numeric_zero());
     if (!report_commodity)
@@ -3592,7 +4321,7 @@ xaccAccountGetXxxBalanceAsOfDateInCurrencyRecursive (
         return gnc_numeric_zero();
 
     balance = xaccAccountGetXxxBalanceAsOfDateInCurrency(
-                  acc, date, fn, report_commodity);
+                  acc, date, fn, report_commodity, &rates);
 
     /* If needed, sum up the children converting to the *requested*
        commodity. */
@@ -3602,10 +4331,11 @@ xaccAccountGetXxxBalanceAsOfDateInCurrencyRecursive (
         /* MSVC compiler: Somehow, the struct initialization containing a
            gnc_numeric doesn't work. As an exception, we hand-initialize
            that member afterwards. */
-        CurrencyBalance cb = { report_commodity, 0, NULL, fn, date };
+        CurrencyBalance cb = { report_commodity, 0, NULL, fn, date, &rates };
         cb.balance = balance;
 #else
-        CurrencyBalance cb = { report_commodity, balance, NULL, fn, date };
+        CurrencyBalance cb = { report_commodity, balance, NULL, fn, date,
+                               &rates };
 #endif
 
         gnc_account_foreach_descendant (acc, xaccAccountBalanceAsOfDateHelper, &cb);
@@ -3679,15 +4409,144 @@ xaccAccountGetBalanceAsOfDateInCurrency(
                include_children);
 }
 
+/*
+ * Data structure used to pass the arguments of
+ * xaccAccountGetBalancesAsOfDates to the per-account helper.
+ */
+struct BalancesAsOfDates
+{
+    const gnc_commodity *currency;
+    const time64 *dates;
+    gsize n_dates;
+    gnc_numeric *balances;
+    std::vector<gnc_numeric> scratch;
+    ConversionRates rates;
+};
+
+/* Work out the balance of acc, in its own commodity, as of each of the
+ * dates.  The dates are normally in order, so each search carries on
+ * from where the last one stopped and the whole thing is one pass over
+ * the splits. */
+static void
+account_balances_as_of_dates (Account *acc, const time64 *dates,
+                              gsize n_dates, gnc_numeric *balances)
+{
+    auto priv = GET_PRIVATE(acc);
+
+    xaccAccountSortSplits (acc, TRUE);
+    xaccAccountRecomputeBalance (acc);
+
+    auto it = priv->splits.cbegin();
+    for (gsize i = 0; i < n_dates; ++i)
+    {
+        if (i > 0 && dates[i] < dates[i - 1])
+            it = priv->splits.cbegin();
+        it = account_first_split_after (priv, it, dates[i], false);
+        balances[i] = it == priv->splits.cbegin() ? priv->starting_balance :
+            xaccSplitGetBalance (*(it - 1));
+    }
+}
+
+/* Add the balances of one descendant, converted to the report currency
+ * once for each date, into the sums. */
+static void
+xaccAccountBalancesAsOfDatesHelper (Account *acc, gpointer data)
+{
+    auto bd = static_cast<BalancesAsOfDates*>(data);
+    auto commodity = xaccAccountGetCommodity (acc);
+    auto fraction = gnc_commodity_get_fraction (bd->currency);
+
+    account_balances_as_of_dates (acc, bd->dates, bd->n_dates,
+                                  bd->scratch.data());
+    for (gsize i = 0; i < bd->n_dates; ++i)
+    {
+        auto balance = xaccAccountConvertBalanceWithRates (acc, &bd->rates,
+                                                           bd->scratch[i],
+                                                           commodity,
+                                                           bd->currency,
+                                                           INT64_MAX);
+        bd->balances[i] = gnc_numeric_add (bd->balances[i], balance, fraction,
+                                           GNC_HOW_RND_ROUND_HALF_UP);
+    }
+}
+
+GArray *
+xaccAccountGetBalancesAsOfDates (Account *acc, const time64 *dates,
+                                 gsize n_dates,
+                                 gnc_commodity *report_commodity,
+                                 gboolean include_children)
+{
+    GArray *result;
+
+    g_return_val_if_fail(GNC_IS_ACCOUNT(acc), NULL);
+    g_return_val_if_fail(dates || n_dates == 0, NULL);
+
+    result = g_array_sized_new (FALSE, FALSE, sizeof (gnc_numeric), n_dates);
+    g_array_set_size (result, n_dates);
+    auto balances = reinterpret_cast<gnc_numeric*>(result->data);
+    std::fill (balances, balances + n_dates, gnc_numeric_zero ());
+
+    if (!report_commodity)
+        report_commodity = xaccAccountGetCommodity (acc);
+    if (!report_commodity)
+        return result;
+
+    BalancesAsOfDates bd { report_commodity, dates, n_dates, balances,
+                           std::vector<gnc_numeric> (n_dates),
+                           ConversionRates () };
+    account_balances_as_of_dates (acc, dates, n_dates, balances);
+    for (gsize i = 0; i < n_dates; ++i)
+        balances[i] = xaccAccountConvertBalanceWithRates (
+                          acc, &bd.rates, balances[i],
+                          xaccAccountGetCommodity (acc), report_commodity,
+                          INT64_MAX);
+
+    if (include_children)
+        gnc_account_foreach_descendant (acc,
+                                        xaccAccountBalancesAsOfDatesHelper,
+                                        &bd);
+    return result;
+}
+
+GArray *
+xaccAccountGetBalanceChangesForPeriods (Account *acc, const time64 *dates,
+                                        gsize n_dates, gboolean recurse)
+{
+    GArray *balances, *result;
+
+    balances = xaccAccountGetBalancesAsOfDates (acc, dates, n_dates, NULL,
+                                                recurse);
+    if (!balances)
+        return NULL;
+
+    result = g_array_sized_new (FALSE, FALSE, sizeof (gnc_numeric),
+                                n_dates ? n_dates - 1 : 0);
+    for (gsize i = 1; i < n_dates; ++i)
+    {
+        auto change = gnc_numeric_sub (g_array_index (balances, gnc_numeric, i),
+                                       g_array_index (balances, gnc_numeric,
+                                                      i - 1),
+                                       GNC_DENOM_AUTO, GNC_HOW_DENOM_FIXED);
+        g_array_append_val (result, change);
+    }
+    g_array_free (balances, TRUE);
+    return result;
+}
+
 gnc_numeric
 xaccAccountGetBalanceChangeForPeriod (Account *acc, time64 t1, time64 t2,
                                       gboolean recurse)
 {
-    gnc_numeric b1, b2;
+    time64 dates[] = { t1, t2 };
+    GArray *changes;
+    gnc_numeric change;
 
-    b1 = xaccAccountGetBalanceAsOfDateInCurrency(acc, t1, NULL, recurse);
-    b2 = xaccAccountGetBalanceAsOfDateInCurrency(acc, t2, NULL, recurse);
-    return gnc_numeric_sub(b2, b1, GNC_DENOM_AUTO, GNC_HOW_DENOM_FIXED);
+    changes = xaccAccountGetBalanceChangesForPeriods (acc, dates, 2, recurse);
+    if (!changes)
+        return gnc_numeric_zero ();
+    change = g_array_index (changes, gnc_numeric, 0);
+    g_array_free (changes, TRUE);
+    return change;
 }
 
 
@@ -3696,21 +4555,34 @@ xaccAccountGetBalanceChangeForPeriod (Account *acc, time64 t1, time64 t2,
 
 /* THIS API NEEDS TO CHANGE.
  *
- * This code exposes the internal structure of the account object to
- * external callers by returning the actual list used by the object.
- * It should instead return a copy of the split list that the caller
- * is required to free.  That change would provide the freedom of
- * allowing the internal organization to change data structures if
- * necessary for whatever reason, while leaving the external API
- * unchanged. */
+ * The splits are stored in a vector; the GList returned here is a view
+ * of it that is built the first time it is asked for and then kept in
+ * step with the vector by the insert, remove and sort functions above,
+ * so callers still see the list change underneath them just as they
+ * did when the GList was the real storage.  It should instead return a
+ * copy of the split list that the caller is required to free. */
 /* XXX: violates the const'ness by forcing a sort before returning
  * the splitlist */
 SplitList *
 xaccAccountGetSplitList (const Account *acc)
 {
+    AccountPrivate *priv;
+
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), NULL);
     xaccAccountSortSplits((Account*)acc, FALSE);  // normally a noop
-    return GET_PRIVATE(acc)->splits;
+
+    priv = GET_PRIVATE(acc);
+    if (!priv->split_list && !priv->splits.empty())
+    {
+        priv->split_nodes.resize (priv->splits.size());
+        for (auto i = priv->splits.size(); i-- > 0;)
+        {
+            priv->split_list = g_list_prepend (priv->split_list,
+                                               priv->splits[i]);
+            priv->split_nodes[i] = priv->split_list;
+        }
+    }
+    return priv->split_list;
 }
 
 gint64
@@ -3721,7 +4593,7 @@ xaccAccountCountSplits (const Account *acc, gboolean include_children)
     nr = 0;
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), 0);
 
-    nr = g_list_length(xaccAccountGetSplitList(acc));
+    nr = GET_PRIVATE(acc)->splits.size();
     if (include_children && (gnc_account_n_children(acc) != 0))
     {
         for (i=0; i < gnc_account_n_children(acc); i++)
@@ -4731,7 +5603,6 @@ finder_help_function(const Account *acc, const char *description,
                      Split **split, Transaction **trans )
 {
     AccountPrivate *priv;
-    GList *slp;
 
     /* First, make sure we set the data to NULL BEFORE we start */
     if (split) *split = NULL;
@@ -4744,9 +5615,9 @@ finder_help_function(const Account *acc, const char *description,
      * list is in date order, and the most recent matches should be
      * returned!?  */
     priv = GET_PRIVATE(acc);
-    for (slp = g_list_last(priv->splits); slp; slp = slp->prev)
+    for (auto slp = priv->splits.rbegin(); slp != priv->splits.rend(); ++slp)
     {
-        Split *lsplit = static_cast<Split*>(slp->data);
+        Split *lsplit = *slp;
         Transaction *ltrans = xaccSplitGetParent(lsplit);
 
         if (g_strcmp0 (description, xaccTransGetDescription (ltrans)) == 0)
@@ -4863,8 +5734,8 @@ gnc_account_merge_children (Account *parent)
             gnc_account_merge_children (acc_a);
 
             /* consolidate transactions */
-            while (priv_b->splits)
-                xaccSplitSetAccount (static_cast <Split*> (priv_b->splits->data), acc_a);
+            while (!priv_b->splits.empty())
+                xaccSplitSetAccount (priv_b->splits.front(), acc_a);
 
             /* move back one before removal. next iteration around the loop
              * will get the node after node_b */
@@ -4906,7 +5777,13 @@ xaccAccountBeginStagedTransactionTraversals (const Account *account)
     if (!account)
         return;
     priv = GET_PRIVATE(account);
-    xaccSplitsBeginStagedTransactionTraversals(priv->splits);
+    for (auto s : priv->splits)
+    {
+        Transaction *trans = s->parent;
+
+        if (trans)
+            trans->marker = 0;
+    }
 }
 
 gboolean
@@ -4923,16 +5800,11 @@ xaccTransactionTraverse (Transaction *trans, int stage)
     return FALSE;
 }
 
-static void do_one_split (Split *s, gpointer data)
-{
-    Transaction *trans = s->parent;
-    trans->marker = 0;
-}
-
 static void do_one_account (Account *account, gpointer data)
 {
     AccountPrivate *priv = GET_PRIVATE(account);
-    g_list_foreach(priv->splits, (GFunc)do_one_split, NULL);
+    for (auto s : priv->splits)
+        s->parent->marker = 0;
 }
 
 /* Replacement for xaccGroupBeginStagedTransactionTraversals */
@@ -4953,24 +5825,17 @@ xaccAccountStagedTransactionTraversal (const Account *acc,
                                        void *cb_data)
 {
     AccountPrivate *priv;
-    GList *split_p;
-    GList *next;
     Transaction *trans;
-    Split *s;
     int retval;
 
     if (!acc) return 0;
 
     priv = GET_PRIVATE(acc);
-    for (split_p = priv->splits; split_p; split_p = next)
+    /* Walk a copy of the split array, just in case some naughty thunk
+     * adds or removes splits in this account. */
+    auto splits = priv->splits;
+    for (auto s : splits)
     {
-        /* Get the next element in the split list now, just in case some
-         * naughty thunk destroys the one we're using. This reduces, but
-         * does not eliminate, the possibility of undefined results if
-         * a thunk removes splits from this account. */
-        next = g_list_next(split_p);
-
-        s = static_cast <Split*> (split_p->data);
         trans = s->parent;
         if (trans && (trans->marker < stage))
         {
@@ -4993,9 +5858,8 @@ gnc_account_tree_staged_transaction_traversal (const Account *acc,
         void *cb_data)
 {
     const AccountPrivate *priv;
-    GList *acc_p, *split_p;
+    GList *acc_p;
     Transaction *trans;
-    Split *s;
     int retval;
 
     if (!acc) return 0;
@@ -5010,9 +5874,9 @@ gnc_account_tree_staged_transaction_traversal (const Account *acc,
     }
 
     /* Now this account */
-    for (split_p = priv->splits; split_p; split_p = g_list_next(split_p))
+    auto splits = priv->splits;
+    for (auto s : splits)
     {
-        s = static_cast <Split*> (split_p->data);
         trans = s->parent;
         if (trans && (trans->marker < stage))
         {
@@ -5052,6 +5916,24 @@ xaccAccountForEachTransaction(const Account *acc, TransactionCallback proc,
     return xaccAccountStagedTransactionTraversal(acc, 42, proc, data);
 }
 
+void
+gnc_account_foreach_split_in_range (const Account *acc, time64 start,
+                                    time64 end, QofInstanceForeachCB thunk,
+                                    gpointer user_data)
+{
+    g_return_if_fail(GNC_IS_ACCOUNT(acc));
+    g_return_if_fail(thunk);
+
+    auto priv = GET_PRIVATE(acc);
+    xaccAccountSortSplits (const_cast<Account*>(acc), TRUE);
+
+    auto first = account_first_split_after (priv, priv->splits.cbegin(), start,
+                                            false);
+    auto last = account_first_split_after (priv, first, end, true);
+    for (; first != last; ++first)
+        thunk (QOF_INSTANCE(*first), user_data);
+}
+
 /* ================================================================ */
 /* The following functions are used by
  * src/import-export/import-backend.c to manipulate the contra-account
@@ -5732,6 +6614,12 @@ static QofObject account_object_def =
 
 gboolean xaccAccountRegister (void)
 {
+    /* The balance getters sort the splits and recompute the balances,
+     * so only these may be used from several threads. */
+    static const char *thread_safe[] =
+    {
+        ACCOUNT_NAME_, ACCOUNT_CODE_, QOF_PARAM_GUID, NULL
+    };
     static QofParam params[] =
     {
         {
@@ -5831,6 +6719,7 @@ gboolean xaccAccountRegister (void)
     };
 
     qof_class_register (GNC_ID_ACCOUNT, (QofSortFunc) qof_xaccAccountOrder, params);
+    qof_query_register_thread_safe (GNC_ID_ACCOUNT, thread_safe);
 
     return qof_object_register (&account_object_def);
 }
@@ -369,7 +369,9 @@ void gnc_account_set_sort_dirty (Account *acc);
  *
  *  @result TRUE is the split is successfully added to the set of
  *  splits in the account.  FALSE if the addition fails for any reason
- *  (including that the split is already in the account). */
+ *  (including that the split is already in the account).  While the
+ *  account is open for editing the split is only appended and the
+ *  duplicate check is left to xaccAccountSortSplits(). */
 gboolean gnc_account_insert_split (Account *acc, Split *s);
 
 /** Remove the given split from an account.
@@ -554,9 +556,18 @@ gnc_numeric xaccAccountGetClearedBalance (const Account *account);
 gnc_numeric xaccAccountGetReconciledBalance (const Account *account);
 gnc_numeric xaccAccountGetPresentBalance (const Account *account);
 gnc_numeric xaccAccountGetProjectedMinimumBalance (const Account *account);
-/** Get the balance of the account as of the date specified */
+/** Get the balance of the account as of the date specified, that is
+    including only the splits posted before it */
 gnc_numeric xaccAccountGetBalanceAsOfDate (Account *account,
         time64 date);
+/** Get the balance of the account as of the date specified, only
+    including cleared transactions */
+gnc_numeric xaccAccountGetClearedBalanceAsOfDate (Account *account,
+        time64 date);
+/** Get the balance of the account as of the date specified, only
+    including reconciled transactions */
+gnc_numeric xaccAccountGetReconciledBalanceAsOfDate (Account *account,
+        time64 date);
 
 /* These two functions convert a given balance from one commodity to
    another.  The account argument is only used to get the Book, and
@@ -604,6 +615,28 @@ gnc_numeric xaccAccountGetBalanceAsOfDateInCurrency(
 gnc_numeric xaccAccountGetBalanceChangeForPeriod (
     Account *acc, time64 date1, time64 date2, gboolean recurse);
 
+/** Get the balance of the account as of each of a number of dates, as
+ *  xaccAccountGetBalanceAsOfDateInCurrency would, but with a single
+ *  pass over the splits of each account.  Each account's balance is
+ *  converted to the report commodity once per date.
+ *
+ *  @param dates The dates, which should be in ascending order.
+ *
+ *  @return A GArray of n_dates gnc_numerics, to be freed with
+ *  g_array_free (array, TRUE). */
+GArray *xaccAccountGetBalancesAsOfDates (
+    Account *acc, const time64 *dates, gsize n_dates,
+    gnc_commodity *report_commodity, gboolean include_children);
+
+/** Get the change in the balance of the account over each of the
+ *  periods between consecutive dates, as
+ *  xaccAccountGetBalanceChangeForPeriod would.
+ *
+ *  @return A GArray of n_dates - 1 gnc_numerics, to be freed with
+ *  g_array_free (array, TRUE). */
+GArray *xaccAccountGetBalanceChangesForPeriods (
+    Account *acc, const time64 *dates, gsize n_dates, gboolean recurse);
+
 /** @} */
 
 /** @name Account Children and Parents.
@@ -817,7 +850,8 @@ void gnc_account_foreach_child (const Account *account,
  *  descendants, calling 'func' on each account.  This function
  *  traverses all descendant nodes.  To traverse only a subset of the
  *  descendant nodes use the gnc_account_foreach_descendant_until()
- *  function.
+ *  function.  The accounts visited are the descendants at the time
+ *  of the call, even if 'func' moves accounts around.
  *
  *  @param account A pointer to the account on whose descendants the
  *  function should be called.
@@ -991,11 +1025,11 @@ gboolean xaccAccountIsEquityType(GNCAccountType t);
 
 /** The xaccAccountGetSplitList() routine returns a pointer to a GList of
  *    the splits in the account.
- * @note This GList is the account's internal
- *    data structure: do not delete it when done; treat it as a read-only
- *    structure.  Note that some routines (such as xaccAccountRemoveSplit())
- *    modify this list directly, and could leave you with a corrupted
- *    pointer.
+ * @note This GList is owned by the account, which keeps it in step
+ *    with its internal split array: do not delete it when done; treat
+ *    it as a read-only structure.  Note that some routines (such as
+ *    xaccAccountRemoveSplit()) modify this list directly, and could
+ *    leave you with a corrupted pointer.
  * @note This should be changed so that the returned value is a copy
  * of the list. No other part of the code should have access to the
  * internal data structure used by this object.
@@ -1048,6 +1082,18 @@ gint xaccAccountForEachTransaction(const Account *account,
                                    TransactionCallback proc,
                                    void *data);
 
+/** Call @a thunk on each split in @a acc posted between @a start and
+ * @a end inclusive, in order.  The splits are kept sorted by posted
+ * date, so the splits outside the range aren't looked at.
+ *
+ * \warning @a thunk must not add splits to or remove them from the
+ * account.
+ */
+void gnc_account_foreach_split_in_range (const Account *acc, time64 start,
+                                         time64 end,
+                                         QofInstanceForeachCB thunk,
+                                         gpointer user_data);
+
 /** Returns a pointer to the transaction, not a copy. */
 Transaction * xaccAccountFindTransByDesc(const Account *account,
         const char *description);
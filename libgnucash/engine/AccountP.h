@@ -42,6 +42,15 @@
 #include "Account.h"
 
 #ifdef __cplusplus
+/* This header is often included from within an extern "C" block. */
+extern "C++" {
+#include <unordered_set>
+#include <vector>
+
+typedef std::vector<Split*> SplitsVec;
+struct AccountTree;
+}
+
 extern "C" {
 #endif
 
@@ -55,8 +64,11 @@ extern "C" {
  * No one outside of the engine should ever include this file.
 */
 
+typedef struct AccountPrivate AccountPrivate;
+
+#ifdef __cplusplus
 /** \struct Account */
-typedef struct AccountPrivate
+struct AccountPrivate
 {
     /* The accountName is an arbitrary string assigned by the user.
      * It is intended to a short, 5 to 30 character long string that
@@ -102,6 +114,16 @@ typedef struct AccountPrivate
     Account *parent;    /* back-pointer to parent */
     GList *children;    /* list of sub-accounts */
 
+    /* The account's place in the cached depth-first arrays of its
+     * tree, which only hold while tree_generation is current.  Its
+     * descendants are at tree_pos + 1 up to tree_end, or in sorted
+     * order from tree_sorted_pos + 1 on. */
+    AccountTree *tree;
+    guint64 tree_generation;
+    size_t tree_pos;
+    size_t tree_end;
+    size_t tree_sorted_pos;
+
     /* protected data - should only be set by backends */
     gnc_numeric starting_balance;
     gnc_numeric starting_cleared_balance;
@@ -112,11 +134,27 @@ typedef struct AccountPrivate
     gnc_numeric cleared_balance;
     gnc_numeric reconciled_balance;
 
+    /* Only the running balances of the splits from position
+     * balance_dirty_from on need recomputing. */
     gboolean balance_dirty;     /* balances in splits incorrect */
+    size_t balance_dirty_from;
 
-    GList *splits;              /* list of split pointers */
+    /* The splits are kept in a contiguous array ordered by
+     * xaccSplitOrder() so that they can be binary searched.  The
+     * ordering is only guaranteed while sort_dirty is FALSE. */
+    SplitsVec splits;           /* vector of split pointers */
     gboolean sort_dirty;        /* sort order of splits is bad */
 
+    /* The GList handed out by xaccAccountGetSplitList() is built on
+     * demand and then kept in step with splits: split_nodes[i] is the
+     * node holding splits[i]. */
+    GList *split_list;
+    std::vector<GList*> split_nodes;
+
+    /* Splits given this account inside a transaction edit that hasn't
+     * been committed yet, so that queries can still find them. */
+    std::unordered_set<Split*> pending_splits;
+
     LotList   *lots;		/* list of lot pointers */
     GNCPolicy *policy;		/* Cached pointer to policy method */
 
@@ -124,7 +162,8 @@ typedef struct AccountPrivate
      * in any way desired.  Handy for specialty traversals of the
      * account tree. */
     short mark;
-} AccountPrivate;
+};
+#endif
 
 struct account_s
 {
@@ -136,6 +175,22 @@ struct account_s
  * call this on an existing account! */
 void xaccAccountSetGUID (Account *account, const GncGUID *guid);
 
+/* Tell the account that something which may affect the order or the
+ * running balance of one of its splits has changed.  Only the splits
+ * from that one on then need their balances recomputed. */
+void gnc_account_split_changed (Account *acc, Split *s);
+
+/* Keep track of the splits that have been given acc in a transaction
+ * edit but won't be in its split list until the edit is committed.
+ * Only the split code should call these. */
+void gnc_account_add_pending_split (Account *acc, Split *s);
+void gnc_account_remove_pending_split (Account *acc, Split *s);
+
+/* Call thunk with each of acc's pending splits. */
+void gnc_account_foreach_pending_split (const Account *acc,
+                                        QofInstanceForeachCB thunk,
+                                        gpointer user_data);
+
 /* Register Accounts with the engine */
 gboolean xaccAccountRegister (void);
 
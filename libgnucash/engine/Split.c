@@ -56,6 +56,7 @@
 #include "gnc-lot.h"
 #include "gnc-event.h"
 #include "qofinstance-p.h"
+#include "qofquery-p.h"
 
 const char *void_former_amt_str = "void-former-amount";
 const char *void_former_val_str = "void-former-value";
@@ -704,6 +705,9 @@ xaccFreeSplit (Split *split)
     split->value       = gnc_numeric_zero();
     split->parent      = NULL;
     split->lot         = NULL;
+    if (split->acc && split->acc != split->orig_acc &&
+        !qof_book_shutting_down (qof_instance_get_book (split)))
+        gnc_account_remove_pending_split (split->acc, split);
     split->acc         = NULL;
     split->orig_acc    = NULL;
 
@@ -718,9 +722,11 @@ xaccFreeSplit (Split *split)
 
 void mark_split (Split *s)
 {
-    if (s->acc)
+    /* A split whose account was changed in an open edit isn't in that
+     * account until the edit is committed, so don't go looking. */
+    if (s->acc && s->acc == s->orig_acc)
     {
-        g_object_set(s->acc, "sort-dirty", TRUE, "balance-dirty", TRUE, NULL);
+        gnc_account_split_changed (s->acc, s);
     }
 
     /* set dirty flag on lot too. */
@@ -923,7 +929,12 @@ xaccSplitSetAccount (Split *s, Account *acc)
     if (trans)
         xaccTransBeginEdit(trans);
 
+    /* Until the edit is committed the split is only pending in acc. */
+    if (s->acc && s->acc != s->orig_acc)
+        gnc_account_remove_pending_split (s->acc, s);
     s->acc = acc;
+    if (acc != s->orig_acc)
+        gnc_account_add_pending_split (acc, s);
     qof_instance_set_dirty(QOF_INSTANCE(s));
 
     if (trans)
@@ -967,6 +978,8 @@ xaccSplitCommitEdit(Split *s)
     }
 
     /* ... and insert it into the new account if needed */
+    if (acc && orig_acc != acc)
+        gnc_account_remove_pending_split (acc, s);
     if (acc && (orig_acc != acc) && !qof_instance_get_destroying(s))
     {
         if (gnc_account_insert_split(acc, s))
@@ -1007,7 +1020,7 @@ xaccSplitCommitEdit(Split *s)
 
     if (acc)
     {
-        g_object_set(acc, "sort-dirty", TRUE, "balance-dirty", TRUE, NULL);
+        gnc_account_split_changed (acc, s);
         xaccAccountRecomputeBalance(acc);
     }
 }
@@ -1021,7 +1034,11 @@ xaccSplitRollbackEdit(Split *s)
        only because we don't emit events for changing accounts until
        the final commit. */
     if (s->acc != s->orig_acc)
+    {
+        if (s->acc)
+            gnc_account_remove_pending_split (s->acc, s);
         s->acc = s->orig_acc;
+    }
 
     /* Undestroy if needed */
     if (qof_instance_get_destroying(s) && s->parent)
@@ -2240,8 +2257,176 @@ qofSplitSetAccount(Split *s, QofInstance *ent)
     xaccSplitSetAccount(s, acc);
 }
 
+/* Query index: Split queries nearly always name an account, often with
+ * a range of posted dates.  The account's splits are kept sorted by
+ * posted date, so the candidates are the splits in the range in the
+ * named accounts, and those given the accounts in edits that haven't
+ * been committed yet.  A query that names no account could match
+ * splits that aren't in any, so the index is only used for queries
+ * that do. */
+
+/* Date terms may compare whole days in local time, so widen the
+ * range enough to take in every time on those days. */
+#define SPLIT_QUERY_DATE_SLOP (2 * 86400)
+
+typedef struct
+{
+    GList *guids;       /* the accounts, if the terms name any */
+    gboolean by_account;
+    time64 start;
+    time64 end;
+} SplitQueryRange;
+
+typedef struct
+{
+    time64 start;
+    time64 end;
+    QofInstanceForeachCB cb;
+    gpointer user_data;
+} SplitQueryForeach;
+
+static gboolean
+split_query_path_is (const QofQueryTerm *qt, const char *first,
+                     const char *second)
+{
+    QofQueryParamList *path = qof_query_term_get_param_path (qt);
+
+    if (!path || g_strcmp0 (path->data, first))
+        return FALSE;
+    if (!second)
+        return path->next == NULL;
+    return path->next && !g_strcmp0 (path->next->data, second) &&
+        !path->next->next;
+}
+
+static void
+split_query_range (GList *and_terms, SplitQueryRange *range)
+{
+    GList *node;
+
+    range->guids = NULL;
+    range->by_account = FALSE;
+    range->start = G_MININT64;
+    range->end = G_MAXINT64;
+
+    for (node = and_terms; node; node = node->next)
+    {
+        const QofQueryTerm *qt = node->data;
+        QofQueryPredData *pd = qof_query_term_get_pred_data (qt);
+        QofGuidMatch options;
+        GList *guids;
+        Timespec ts;
+
+        if (qof_query_term_is_inverted (qt))
+            continue;
+
+        if (split_query_path_is (qt, SPLIT_ACCOUNT, QOF_PARAM_GUID) ||
+            split_query_path_is (qt, SPLIT_ACCOUNT_GUID, NULL))
+        {
+            if (!range->by_account &&
+                qof_query_guid_predicate_get_guids (pd, &options, &guids) &&
+                options == QOF_GUID_MATCH_ANY)
+            {
+                range->guids = guids;
+                range->by_account = TRUE;
+            }
+        }
+        else if (split_query_path_is (qt, SPLIT_TRANS, TRANS_DATE_POSTED) &&
+                 qof_query_date_predicate_get_date (pd, &ts))
+        {
+            if ((pd->how == QOF_COMPARE_GT || pd->how == QOF_COMPARE_GTE ||
+                 pd->how == QOF_COMPARE_EQUAL) &&
+                ts.tv_sec > G_MININT64 + SPLIT_QUERY_DATE_SLOP)
+                range->start = MAX (range->start,
+                                    ts.tv_sec - SPLIT_QUERY_DATE_SLOP);
+            if ((pd->how == QOF_COMPARE_LT || pd->how == QOF_COMPARE_LTE ||
+                 pd->how == QOF_COMPARE_EQUAL) &&
+                ts.tv_sec < G_MAXINT64 - SPLIT_QUERY_DATE_SLOP)
+                range->end = MIN (range->end,
+                                  ts.tv_sec + SPLIT_QUERY_DATE_SLOP);
+        }
+    }
+}
+
+static gboolean
+split_query_usable (GList *and_terms, GString *explain)
+{
+    SplitQueryRange range;
+
+    split_query_range (and_terms, &range);
+    if (!range.by_account)
+        return FALSE;
+
+    if (explain)
+    {
+        g_string_append_printf (explain, "splits of %u accounts",
+                                g_list_length (range.guids));
+        if (range.start != G_MININT64 || range.end != G_MAXINT64)
+            g_string_append_printf (explain, " posted from %" G_GINT64_FORMAT
+                                    " to %" G_GINT64_FORMAT, range.start,
+                                    range.end);
+    }
+    return TRUE;
+}
+
+static void
+split_query_account_cb (QofInstance *acc, gpointer data)
+{
+    SplitQueryForeach *fe = data;
+
+    gnc_account_foreach_split_in_range (GNC_ACCOUNT (acc), fe->start,
+                                        fe->end, fe->cb, fe->user_data);
+    gnc_account_foreach_pending_split (GNC_ACCOUNT (acc), fe->cb,
+                                       fe->user_data);
+}
+
+static void
+split_query_foreach (QofBook *book, GList *and_terms,
+                     QofInstanceForeachCB cb, gpointer user_data)
+{
+    SplitQueryRange range;
+    SplitQueryForeach fe;
+    GList *node, *prev;
+
+    split_query_range (and_terms, &range);
+    fe.start = range.start;
+    fe.end = range.end;
+    fe.cb = cb;
+    fe.user_data = user_data;
+
+    for (node = range.guids; node; node = node->next)
+    {
+        Account *acc;
+
+        /* Don't visit an account's splits twice. */
+        for (prev = range.guids; prev != node; prev = prev->next)
+            if (guid_equal (prev->data, node->data))
+                break;
+        if (prev != node)
+            continue;
+
+        acc = xaccAccountLookup (node->data, book);
+        if (acc)
+            split_query_account_cb (QOF_INSTANCE (acc), &fe);
+    }
+}
+
+static const QofQueryIndex split_query_index =
+{
+    split_query_usable,
+    split_query_foreach,
+};
+
 gboolean xaccSplitRegister (void)
 {
+    /* The running balances are left out: they're only right once the
+     * account has recomputed them. */
+    static const char *thread_safe[] =
+        {
+            SPLIT_DATE_RECONCILED, SPLIT_MEMO, SPLIT_ACTION, SPLIT_RECONCILE,
+            SPLIT_AMOUNT, SPLIT_SHARE_PRICE, SPLIT_VALUE, SPLIT_TRANS,
+            SPLIT_ACCOUNT, SPLIT_ACCOUNT_GUID, QOF_PARAM_GUID, NULL
+        };
     static const QofParam params[] =
         {
             {
@@ -2339,6 +2524,8 @@ gboolean xaccSplitRegister (void)
                         NULL);
     qof_class_register (SPLIT_CORR_ACCT_CODE,
                         (QofSortFunc)xaccSplitCompareOtherAccountCodes, NULL);
+    qof_query_register_index (GNC_ID_SPLIT, &split_query_index);
+    qof_query_register_thread_safe (GNC_ID_SPLIT, thread_safe);
 
     return qof_object_register (&split_object_def);
 }
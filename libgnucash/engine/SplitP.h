@@ -68,32 +68,34 @@
 #define GAINS_STATUS_VDIRTY    (GAINS_STATUS_VALU_DIRTY)
 #define GAINS_STATUS_A_VDIRTY  (GAINS_STATUS_AMNT_DIRTY|GAINS_STATUS_VALU_DIRTY|GAINS_STATUS_LOT_DIRTY)
 
+/* The members that the account's sorting and balance loops touch are
+ * kept together at the front, so that walking an account's splits
+ * pulls in as few cache lines per split as possible.  Everything
+ * after gains is cold. */
 struct split_s
 {
     QofInstance inst;
 
     Account *acc;              /* back-pointer to debited/credited account  */
-    Account *orig_acc;
-    GNCLot *lot;               /* back-pointer to debited/credited lot */
-
     Transaction *parent;       /* parent of split                           */
-    Transaction *orig_parent;
 
-    /* The memo field is an arbitrary user-assiged value.
-     * It is intended to hold a short (zero to forty character) string
-     * that is displayed by the GUI along with this split.
-     */
-    char  * memo;
+    /* 'value' is the quantity of the transaction balancing commodity
+     * (i.e. currency) involved, 'amount' is the amount of the account's
+     * commodity involved. */
+    gnc_numeric  value;
+    gnc_numeric  amount;
 
-    /* The action field is an arbitrary user-assigned value.
-     * It is meant to be a very short (one to ten character) string that
-     * signifies the "type" of this split, such as e.g. Buy, Sell, Div,
-     * Withdraw, Deposit, ATM, Check, etc. The idea is that this field
-     * can be used to create custom reports or graphs of data.
-     */
-    char  * action;            /* Buy, Sell, Div, etc.                      */
+    /* -------------------------------------------------------------- */
+    /* Below follow some 'temporary' fields */
+
+    /* The various "balances" are the sum of all of the values of
+     * all the splits in the account, up to and including this split.
+     * These balances apply to a sorting order by date posted
+     * (not by date entered). */
+    gnc_numeric  balance;
+    gnc_numeric  cleared_balance;
+    gnc_numeric  reconciled_balance;
 
-    Timespec date_reconciled;  /* date split was reconciled                 */
     char    reconciled;        /* The reconciled field                      */
 
     /* gains is a flag used to track the relationship between
@@ -103,28 +105,33 @@ struct split_s
      */
     unsigned char  gains;
 
+    GNCLot *lot;               /* back-pointer to debited/credited lot */
+
     /* 'gains_split' is a convenience pointer used to track down the
      * other end of a cap-gains transaction pair.  NULL if this split
      * doesn't involve cap gains.
      */
     Split *gains_split;
 
-    /* 'value' is the quantity of the transaction balancing commodity
-     * (i.e. currency) involved, 'amount' is the amount of the account's
-     * commodity involved. */
-    gnc_numeric  value;
-    gnc_numeric  amount;
+    /* The memo field is an arbitrary user-assiged value.
+     * It is intended to hold a short (zero to forty character) string
+     * that is displayed by the GUI along with this split.
+     */
+    char  * memo;
 
-    /* -------------------------------------------------------------- */
-    /* Below follow some 'temporary' fields */
+    /* The action field is an arbitrary user-assigned value.
+     * It is meant to be a very short (one to ten character) string that
+     * signifies the "type" of this split, such as e.g. Buy, Sell, Div,
+     * Withdraw, Deposit, ATM, Check, etc. The idea is that this field
+     * can be used to create custom reports or graphs of data.
+     */
+    char  * action;            /* Buy, Sell, Div, etc.                      */
 
-    /* The various "balances" are the sum of all of the values of
-     * all the splits in the account, up to and including this split.
-     * These balances apply to a sorting order by date posted
-     * (not by date entered). */
-    gnc_numeric  balance;
-    gnc_numeric  cleared_balance;
-    gnc_numeric  reconciled_balance;
+    Timespec date_reconciled;  /* date split was reconciled                 */
+
+    /* Where the split was before the current edit began. */
+    Account *orig_acc;
+    Transaction *orig_parent;
 };
 
 struct _SplitClass
@@ -66,6 +66,7 @@ struct timeval
 #include "SchedXaction.h"
 #include "gncBusiness.h"
 #include <qofinstance-p.h>
+#include "qofquery-p.h"
 #include "gncInvoice.h"
 #include "gncOwner.h"
 
@@ -2975,6 +2976,11 @@ xaccTransRetDateDueTS (Transaction * trans)
 
 gboolean xaccTransRegister (void)
 {
+    static const char *thread_safe[] =
+        {
+            TRANS_NUM, TRANS_DESCRIPTION, TRANS_DATE_ENTERED, TRANS_DATE_POSTED,
+            QOF_PARAM_GUID, NULL
+        };
     static QofParam params[] =
         {
             {
@@ -3057,6 +3063,7 @@ gboolean xaccTransRegister (void)
         };
 
     qof_class_register (GNC_ID_TRANS, (QofSortFunc)xaccTransOrder, params);
+    qof_query_register_thread_safe (GNC_ID_TRANS, thread_safe);
 
     return qof_object_register (&trans_object_def);
 }
@@ -79,6 +79,34 @@ engine-common.i */
 
 %newobject gnc_account_get_full_name;
 
+/* The multi-date balance functions take a list of dates and return a
+   list of balances. */
+%typemap(in) (const time64 *dates, gsize n_dates) {
+  SCM list = $input;
+  gsize i = 0;
+
+  $2 = scm_to_size_t (scm_length (list));
+  $1 = g_new (time64, $2);
+  for (; !scm_is_null (list); list = SCM_CDR (list))
+    $1[i++] = scm_to_int64 (SCM_CAR (list));
+}
+%typemap(freearg) (const time64 *dates, gsize n_dates) "g_free ($1);"
+
+%typemap(out) GArray *xaccAccountGetBalancesAsOfDates,
+              GArray *xaccAccountGetBalanceChangesForPeriods {
+  SCM list = SCM_EOL;
+  guint i;
+
+  for (i = $1 ? $1->len : 0; i > 0; --i)
+    list = scm_cons (gnc_numeric_to_scm (g_array_index ($1, gnc_numeric, i - 1)),
+                     list);
+
+  $result = list;
+}
+%typemap(newfree) GArray * "if ($1) g_array_free ($1, TRUE);"
+%newobject xaccAccountGetBalancesAsOfDates;
+%newobject xaccAccountGetBalanceChangesForPeriods;
+
 %include "engine-common.i"
 
 %inline %{
@@ -48,6 +48,10 @@ extern "C"
 }
 
 #include <cinttypes>
+#include <clocale>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
 #include "gnc-date.h"
 #include "gnc-date-p.h"
@@ -90,6 +94,51 @@ static QofDateFormat prevQofDateFormat = QOF_DATE_FORMAT_LOCALE;
 static QofDateCompletion dateCompletion = QOF_DATE_COMPLETION_THISYEAR;
 static int dateCompletionBackMonths = 6;
 
+/* The register and reports print and scan the same few thousand days over
+ * and over. The numeric formats are written directly; dates in the other
+ * formats are cached by day, and scanned dates by string, until the format,
+ * the locale's date format and names, or the completion method change.
+ * Reports run in other threads, so the caches are only touched with
+ * date_cache_mutex held.
+ */
+#define DATE_CACHE_MAX 20000
+struct ScannedDate
+{
+    int day, month, year;
+};
+static std::unordered_map<int, std::string> printed_dates;
+static std::unordered_map<std::string, ScannedDate> scanned_dates;
+static std::string date_cache_locale;
+static std::mutex date_cache_mutex;
+
+static void
+date_caches_clear (void)
+{
+    std::lock_guard<std::mutex> lock (date_cache_mutex);
+    printed_dates.clear ();
+    scanned_dates.clear ();
+}
+
+/* Forget the cached dates if setlocale has changed the date format
+ * string or the month names since they were made. Call with
+ * date_cache_mutex held. */
+static void
+date_caches_check_locale (void)
+{
+    std::string current {qof_date_format_get_string (dateFormat)};
+    auto lc_time = setlocale (LC_TIME, NULL);
+    if (lc_time)
+    {
+        current += '\n';
+        current += lc_time;
+    }
+    if (current == date_cache_locale)
+        return;
+    printed_dates.clear ();
+    scanned_dates.clear ();
+    date_cache_locale = std::move (current);
+}
+
 /* This static indicates the debugging module that this .o belongs to. */
 static QofLogModule log_module = QOF_MOD_ENGINE;
 
@@ -530,6 +579,7 @@ void qof_date_format_set(QofDateFormat df)
         prevQofDateFormat = dateFormat;
         dateFormat = QOF_DATE_FORMAT_ISO;
     }
+    date_caches_clear ();
 
     return;
 }
@@ -572,6 +622,8 @@ void qof_date_completion_set(QofDateCompletion dc, int backmonths)
         backmonths = 11;
     }
     dateCompletionBackMonths = backmonths;
+    std::lock_guard<std::mutex> lock (date_cache_mutex);
+    scanned_dates.clear ();
 
     return;
 }
@@ -628,17 +680,98 @@ const gchar *qof_date_text_format_get_string(QofDateFormat df)
     return GNC_D_FMT;
 }
 
+/* Write the date in one of the numeric formats to buff, which must hold 11
+ * characters. Returns the length or 0 if the format isn't numeric. */
+static size_t
+print_date_numeric (char *buff, QofDateFormat df, int day, int month,
+                    int year)
+{
+    char *p = buff;
+    auto put_2 = [&p](int n)
+    {
+        *p++ = '0' + n / 10;
+        *p++ = '0' + n % 10;
+    };
+    auto put_year = [&p, &put_2](int n)
+    {
+        put_2 (n / 100);
+        put_2 (n % 100);
+    };
+
+    if (year < 1000 || year > 9999)
+        return 0;
+    switch (df)
+    {
+    case QOF_DATE_FORMAT_US:
+        put_2 (month);
+        *p++ = '/';
+        put_2 (day);
+        *p++ = '/';
+        put_year (year);
+        break;
+    case QOF_DATE_FORMAT_UK:
+    case QOF_DATE_FORMAT_CE:
+        put_2 (day);
+        *p++ = df == QOF_DATE_FORMAT_CE ? '.' : '/';
+        put_2 (month);
+        *p++ = df == QOF_DATE_FORMAT_CE ? '.' : '/';
+        put_year (year);
+        break;
+    case QOF_DATE_FORMAT_ISO:
+        put_year (year);
+        *p++ = '-';
+        put_2 (month);
+        *p++ = '-';
+        put_2 (day);
+        break;
+    default:
+        return 0;
+    }
+    *p = '\0';
+    return p - buff;
+}
+
+/* Copy str to buff as strncpy does, always terminating it. */
+static void
+copy_date_string (char *buff, size_t len, const char *str, size_t str_len)
+{
+    strncpy (buff, str, len);
+    if (str_len >= len)
+        buff[len - 1] = '\0';
+}
+
 size_t
 qof_print_date_dmy_buff (char * buff, size_t len, int day, int month, int year)
 {
+    char numeric[11];
     if (!buff) return 0;
+    if (g_date_valid_dmy (day, static_cast<GDateMonth>(month), year) &&
+        print_date_numeric (numeric, dateFormat, day, month, year))
+    {
+        copy_date_string (buff, len, numeric, strlen (numeric));
+        return strlen (buff);
+    }
     try
     {
-        GncDate date(year, month, day);
-        std::string str = date.format(qof_date_format_get_string(dateFormat));
-        strncpy(buff, str.c_str(), len);
-        if (str.length() >= len)
-            buff[len - 1] = '\0';
+        auto key = (year * 100 + month) * 100 + day;
+        std::string printed;
+        {
+            std::lock_guard<std::mutex> lock (date_cache_mutex);
+            date_caches_check_locale ();
+            auto cached = printed_dates.find (key);
+            if (cached != printed_dates.end ())
+                printed = cached->second;
+        }
+        if (printed.empty ())
+        {
+            GncDate date(year, month, day);
+            printed = date.format(qof_date_format_get_string(dateFormat));
+            std::lock_guard<std::mutex> lock (date_cache_mutex);
+            if (printed_dates.size () >= DATE_CACHE_MAX)
+                printed_dates.clear ();
+            printed_dates.emplace (key, printed);
+        }
+        copy_date_string (buff, len, printed.c_str (), printed.length ());
     }
     catch(std::logic_error& err)
     {
@@ -657,6 +790,14 @@ size_t
 qof_print_date_buff (char * buff, size_t len, time64 t)
 {
     if (!buff) return 0;
+    /* Apart from UTC the formats only show the day. */
+    if (dateFormat != QOF_DATE_FORMAT_UTC)
+    {
+        struct tm tm;
+        if (gnc_localtime_r (&t, &tm))
+            return qof_print_date_dmy_buff (buff, len, tm.tm_mday,
+                                            tm.tm_mon + 1, tm.tm_year + 1900);
+    }
     try
     {
         GncDateTime gncdt(t);
@@ -752,7 +893,7 @@ floordiv(int a, int b)
 */
 static gboolean
 qof_scan_date_internal (const char *buff, int *day, int *month, int *year,
-                        QofDateFormat which_format)
+                        QofDateFormat which_format, gboolean *cacheable)
 {
     char *dupe, *tmp, *first_field, *second_field, *third_field;
     int iday, imonth, iyear;
@@ -767,6 +908,7 @@ qof_scan_date_internal (const char *buff, int *day, int *month, int *year,
         if (strptime(buff, QOF_UTC_DATE_FORMAT, &utc)
             || strptime (buff, "%Y-%m-%d", &utc))
         {
+            *cacheable = TRUE;
             *day = utc.tm_mday;
             *month = utc.tm_mon + 1;
             *year = utc.tm_year + 1900;
@@ -953,7 +1095,8 @@ qof_scan_date_internal (const char *buff, int *day, int *month, int *year,
          * deemed acceptable given the obscurity of this bug.
          */
         if ((which_format != prevQofDateFormat) &&
-                qof_scan_date_internal(buff, day, month, year, prevQofDateFormat))
+                qof_scan_date_internal(buff, day, month, year,
+                                       prevQofDateFormat, cacheable))
         {
             return(TRUE);
         }
@@ -979,6 +1122,8 @@ qof_scan_date_internal (const char *buff, int *day, int *month, int *year,
        this is less confusing.
     */
 
+    /* Only a full year doesn't depend on today's date. */
+    *cacheable = iyear >= 100;
     if (iyear == -1)
     {
         if (dateCompletion == QOF_DATE_COMPLETION_THISYEAR)
@@ -1006,7 +1151,42 @@ qof_scan_date_internal (const char *buff, int *day, int *month, int *year,
 gboolean
 qof_scan_date (const char *buff, int *day, int *month, int *year)
 {
-    return qof_scan_date_internal(buff, day, month, year, dateFormat);
+    gboolean cacheable = FALSE;
+    int iday, imonth, iyear;
+
+    if (!buff) return FALSE;
+    std::string key {buff};
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> lock (date_cache_mutex);
+        date_caches_check_locale ();
+        auto cached = scanned_dates.find (key);
+        if (cached != scanned_dates.end ())
+        {
+            iday = cached->second.day;
+            imonth = cached->second.month;
+            iyear = cached->second.year;
+            found = true;
+        }
+    }
+    if (!found)
+    {
+        if (!qof_scan_date_internal (buff, &iday, &imonth, &iyear, dateFormat,
+                                     &cacheable))
+            return FALSE;
+        if (cacheable)
+        {
+            std::lock_guard<std::mutex> lock (date_cache_mutex);
+            if (scanned_dates.size () >= DATE_CACHE_MAX)
+                scanned_dates.clear ();
+            scanned_dates.emplace (std::move (key),
+                                   ScannedDate {iday, imonth, iyear});
+        }
+    }
+    if (day) *day = iday;
+    if (month) *month = imonth;
+    if (year) *year = iyear;
+    return TRUE;
 }
 
 /* Return the field separator for the current date format
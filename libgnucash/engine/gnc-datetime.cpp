@@ -32,6 +32,7 @@ extern "C"
 #include <boost/date_time/local_time/local_time.hpp>
 #include <boost/regex.hpp>
 #include <libintl.h>
+#include <cstring>
 #include <map>
 #include <memory>
 #include <iostream>
@@ -164,6 +165,17 @@ LDT_from_struct_tm(const struct tm tm)
         auto tdur = boost::posix_time::time_duration(tm.tm_hour, tm.tm_min,
                                                      tm.tm_sec, 0);
         auto tz = tzp.get(tdate.year());
+        /* Let boost sort out (and throw on) times in a transition and
+         * times whose UTC year differs, for which tzp's table would use
+         * that year's zone instead of tz. */
+        time64 time;
+        auto local = PTime(tdate, tdur) - unix_epoch;
+        if (tzp.utc_from_local(local.ticks() / ticks_per_second, time))
+        {
+            auto utc = unix_epoch + boost::posix_time::seconds(time);
+            if (utc.date().year() == tdate.year())
+                return LDT(utc, tz);
+        }
         LDT ldt(tdate, tdur, tz, LDTBase::EXCEPTION_ON_ERROR);
         return ldt;
     }
@@ -183,27 +195,49 @@ LDT_from_struct_tm(const struct tm tm)
 
 using TD = boost::posix_time::time_duration;
 
+/* The transition in effect at ldt, whose zone must be one of tzp's. */
+static const TZ_Transition*
+tzp_transition(const LDT& ldt)
+{
+    if (ldt.is_special())
+        return nullptr;
+    auto since = ldt.utc_time() - unix_epoch;
+    return &tzp.transition(since.ticks() / ticks_per_second);
+}
+
 class GncDateTimeImpl
 {
 public:
-    GncDateTimeImpl() : m_time(boost::local_time::local_sec_clock::local_time(tzp.get(boost::gregorian::day_clock::local_day().year()))) {}
-    GncDateTimeImpl(const time64 time) : m_time(LDT_from_unix_local(time)) {}
-    GncDateTimeImpl(const struct tm tm) : m_time(LDT_from_struct_tm(tm)) {}
+    GncDateTimeImpl() { now(); }
+    GncDateTimeImpl(const time64 time) : m_time(LDT_from_unix_local(time)),
+        m_transition(&tzp.transition(time)) {}
+    GncDateTimeImpl(const struct tm tm) : m_time(LDT_from_struct_tm(tm)),
+        m_transition(tzp_transition(m_time)) {}
     GncDateTimeImpl(const GncDateImpl& date, DayPart part = DayPart::neutral);
     GncDateTimeImpl(std::string str);
-    GncDateTimeImpl(PTime&& pt) : m_time(pt, tzp.get(pt.date().year())) {}
-    GncDateTimeImpl(LDT&& ldt) : m_time(ldt) {}
+    GncDateTimeImpl(PTime&& pt) : m_time(pt, tzp.get(pt.date().year())),
+        m_transition(tzp_transition(m_time)) {}
+    GncDateTimeImpl(LDT&& ldt) : m_time(ldt), m_transition(nullptr) {}
 
     operator time64() const;
     operator struct tm() const;
-    void now() { m_time = boost::local_time::local_sec_clock::local_time(tzp.get(boost::gregorian::day_clock::local_day().year())); }
+    void now()
+    {
+        m_time = boost::local_time::local_sec_clock::local_time(tzp.get(boost::gregorian::day_clock::local_day().year()));
+        m_transition = tzp_transition(m_time);
+    }
     long offset() const;
     struct tm utc_tm() const { return to_tm(m_time.utc_time()); }
     std::unique_ptr<GncDateImpl> date() const;
     std::string format(const char* format) const;
     std::string format_zulu(const char* format) const;
 private:
-    LDT m_time;
+    PTime local_time() const;
+
+    LDT m_time{not_a_date_time};
+    /* The offset from tzp's table, or nullptr if m_time is in some other
+     * zone and boost has to work it out. */
+    const TZ_Transition* m_transition;
     static const TD time_of_day[3];
 };
 
@@ -240,13 +274,15 @@ private:
 
 GncDateTimeImpl::GncDateTimeImpl(const GncDateImpl& date, DayPart part) :
     m_time(date.m_greg, time_of_day[part], tzp.get(date.m_greg.year()),
-                     LDT::NOT_DATE_TIME_ON_ERROR)
+                     LDT::NOT_DATE_TIME_ON_ERROR),
+    m_transition(tzp_transition(m_time))
 {
     using boost::posix_time::hours;
     try
     {
         if (part == DayPart::neutral)
         {
+            m_transition = nullptr;
             auto offset = m_time.local_time() - m_time.utc_time();
             m_time = LDT(date.m_greg, time_of_day[part], utc_zone,
                          LDT::EXCEPTION_ON_ERROR);
@@ -279,7 +315,7 @@ tz_from_string(std::string str)
 }
 
 GncDateTimeImpl::GncDateTimeImpl(std::string str) :
-    m_time(unix_epoch, utc_zone)
+    m_time(unix_epoch, utc_zone), m_transition(nullptr)
 {
     if (str.empty()) return;
 
@@ -323,16 +359,36 @@ GncDateTimeImpl::operator time64() const
 
 GncDateTimeImpl::operator struct tm() const
 {
-    struct tm time = to_tm(m_time);
+    if (!m_transition)
+    {
+        struct tm time = to_tm(m_time);
 #if HAVE_STRUCT_TM_GMTOFF
-    time.tm_gmtoff = offset();
+        time.tm_gmtoff = offset();
+#endif
+        return time;
+    }
+    struct tm time = to_tm(local_time());
+    time.tm_isdst = m_transition->is_dst;
+#if HAVE_STRUCT_TM_GMTOFF
+    time.tm_gmtoff = m_transition->offset;
 #endif
     return time;
 }
 
+PTime
+GncDateTimeImpl::local_time() const
+{
+    if (m_transition && !m_time.is_special())
+        return m_time.utc_time() +
+            boost::posix_time::seconds(m_transition->offset);
+    return m_time.local_time();
+}
+
 long
 GncDateTimeImpl::offset() const
 {
+    if (m_transition)
+        return m_transition->offset;
     auto offset = m_time.local_time() - m_time.utc_time();
     return offset.total_seconds();
 }
@@ -340,18 +396,28 @@ GncDateTimeImpl::offset() const
 std::unique_ptr<GncDateImpl>
 GncDateTimeImpl::date() const
 {
-    return std::unique_ptr<GncDateImpl>(new GncDateImpl(m_time.local_time().date()));
+    return std::unique_ptr<GncDateImpl>(new GncDateImpl(local_time().date()));
 }
 
 std::string
 GncDateTimeImpl::format(const char* format) const
 {
-    using Facet = boost::local_time::local_time_facet;
     std::stringstream ss;
-    //The stream destructor frees the facet, so it must be heap-allocated.
+    /* Only the local time facet knows about the zone; without any zone
+     * flags the time facet can format the local time from the table. */
+    if (!m_transition || strpbrk(format, "zZqQ"))
+    {
+        using Facet = boost::local_time::local_time_facet;
+        //The stream destructor frees the facet, so it must be heap-allocated.
+        auto output_facet(new Facet(format));
+        ss.imbue(std::locale(std::locale(), output_facet));
+        ss << m_time;
+        return ss.str();
+    }
+    using Facet = boost::posix_time::time_facet;
     auto output_facet(new Facet(format));
     ss.imbue(std::locale(std::locale(), output_facet));
-    ss << m_time;
+    ss << local_time();
     return ss.str();
 }
 
@@ -62,6 +62,22 @@ namespace {
     {
         return leg & nummask;
     }
+#ifdef GNC_INT128_NATIVE
+    __extension__ typedef unsigned __int128 uint128_t;
+
+    static inline uint128_t to_native(uint64_t hi, uint64_t lo)
+    {
+        return (static_cast<uint128_t>(hi) << GncInt128::legbits) + lo;
+    }
+    static inline unsigned int trailing_zeroes(uint128_t val)
+    {
+        auto lo = static_cast<uint64_t>(val);
+        if (lo)
+            return __builtin_ctzll(lo);
+        return GncInt128::legbits +
+            __builtin_ctzll(static_cast<uint64_t>(val >> GncInt128::legbits));
+    }
+#endif
 }
 
 GncInt128::GncInt128 () : m_hi {0}, m_lo {0}{}
@@ -193,6 +209,24 @@ GncInt128::gcd(GncInt128 b) const noexcept
     if (isOverflow() || isNan())
         return *this;
 
+#ifdef GNC_INT128_NATIVE
+    /* The same algorithm on the magnitudes, removing all the factors of 2 in
+     * one step. */
+    auto u = to_native(get_num(m_hi), m_lo);
+    auto v = to_native(get_num(b.m_hi), b.m_lo);
+    auto k = trailing_zeroes(u | v);
+    u >>= trailing_zeroes(u);
+    do
+    {
+        v >>= trailing_zeroes(v);
+        if (u > v)
+            std::swap(u, v);
+        v -= u;
+    } while (v);
+    u <<= k;
+    return GncInt128(static_cast<uint64_t>(u >> legbits),
+                     static_cast<uint64_t>(u));
+#else
     GncInt128 a (isNeg() ? -(*this) : *this);
     if (b.isNeg()) b = -b;
 
@@ -215,6 +249,7 @@ GncInt128::gcd(GncInt128 b) const noexcept
         t = a - b;  //B6
     }
     return a << k;
+#endif
 }
 
 /* Since u * v = gcd(u, v) * lcm(u, v), we find lcm by u / gcd * v. */
@@ -295,11 +330,17 @@ unsigned int
 GncInt128::bits() const noexcept
 {
     auto hi = get_num(m_hi);
+#ifdef GNC_INT128_NATIVE
+    if (hi)
+        return 2 * legbits - __builtin_clzll(hi);
+    return m_lo ? legbits - __builtin_clzll(m_lo) : 0;
+#else
     unsigned int bits {static_cast<unsigned int>(hi == 0 ? 0 : 64)};
     uint64_t temp {(hi == 0 ? m_lo : hi)};
     for (;temp > 0; temp >>= 1)
         ++bits;
     return bits;
+#endif
 }
 
 
@@ -522,6 +563,22 @@ GncInt128::operator*= (const GncInt128& b) noexcept
         return *this;
     }
 
+#ifdef GNC_INT128_NATIVE
+    /* At most one of the operands has a high leg, so the product is the
+     * full product of the low legs plus that high leg times the other's low
+     * leg shifted up by one leg.
+     */
+    auto product = static_cast<uint128_t>(m_lo) * b.m_lo;
+    auto upper = (product >> legbits) +
+        static_cast<uint128_t>(hi) * b.m_lo +
+        static_cast<uint128_t>(bhi) * m_lo;
+    m_lo = static_cast<uint64_t>(product);
+    hi = static_cast<uint64_t>(upper);
+    if (upper > nummask)
+        flags |= overflow;
+    m_hi = set_flags(hi, flags);
+    return *this;
+#else
 /* This is Knuth's "classical" multi-precision multiplication algorithm
  * truncated to a GncInt128 result with the loop unrolled for clarity and with
  * overflow and zero checks beforehand to save time. See Donald Knuth, "The Art
@@ -583,8 +640,10 @@ GncInt128::operator*= (const GncInt128& b) noexcept
     }
     m_hi = set_flags(hi, flags);
     return *this;
+#endif
 }
 
+#ifndef GNC_INT128_NATIVE
 namespace {
 /* Algorithm from Knuth (full citation at operator*=) p272ff.  Again, there
  * are faster algorithms out there, but they require much larger numbers to
@@ -714,6 +773,7 @@ div_single_leg (uint64_t* u, size_t m, uint64_t v,
 }
 
 }// namespace
+#endif
 
  void
 GncInt128::div (const GncInt128& b, GncInt128& q, GncInt128& r) const noexcept
@@ -773,6 +833,16 @@ GncInt128::div (const GncInt128& b, GncInt128& q, GncInt128& r) const noexcept
         return;
     }
 
+#ifdef GNC_INT128_NATIVE
+    auto dividend = to_native(hi, m_lo);
+    auto divisor = to_native(bhi, b.m_lo);
+    auto quot = dividend / divisor;
+    auto rem = dividend % divisor;
+    q.m_lo = static_cast<uint64_t>(quot);
+    q.m_hi = set_flags(static_cast<uint64_t>(quot >> legbits), qflags);
+    r.m_lo = static_cast<uint64_t>(rem);
+    r.m_hi = static_cast<uint64_t>(rem >> legbits);
+#else
     uint64_t u[sublegs + 2] {(m_lo & sublegmask), (m_lo >> sublegbits),
             (hi & sublegmask), (hi >> sublegbits), 0, 0};
     uint64_t v[sublegs] {(b.m_lo & sublegmask), (b.m_lo >> sublegbits),
@@ -785,6 +855,7 @@ GncInt128::div (const GncInt128& b, GncInt128& q, GncInt128& r) const noexcept
         return div_single_leg (u, m, v[0], q, r);
 
     return div_multi_leg (u, m, v, n, q, r);
+#endif
 }
 
 GncInt128&
@@ -44,6 +44,14 @@ extern "C"
 #include <ostream>
 #include <type_traits>
 
+/* Multiplication, division and gcd use the compiler's 128-bit integers where
+ * it has them. Define GNC_INT128_PORTABLE to use the two-leg arithmetic
+ * everywhere, e.g. to test it.
+ */
+#if defined(__SIZEOF_INT128__) && !defined(GNC_INT128_PORTABLE)
+#define GNC_INT128_NATIVE 1
+#endif
+
 //using std::string;
 /** @addtogroup GncInt128
  * @ingroup QOF
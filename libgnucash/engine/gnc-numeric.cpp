@@ -736,6 +736,63 @@ denom_lcd(gnc_numeric a, gnc_numeric b, int64_t denom, int how)
     return denom;
 }
 
+/* Set *sum to a + b, returning true if that overflowed. */
+static inline bool
+int64_add_overflows(int64_t a, int64_t b, int64_t *sum)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_add_overflow(a, b, sum);
+#else
+    if ((b > 0 && a > INT64_MAX - b) || (b < 0 && a < INT64_MIN - b))
+        return true;
+    *sum = a + b;
+    return false;
+#endif
+}
+
+/* Whether adding numbers with the same positive denominator can just add
+ * the numerators: the result then keeps that denominator, so only the
+ * fixed and lcd modes, aiming at that denominator, leave it alone. */
+static inline bool
+same_denom_ok(int64_t common, gint64 denom, gint how)
+{
+    auto dtype = how & GNC_NUMERIC_DENOM_MASK;
+    return common > 0 &&
+        (dtype == GNC_HOW_DENOM_FIXED || dtype == GNC_HOW_DENOM_LCD) &&
+        (denom == GNC_DENOM_AUTO || denom == common);
+}
+
+/* Most of the amounts in a book share their commodity's denominator, and
+ * adding those needs none of the rational arithmetic.  Returns false if
+ * the general code has to work out the sum. */
+static inline bool
+add_fast(gnc_numeric a, gnc_numeric b, gint64 denom, gint how,
+         gnc_numeric *result)
+{
+    if (a.denom != b.denom)
+    {
+        /* With a fixed automatic denominator, adding zero returns the
+         * other number unchanged. */
+        if (a.denom <= 0 || b.denom <= 0 || denom != GNC_DENOM_AUTO ||
+            (how & GNC_NUMERIC_DENOM_MASK) != GNC_HOW_DENOM_FIXED)
+            return false;
+        if (a.num == 0)
+            *result = b;
+        else if (b.num == 0)
+            *result = a;
+        else
+            return false;
+        return true;
+    }
+
+    int64_t num;
+    if (!same_denom_ok(a.denom, denom, how) ||
+        int64_add_overflows(a.num, b.num, &num) || num == INT64_MIN)
+        return false;
+    *result = {num, a.denom};
+    return true;
+}
+
 /* *******************************************************************
  *  gnc_numeric_add
  ********************************************************************/
@@ -744,10 +801,13 @@ gnc_numeric
 gnc_numeric_add(gnc_numeric a, gnc_numeric b,
                 gint64 denom, gint how)
 {
+    gnc_numeric sum;
     if (gnc_numeric_check(a) || gnc_numeric_check(b))
     {
         return gnc_numeric_error(GNC_ERROR_ARG);
     }
+    if (add_fast(a, b, denom, how, &sum))
+        return sum;
     denom = denom_lcd(a, b, denom, how);
     try
     {
@@ -797,11 +857,14 @@ gnc_numeric
 gnc_numeric_sub(gnc_numeric a, gnc_numeric b,
                 gint64 denom, gint how)
 {
-    gnc_numeric nb;
+    gnc_numeric diff;
     if (gnc_numeric_check(a) || gnc_numeric_check(b))
     {
         return gnc_numeric_error(GNC_ERROR_ARG);
     }
+    if (b.num != INT64_MIN &&
+        add_fast(a, {-b.num, b.denom}, denom, how, &diff))
+        return diff;
     denom = denom_lcd(a, b, denom, how);
     try
     {
@@ -843,6 +906,41 @@ gnc_numeric_sub(gnc_numeric a, gnc_numeric b,
     }
 }
 
+/* *******************************************************************
+ *  gnc_numeric_sum
+ ********************************************************************/
+
+gnc_numeric
+gnc_numeric_sum(const gnc_numeric *values, gsize count,
+                gint64 denom, gint how)
+{
+    if (!count)
+        return gnc_numeric_zero();
+
+    /* Check all the denominators before adding anything, so that both
+     * loops are simple enough for the compiler to unroll. */
+    auto common = values[0].denom;
+    bool same = same_denom_ok(common, denom, how);
+    for (gsize i = 1; same && i < count; ++i)
+        same = values[i].denom == common;
+
+    if (same)
+    {
+        int64_t num = values[0].num;
+        bool overflow = false;
+        for (gsize i = 1; i < count; ++i)
+            overflow |= int64_add_overflows(num, values[i].num, &num) ||
+                num == INT64_MIN;
+        if (!overflow)
+            return {num, common};
+    }
+
+    auto sum = values[0];
+    for (gsize i = 1; i < count; ++i)
+        sum = gnc_numeric_add(sum, values[i], denom, how);
+    return sum;
+}
+
 /* *******************************************************************
  *  gnc_numeric_mul
  ********************************************************************/
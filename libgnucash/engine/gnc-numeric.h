@@ -397,6 +397,13 @@ gnc_numeric gnc_numeric_add(gnc_numeric a, gnc_numeric b,
 gnc_numeric gnc_numeric_sub(gnc_numeric a, gnc_numeric b,
                             gint64 denom, gint how);
 
+/** Return the sum of the count values, as if they were added in turn with
+ * gnc_numeric_add(sum, value, denom, how).  Values that all share a
+ * denominator are summed without any rational arithmetic.  Returns zero
+ * if count is 0. */
+gnc_numeric gnc_numeric_sum(const gnc_numeric *values, gsize count,
+                            gint64 denom, gint how);
+
 /** Multiply a times b, returning the product.  An overflow
  *  may occur if the result of the multiplication can't
  *  be represented as a ratio of 64-bit int's after removing
@@ -57,6 +57,8 @@ struct gnc_price_db_s
     QofInstance inst;              /* globally unique object identifier */
     GHashTable *commodity_hash;
     gboolean bulk_update;		 /* TRUE while reading XML file, etc. */
+    GHashTable *rate_cache;		 /* conversion rates already worked out */
+    GHashTable *conversion_graph;	 /* which commodities have prices in which */
 };
 
 struct _GncPriceDBClass
@@ -41,8 +41,11 @@ static GNCPrice *lookup_nearest_in_time(GNCPriceDB *db, const gnc_commodity *c,
                                         Timespec t, gboolean sameday);
 static gboolean
 pricedb_pricelist_traversal(GNCPriceDB *db,
-                            gboolean (*f)(GList *p, gpointer user_data),
+                            gboolean (*f)(GPtrArray *series, gpointer user_data),
                             gpointer user_data);
+static void pricedb_invalidate_rates(GNCPriceDB *db);
+static void pricedb_invalidate_graph(GNCPriceDB *db);
+static gint compare_prices_by_commodity_date(gconstpointer a, gconstpointer b);
 
 enum
 {
@@ -452,6 +455,8 @@ static void
 gnc_price_set_dirty (GNCPrice *p)
 {
     qof_instance_set_dirty(&p->inst);
+    if (p->db)
+        pricedb_invalidate_rates(p->db);
     qof_event_gen(&p->inst, QOF_EVENT_MODIFY, NULL);
 }
 
@@ -849,13 +854,218 @@ gnc_price_list_equal(PriceList *prices1, PriceList *prices2)
     return TRUE;
 }
 
+/* ==================================================================== */
+/* price series functions
+
+   Each (commodity, currency) pair in the price db keeps its prices in a
+   GPtrArray sorted by compare_prices_by_date, so newest first.  The
+   array holds a reference on each price.  Keeping the prices contiguous
+   lets the lookups below find a time or a day by bisection instead of
+   walking a list; the PriceList functions above still work on GLists,
+   which price_series_to_list provides as a view.
+ */
+
+static GPtrArray *
+price_series_new (void)
+{
+    return g_ptr_array_new ();
+}
+
+static void
+price_series_free (GPtrArray *series)
+{
+    guint i;
+
+    for (i = 0; i < series->len; i++)
+    {
+        GNCPrice *p = g_ptr_array_index (series, i);
+        p->db = NULL;
+        gnc_price_unref (p);
+    }
+    g_ptr_array_free (series, TRUE);
+}
+
+/* Return the index of the first price at or before t, or series->len if
+ * all of them are later.  With strict set, the first price before t. */
+static guint
+price_series_bisect (const GPtrArray *series, Timespec t, gboolean strict)
+{
+    guint lo = 0, hi = series->len;
+
+    while (lo < hi)
+    {
+        guint mid = lo + (hi - lo) / 2;
+        Timespec price_t = gnc_price_get_time (g_ptr_array_index (series, mid));
+        gint cmp = timespec_cmp (&price_t, &t);
+
+        if (cmp > 0 || (strict && cmp == 0))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* Return the index at which p sorts into the series. */
+static guint
+price_series_position (const GPtrArray *series, const GNCPrice *p)
+{
+    guint lo = 0, hi = series->len;
+
+    while (lo < hi)
+    {
+        guint mid = lo + (hi - lo) / 2;
+
+        if (compare_prices_by_date (g_ptr_array_index (series, mid), p) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static gboolean
+price_series_find (const GPtrArray *series, const GNCPrice *p, guint *index)
+{
+    guint i = price_series_position (series, p);
+
+    if (i < series->len && g_ptr_array_index (series, i) == p)
+    {
+        *index = i;
+        return TRUE;
+    }
+    /* The price's time or guid was changed behind our back; fall back
+     * to looking at all of them. */
+    for (i = 0; i < series->len; i++)
+        if (g_ptr_array_index (series, i) == p)
+        {
+            *index = i;
+            return TRUE;
+        }
+    return FALSE;
+}
+
+/* Is there already a price with p's value on p's day?  Those are all
+ * next to where p would go, so only that day's prices are checked. */
+static gboolean
+price_series_has_duplicate (const GPtrArray *series, GNCPrice *p, guint pos)
+{
+    PriceListIsDuplStruct dupl;
+    Timespec p_day = timespecCanonicalDayTime (gnc_price_get_time (p));
+    guint i;
+
+    dupl.pPrice = p;
+    dupl.isDupl = FALSE;
+    for (i = pos; i < series->len && !dupl.isDupl; i++)
+    {
+        GNCPrice *other = g_ptr_array_index (series, i);
+        Timespec day = timespecCanonicalDayTime (gnc_price_get_time (other));
+        if (!timespec_equal (&day, &p_day))
+            break;
+        price_list_is_duplicate (other, &dupl);
+    }
+    for (i = pos; i > 0 && !dupl.isDupl; i--)
+    {
+        GNCPrice *other = g_ptr_array_index (series, i - 1);
+        Timespec day = timespecCanonicalDayTime (gnc_price_get_time (other));
+        if (!timespec_equal (&day, &p_day))
+            break;
+        price_list_is_duplicate (other, &dupl);
+    }
+    return dupl.isDupl;
+}
+
+/* Like gnc_price_list_insert: takes a reference on p and, if check_dupl
+ * is set, quietly leaves out a duplicate of a price already there. */
+static void
+price_series_insert (GPtrArray *series, GNCPrice *p, gboolean check_dupl)
+{
+    guint pos = price_series_position (series, p);
+
+    gnc_price_ref (p);
+    if (check_dupl && price_series_has_duplicate (series, p, pos))
+        return;
+    g_ptr_array_insert (series, pos, p);
+}
+
+/* Removes p and drops the series' reference to it. */
+static gboolean
+price_series_remove (GPtrArray *series, GNCPrice *p)
+{
+    guint i;
+
+    if (!price_series_find (series, p, &i))
+        return FALSE;
+    g_ptr_array_remove_index (series, i);
+    gnc_price_unref (p);
+    return TRUE;
+}
+
+/* A GList of the series' prices, newest first, without references. */
+static PriceList *
+price_series_to_list (const GPtrArray *series)
+{
+    GList *result = NULL;
+    guint i;
+
+    for (i = series->len; i > 0; i--)
+        result = g_list_prepend (result, g_ptr_array_index (series, i - 1));
+    return result;
+}
+
+/* Find the prices either side of t in the series of c in currency and
+ * of currency in c, taken together as pricedb_get_prices_internal would
+ * merge them: before is the newest price at or before t and after is
+ * the oldest price later than t.  Either may be NULL; neither is
+ * referenced.  Returns FALSE if there are no prices at all. */
+static gboolean
+pricedb_bracket_time (GNCPriceDB *db, const gnc_commodity *c,
+                      const gnc_commodity *currency, Timespec t,
+                      GNCPrice **before, GNCPrice **after)
+{
+    GPtrArray *series[2] = { NULL, NULL };
+    GHashTable *currency_hash;
+    gboolean found = FALSE;
+    int i;
+
+    *before = *after = NULL;
+    currency_hash = g_hash_table_lookup (db->commodity_hash, c);
+    if (currency_hash)
+        series[0] = g_hash_table_lookup (currency_hash, currency);
+    currency_hash = g_hash_table_lookup (db->commodity_hash, currency);
+    if (currency_hash)
+        series[1] = g_hash_table_lookup (currency_hash, c);
+
+    for (i = 0; i < 2; i++)
+    {
+        guint pos;
+
+        if (!series[i] || !series[i]->len) continue;
+        found = TRUE;
+        pos = price_series_bisect (series[i], t, FALSE);
+        if (pos < series[i]->len)
+        {
+            GNCPrice *p = g_ptr_array_index (series[i], pos);
+            if (!*before || compare_prices_by_date (p, *before) < 0)
+                *before = p;
+        }
+        if (pos > 0)
+        {
+            GNCPrice *p = g_ptr_array_index (series[i], pos - 1);
+            if (!*after || compare_prices_by_date (p, *after) > 0)
+                *after = p;
+        }
+    }
+    return found;
+}
+
 /* ==================================================================== */
 /* GNCPriceDB functions
 
    Structurally a GNCPriceDB contains a hash mapping price commodities
    (of type gnc_commodity*) to hashes mapping price currencies (of
-   type gnc_commodity*) to GNCPrice lists (see gnc-pricedb.h for a
-   description of GNCPrice lists).  The top-level key is the commodity
+   type gnc_commodity*) to price series, the sorted GPtrArrays described
+   above.  The top-level key is the commodity
    you want the prices for, and the second level key is the commodity
    that the value is expressed in terms of.
  */
@@ -916,18 +1126,7 @@ destroy_pricedb_currency_hash_data(gpointer key,
                                    gpointer data,
                                    gpointer user_data)
 {
-    GList *price_list = (GList *) data;
-    GList *node;
-    GNCPrice *p;
-
-    for (node = price_list; node; node = node->next)
-    {
-        p = node->data;
-
-        p->db = NULL;
-    }
-
-    gnc_price_list_destroy(price_list);
+    price_series_free ((GPtrArray *) data);
 }
 
 static void
@@ -955,6 +1154,10 @@ gnc_pricedb_destroy(GNCPriceDB *db)
     }
     g_hash_table_destroy (db->commodity_hash);
     db->commodity_hash = NULL;
+    if (db->rate_cache)
+        g_hash_table_destroy (db->rate_cache);
+    db->rate_cache = NULL;
+    pricedb_invalidate_graph (db);
     /* qof_instance_release (&db->inst); */
     g_object_unref(db);
 }
@@ -1037,7 +1240,7 @@ pricedb_equal_foreach_pricelist(gpointer key, gpointer val, gpointer user_data)
 {
     GNCPriceDBEqualData *equal_data = user_data;
     gnc_commodity *currency = key;
-    GList *price_list1 = val;
+    GList *price_list1 = price_series_to_list (val);
     GList *price_list2;
 
     price_list2 = gnc_pricedb_get_prices (equal_data->db2,
@@ -1047,6 +1250,7 @@ pricedb_equal_foreach_pricelist(gpointer key, gpointer val, gpointer user_data)
     if (!gnc_price_list_equal (price_list1, price_list2))
         equal_data->equal = FALSE;
 
+    g_list_free (price_list1);
     gnc_price_list_destroy (price_list2);
 }
 
@@ -1096,7 +1300,7 @@ add_price(GNCPriceDB *db, GNCPrice *p)
 {
     /* This function will use p, adding a ref, so treat p as read-only
        if this function succeeds. */
-    GList *price_list;
+    GPtrArray *series;
     gnc_commodity *commodity;
     gnc_commodity *currency;
     GHashTable *currency_hash;
@@ -1143,12 +1347,14 @@ add_price(GNCPriceDB *db, GNCPrice *p)
     {
         if (p->source > old_price->source)
         {
+            gnc_price_unref(old_price);
             gnc_price_unref(p);
             LEAVE ("Better price already in DB.");
             return FALSE;
         }
         gnc_pricedb_remove_price(db, old_price);
     }
+    gnc_price_unref(old_price);
 
     currency_hash = g_hash_table_lookup(db->commodity_hash, commodity);
     if (!currency_hash)
@@ -1157,21 +1363,16 @@ add_price(GNCPriceDB *db, GNCPrice *p)
         g_hash_table_insert(db->commodity_hash, commodity, currency_hash);
     }
 
-    price_list = g_hash_table_lookup(currency_hash, currency);
-    if (!gnc_price_list_insert(&price_list, p, !db->bulk_update))
-    {
-        LEAVE ("gnc_price_list_insert failed");
-        return FALSE;
-    }
-
-    if (!price_list)
+    series = g_hash_table_lookup(currency_hash, currency);
+    if (!series)
     {
-        LEAVE (" no price list");
-        return FALSE;
+        series = price_series_new();
+        g_hash_table_insert(currency_hash, currency, series);
+        pricedb_invalidate_graph(db);
     }
-
-    g_hash_table_insert(currency_hash, currency, price_list);
+    price_series_insert(series, p, !db->bulk_update);
     p->db = db;
+    pricedb_invalidate_rates(db);
 
     qof_event_gen (&p->inst, QOF_EVENT_ADD, NULL);
 
@@ -1214,6 +1415,192 @@ gnc_pricedb_add_price(GNCPriceDB *db, GNCPrice *p)
     return TRUE;
 }
 
+/* A commodity pair, either way round, on a day: the pricedb only keeps
+ * one price for each. */
+typedef struct
+{
+    const gnc_commodity *a;
+    const gnc_commodity *b;
+    time64 day;
+} PriceDayKey;
+
+static void
+price_day_key_init (PriceDayKey *key, const GNCPrice *p)
+{
+    Timespec day = timespecCanonicalDayTime (p->tmspec);
+
+    if (p->commodity < p->currency)
+    {
+        key->a = p->commodity;
+        key->b = p->currency;
+    }
+    else
+    {
+        key->a = p->currency;
+        key->b = p->commodity;
+    }
+    key->day = day.tv_sec;
+}
+
+static guint
+price_day_key_hash (gconstpointer key)
+{
+    const PriceDayKey *k = key;
+    return g_direct_hash (k->a) ^ (g_direct_hash (k->b) * 31) ^
+        (guint)(k->day ^ (k->day >> 32));
+}
+
+static gboolean
+price_day_key_equal (gconstpointer a, gconstpointer b)
+{
+    const PriceDayKey *ka = a, *kb = b;
+    return ka->a == kb->a && ka->b == kb->b && ka->day == kb->day;
+}
+
+/* Merge count prices from run, all of the same commodity and currency
+ * and sorted by compare_prices_by_date, into their series.  Returns the
+ * number that weren't already there. */
+static int
+pricedb_merge_series (GNCPriceDB *db, GList *run, guint count)
+{
+    GNCPrice *first = run->data;
+    GHashTable *currency_hash;
+    GPtrArray *series, *merged;
+    guint i = 0, len;
+    int added = 0;
+
+    currency_hash = g_hash_table_lookup (db->commodity_hash, first->commodity);
+    if (!currency_hash)
+    {
+        currency_hash = g_hash_table_new (NULL, NULL);
+        g_hash_table_insert (db->commodity_hash, first->commodity, currency_hash);
+    }
+    series = g_hash_table_lookup (currency_hash, first->currency);
+    len = series ? series->len : 0;
+
+    merged = g_ptr_array_sized_new (len + count);
+    for (; count > 0; count--, run = run->next)
+    {
+        GNCPrice *p = run->data;
+
+        while (i < len &&
+               compare_prices_by_date (g_ptr_array_index (series, i), p) < 0)
+            g_ptr_array_add (merged, g_ptr_array_index (series, i++));
+        if (i < len && g_ptr_array_index (series, i) == p)
+            continue;
+        gnc_price_ref (p);
+        p->db = db;
+        g_ptr_array_add (merged, p);
+        qof_event_gen (&p->inst, QOF_EVENT_ADD, NULL);
+        added++;
+    }
+    for (; i < len; i++)
+        g_ptr_array_add (merged, g_ptr_array_index (series, i));
+
+    g_hash_table_insert (currency_hash, first->currency, merged);
+    if (series)
+        g_ptr_array_free (series, TRUE);
+    else
+        pricedb_invalidate_graph (db);
+    return added;
+}
+
+int
+gnc_pricedb_add_prices (GNCPriceDB *db, PriceList *prices)
+{
+    GHashTable *best;
+    GHashTableIter iter;
+    gpointer value;
+    GList *node, *keep = NULL, *replaced = NULL;
+    int added = 0;
+
+    if (!db || !prices) return 0;
+    ENTER ("db=%p, %d prices", db, g_list_length (prices));
+
+    /* Only the best price of each pair on each day can get in, and of
+     * equals the later one, as if they were added one at a time. */
+    best = g_hash_table_new_full (price_day_key_hash, price_day_key_equal,
+                                  g_free, NULL);
+    for (node = prices; node; node = node->next)
+    {
+        GNCPrice *p = node->data;
+        PriceDayKey key, *new_key;
+        GNCPrice *other;
+
+        if (!p) continue;
+        if (!p->commodity || !p->currency || !qof_instance_books_equal (db, p))
+        {
+            PWARN ("skipping price %p without a commodity and currency in this book",
+                   p);
+            continue;
+        }
+        price_day_key_init (&key, p);
+        other = g_hash_table_lookup (best, &key);
+        if (other && p->source > other->source)
+            continue;
+        new_key = g_new (PriceDayKey, 1);
+        *new_key = key;
+        g_hash_table_replace (best, new_key, p);
+    }
+
+    /* Then against what's already in the db, where the loser is either
+     * the new price or the old one. */
+    g_hash_table_iter_init (&iter, best);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+        GNCPrice *p = value;
+        GNCPrice *old_price = gnc_pricedb_lookup_day (db, p->commodity,
+                                                      p->currency, p->tmspec);
+        if (old_price == p || (old_price && p->source > old_price->source))
+        {
+            gnc_price_unref (old_price);
+            continue;
+        }
+        if (old_price)
+            replaced = g_list_prepend (replaced, old_price);
+        keep = g_list_prepend (keep, p);
+    }
+    g_hash_table_destroy (best);
+
+    qof_event_begin_batch ();
+    gnc_pricedb_begin_edit (db);
+    for (node = replaced; node; node = node->next)
+    {
+        gnc_pricedb_remove_price (db, node->data);
+        gnc_price_unref (node->data);
+    }
+    g_list_free (replaced);
+
+    keep = g_list_sort (keep, compare_prices_by_commodity_date);
+    for (node = keep; node; )
+    {
+        GNCPrice *first = node->data;
+        GList *next = node->next;
+        guint count = 1;
+
+        while (next && GNC_PRICE (next->data)->commodity == first->commodity &&
+               GNC_PRICE (next->data)->currency == first->currency)
+        {
+            next = next->next;
+            count++;
+        }
+        added += pricedb_merge_series (db, node, count);
+        node = next;
+    }
+    g_list_free (keep);
+
+    if (added)
+    {
+        pricedb_invalidate_rates (db);
+        qof_instance_set_dirty (&db->inst);
+    }
+    gnc_pricedb_commit_edit (db);
+    qof_event_end_batch ();
+
+    LEAVE ("db=%p, added %d", db, added);
+    return added;
+}
+
 /* remove_price() is a utility; its only function is to remove the price
  * from the double-hash tables.
  */
@@ -1221,7 +1608,7 @@ gnc_pricedb_add_price(GNCPriceDB *db, GNCPrice *p)
 static gboolean
 remove_price(GNCPriceDB *db, GNCPrice *p, gboolean cleanup)
 {
-    GList *price_list;
+    GPtrArray *series;
     gnc_commodity *commodity;
     gnc_commodity *currency;
     GHashTable *currency_hash;
@@ -1257,24 +1644,20 @@ remove_price(GNCPriceDB *db, GNCPrice *p, gboolean cleanup)
     }
 
     qof_event_gen (&p->inst, QOF_EVENT_REMOVE, NULL);
-    price_list = g_hash_table_lookup(currency_hash, currency);
+    series = g_hash_table_lookup(currency_hash, currency);
     gnc_price_ref(p);
-    if (!gnc_price_list_remove(&price_list, p))
-    {
-        gnc_price_unref(p);
-        LEAVE (" cannot remove price list");
-        return FALSE;
-    }
+    if (series)
+        price_series_remove(series, p);
+    pricedb_invalidate_rates(db);
 
-    /* if the price list is empty, then remove this currency from the
+    /* if the price series is empty, then remove this currency from the
        commodity hash */
-    if (price_list)
-    {
-        g_hash_table_insert(currency_hash, currency, price_list);
-    }
-    else
+    if (!series || series->len == 0)
     {
         g_hash_table_remove(currency_hash, currency);
+        if (series)
+            price_series_free(series);
+        pricedb_invalidate_graph(db);
 
         if (cleanup)
         {
@@ -1379,14 +1762,15 @@ pricedb_remove_foreach_pricelist (gpointer key,
                                   gpointer val,
                                   gpointer user_data)
 {
-    GList *price_list = (GList *) val;
-    GList *node = price_list;
+    GPtrArray *series = (GPtrArray *) val;
     remove_info *data = (remove_info *) user_data;
+    guint i;
 
     ENTER("key %p, value %p, data %p", key, val, user_data);
 
-    /* now check each item in the list */
-    g_list_foreach(node, (GFunc)check_one_price_date, data);
+    /* now check each item in the series */
+    for (i = 0; i < series->len; i++)
+        check_one_price_date (g_ptr_array_index (series, i), data);
 
     LEAVE(" ");
 }
@@ -1696,28 +2080,31 @@ hash_values_helper(gpointer key, gpointer value, gpointer data)
     GList ** l = data;
     if (*l)
     {
-        GList *new_l;
-        new_l = pricedb_price_list_merge(*l, value);
+        GList *new_l, *series_l;
+        series_l = price_series_to_list (value);
+        new_l = pricedb_price_list_merge(*l, series_l);
+        g_list_free (series_l);
         g_list_free (*l);
         *l = new_l;
     }
     else
-        *l = g_list_copy (value);
+        *l = price_series_to_list (value);
 }
 
 static PriceList *
 price_list_from_hashtable (GHashTable *hash, const gnc_commodity *currency)
 {
-    GList *price_list = NULL, *result = NULL ;
+    GPtrArray *series;
+    GList *result = NULL;
     if (currency)
     {
-        price_list = g_hash_table_lookup(hash, currency);
-        if (!price_list)
+        series = g_hash_table_lookup(hash, currency);
+        if (!series)
         {
             LEAVE (" no price list");
             return NULL;
         }
-        result = g_list_copy (price_list);
+        result = price_series_to_list (series);
     }
     else
     {
@@ -1811,20 +2198,19 @@ gnc_pricedb_lookup_latest(GNCPriceDB *db,
                           const gnc_commodity *commodity,
                           const gnc_commodity *currency)
 {
-    GList *price_list;
+    GNCPrice *before, *after;
     GNCPrice *result;
+    Timespec t = {G_MAXINT64, 0};
 
     if (!db || !commodity || !currency) return NULL;
     ENTER ("db=%p commodity=%p currency=%p", db, commodity, currency);
 
-    price_list = pricedb_get_prices_internal(db, commodity, currency, TRUE);
-    if (!price_list) return NULL;
-    /* This works magically because prices are inserted in date-sorted
-     * order, and the latest date always comes first. So return the
-     * first in the list.  */
-    result = price_list->data;
+    /* Everything is before the end of time, so this finds the first
+     * price of whichever direction has the newest. */
+    if (!pricedb_bracket_time (db, commodity, currency, t, &before, &after))
+        return NULL;
+    result = before;
     gnc_price_ref(result);
-    g_list_free (price_list);
     LEAVE(" ");
     return result;
 }
@@ -1847,54 +2233,49 @@ typedef struct
 */
 
 static gboolean
-price_list_scan_any_currency(GList *price_list, gpointer data)
+price_list_scan_any_currency(GPtrArray *series, gpointer data)
 {
     UsesCommodity *helper = (UsesCommodity*)data;
-    GList *node = price_list;
     gnc_commodity *com;
     gnc_commodity *cur;
+    GNCPrice *price;
+    guint pos;
 
-    if (!price_list)
+    if (!series || !series->len)
         return TRUE;
 
-    com = gnc_price_get_commodity(node->data);
-    cur = gnc_price_get_currency(node->data);
+    price = g_ptr_array_index (series, 0);
+    com = gnc_price_get_commodity(price);
+    cur = gnc_price_get_currency(price);
 
     /* if this price list isn't for the commodity we are interested in,
        ignore it. */
     if (com != helper->com && cur != helper->com)
         return TRUE;
 
-    /* The price list is sorted in decreasing order of time.  Find the first
+    /* The series is sorted in decreasing order of time.  Find the first
        price on it that is older than the requested time and add it and the
        previous price to the result list. */
-    while (node != NULL)
+    pos = price_series_bisect (series, helper->t, TRUE);
+    if (pos < series->len)
     {
-        GNCPrice *price = node->data;
-        Timespec price_t = gnc_price_get_time(price);
-        if (timespec_cmp(&price_t, &helper->t) < 0)
-        {
-            /* If there is a previous price add it to the results. */
-            if (node->prev)
-            {
-                GNCPrice *prev_price = node->prev->data;
-                gnc_price_ref(prev_price);
-                *helper->list = g_list_prepend(*helper->list, prev_price);
-            }
-            /* Add the first price before the desired time */
-            gnc_price_ref(price);
-            *helper->list = g_list_prepend(*helper->list, price);
-            /* No point in looking further, they will all be older */
-            break;
-        }
-        else if (node->next == NULL)
+        /* If there is a previous price add it to the results. */
+        if (pos > 0)
         {
-            /* The last price is later than given time, add it */
-            gnc_price_ref(price);
-            *helper->list = g_list_prepend(*helper->list, price);
+            GNCPrice *prev_price = g_ptr_array_index (series, pos - 1);
+            gnc_price_ref(prev_price);
+            *helper->list = g_list_prepend(*helper->list, prev_price);
         }
-        node = node->next;
+        /* Add the first price before the desired time */
+        price = g_ptr_array_index (series, pos);
+    }
+    else
+    {
+        /* The last price is later than given time, add it */
+        price = g_ptr_array_index (series, series->len - 1);
     }
+    gnc_price_ref(price);
+    *helper->list = g_list_prepend(*helper->list, price);
 
     return TRUE;
 }
@@ -2111,7 +2492,7 @@ gnc_pricedb_has_prices(GNCPriceDB *db,
                        const gnc_commodity *commodity,
                        const gnc_commodity *currency)
 {
-    GList *price_list;
+    GPtrArray *series;
     GHashTable *currency_hash;
     gint size;
 
@@ -2126,8 +2507,8 @@ gnc_pricedb_has_prices(GNCPriceDB *db,
 
     if (currency)
     {
-        price_list = g_hash_table_lookup(currency_hash, currency);
-        if (price_list)
+        series = g_hash_table_lookup(currency_hash, currency);
+        if (series)
         {
             LEAVE("yes");
             return TRUE;
@@ -2171,9 +2552,9 @@ static void
 price_count_helper(gpointer key, gpointer value, gpointer data)
 {
     int *result = data;
-    GList *price_list = value;
+    GPtrArray *series = value;
 
-    *result += g_list_length(price_list);
+    *result += series->len;
 }
 
 int
@@ -2222,17 +2603,18 @@ gnc_pricedb_nth_price (GNCPriceDB *db,
             g_hash_table_iter_init(&iter, currency_hash);
             if (g_hash_table_iter_next(&iter, &key, &value))
             {
-                PriceList *prices = value;
-                result = g_list_nth_data(prices, n);
+                GPtrArray *series = value;
+                if ((guint) n < series->len)
+                    result = g_ptr_array_index(series, n);
             }
         }
         else if (num_currencies > 1)
         {
             /* Prices for multiple currencies, must find the nth entry in the
                merged currency list. */
-            GList **price_array = (GList **)g_new(gpointer, num_currencies);
-            GList **next_list;
-            int i, j;
+            GPtrArray **series_array = g_new(GPtrArray *, num_currencies);
+            guint *next_index = g_new0(guint, num_currencies);
+            int i, j, next;
             GHashTableIter iter;
             gpointer key, value;
 
@@ -2241,41 +2623,43 @@ gnc_pricedb_nth_price (GNCPriceDB *db,
                  g_hash_table_iter_next(&iter, &key, &value) && i < num_currencies;
                  i++)
             {
-                price_array[i] = value;
+                series_array[i] = value;
             }
 
             /* Iterate n times to get the nth price, each time finding the currency
                with the latest price */
             for (i = 0; i <= n; i++)
             {
-                next_list = NULL;
+                next = -1;
                 for (j = 0; j < num_currencies; j++)
                 {
                     /* Save this entry if it's the first one or later than
                        the saved one. */
-                    if (price_array[j] != NULL &&
-                        (next_list == NULL || *next_list == NULL ||
-                        compare_prices_by_date((*next_list)->data, (price_array[j])->data) > 0))
+                    if (next_index[j] < series_array[j]->len &&
+                        (next < 0 ||
+                        compare_prices_by_date(g_ptr_array_index(series_array[next], next_index[next]),
+                                               g_ptr_array_index(series_array[j], next_index[j])) > 0))
                     {
-                        next_list = &price_array[j];
+                        next = j;
                     }
                 }
-                /* next_list points to the list with the latest price unless all
-                   the lists are empty */
-                if (next_list && *next_list)
+                /* next is the series with the latest price unless all
+                   the series are used up */
+                if (next >= 0)
                 {
-                    result = (*next_list)->data;
-                    *next_list = (*next_list)->next;
+                    result = g_ptr_array_index(series_array[next], next_index[next]);
+                    next_index[next]++;
                 }
                 else
                 {
-                    /* all the lists are empty, "n" is greater than the number
+                    /* all the series are used up, "n" is greater than the number
                        of prices for this commodity. */
                     result = NULL;
                     break;
                 }
             }
-            g_free(price_array);
+            g_free(next_index);
+            g_free(series_array);
         }
     }
 
@@ -2310,26 +2694,20 @@ gnc_pricedb_lookup_at_time(GNCPriceDB *db,
                            const gnc_commodity *currency,
                            Timespec t)
 {
-    GList *price_list;
-    GList *item = NULL;
+    GNCPrice *before, *after;
 
     if (!db || !c || !currency) return NULL;
     ENTER ("db=%p commodity=%p currency=%p", db, c, currency);
-    price_list = pricedb_get_prices_internal (db, c, currency, TRUE);
-    item = price_list;
-    while (item)
+    if (pricedb_bracket_time (db, c, currency, t, &before, &after) && before)
     {
-        GNCPrice *p = item->data;
-        Timespec price_time = gnc_price_get_time(p);
+        Timespec price_time = gnc_price_get_time(before);
         if (timespec_equal(&price_time, &t))
         {
-            gnc_price_ref(p);
-            g_list_free (price_list);
-            return p;
+            gnc_price_ref(before);
+            LEAVE (" ");
+            return before;
         }
-        item = item->next;
     }
-    g_list_free (price_list);
     LEAVE (" ");
     return NULL;
 }
@@ -2341,35 +2719,20 @@ lookup_nearest_in_time(GNCPriceDB *db,
                        Timespec t,
                        gboolean sameday)
 {
-    GList *price_list;
     GNCPrice *current_price = NULL;
     GNCPrice *next_price = NULL;
     GNCPrice *result = NULL;
-    GList *item = NULL;
 
     if (!db || !c || !currency) return NULL;
     ENTER ("db=%p commodity=%p currency=%p", db, c, currency);
-    price_list = pricedb_get_prices_internal (db, c, currency, TRUE);
-    if (!price_list) return NULL;
-    item = price_list;
-
-    /* default answer */
-    current_price = item->data;
 
-    /* find the first candidate past the one we want.  Remember that
-       prices are in most-recent-first order. */
-    while (!next_price && item)
-    {
-        GNCPrice *p = item->data;
-        Timespec price_time = gnc_price_get_time(p);
-        if (timespec_cmp(&price_time, &t) <= 0)
-        {
-            next_price = item->data;
-            break;
-        }
-        current_price = item->data;
-        item = item->next;
-    }
+    /* next_price is the first candidate at or past the one we want and
+       current_price the one just later than that, or the latest price if
+       there isn't one. */
+    if (!pricedb_bracket_time (db, c, currency, t, &next_price, &current_price))
+        return NULL;
+    if (!current_price)
+        current_price = next_price;
 
     if (current_price)      /* How can this be null??? */
     {
@@ -2441,7 +2804,6 @@ lookup_nearest_in_time(GNCPriceDB *db,
     }
 
     gnc_price_ref(result);
-    g_list_free (price_list);
     LEAVE (" ");
     return result;
 }
@@ -2473,57 +2835,35 @@ gnc_pricedb_lookup_latest_before (GNCPriceDB *db,
                                   gnc_commodity *currency,
                                   Timespec t)
 {
-    GList *price_list;
     GNCPrice *current_price = NULL;
-    /*  GNCPrice *next_price = NULL;
-        GNCPrice *result = NULL;*/
-    GList *item = NULL;
-    Timespec price_time;
+    GNCPrice *next_price = NULL;
 
     if (!db || !c || !currency) return NULL;
     ENTER ("db=%p commodity=%p currency=%p", db, c, currency);
-    price_list = pricedb_get_prices_internal (db, c, currency, TRUE);
-    if (!price_list) return NULL;
-    item = price_list;
-    do
-    {
-        price_time = gnc_price_get_time (item->data);
-        if (timespec_cmp(&price_time, &t) <= 0)
-            current_price = item->data;
-        item = item->next;
-    }
-    while (timespec_cmp(&price_time, &t) > 0 && item);
+    if (!pricedb_bracket_time (db, c, currency, t, &current_price, &next_price))
+        return NULL;
     gnc_price_ref(current_price);
-    g_list_free (price_list);
     LEAVE (" ");
     return current_price;
 }
 
 static gnc_numeric
-direct_balance_conversion (GNCPriceDB *db, gnc_numeric bal,
-                           const gnc_commodity *from, const gnc_commodity *to,
-                           time64 t)
+direct_price_conversion (GNCPriceDB *db, const gnc_commodity *from,
+                         const gnc_commodity *to, time64 t)
 {
     GNCPrice *price;
     gnc_numeric retval = gnc_numeric_zero();
     if (from == NULL || to == NULL)
         return retval;
-    if (gnc_numeric_zero_p(bal))
-        return retval;
     if (t != INT64_MAX)
         price = gnc_pricedb_lookup_nearest_in_time64(db, from, to, t);
     else
         price = gnc_pricedb_lookup_latest(db, from, to);
     if (price == NULL)
         return retval;
-    if (gnc_price_get_commodity(price) == from)
-        retval = gnc_numeric_mul (bal, gnc_price_get_value (price),
-                                  gnc_commodity_get_fraction (to),
-                                  GNC_HOW_RND_ROUND);
-    else
-        retval = gnc_numeric_div (bal, gnc_price_get_value (price),
-                                  gnc_commodity_get_fraction (to),
-                                  GNC_HOW_RND_ROUND);
+    retval = gnc_price_get_value (price);
+    if (gnc_price_get_commodity(price) != from)
+        retval = gnc_numeric_invert (retval);
     gnc_price_unref (price);
     return retval;
 
@@ -2575,8 +2915,8 @@ extract_common_prices (PriceList *from_prices, PriceList *to_prices)
 }
 
 static gnc_numeric
-convert_balance(gnc_numeric bal, const gnc_commodity *from,
-                const gnc_commodity *to, PriceTuple tuple)
+convert_price (const gnc_commodity *from, const gnc_commodity *to,
+               PriceTuple tuple)
 {
     gnc_commodity *from_com = gnc_price_get_commodity(tuple.from);
     gnc_commodity *from_cur = gnc_price_get_currency(tuple.from);
@@ -2584,38 +2924,29 @@ convert_balance(gnc_numeric bal, const gnc_commodity *from,
     gnc_commodity *to_cur = gnc_price_get_currency(tuple.to);
     gnc_numeric from_val = gnc_price_get_value(tuple.from);
     gnc_numeric to_val = gnc_price_get_value(tuple.to);
-    int fraction = gnc_commodity_get_fraction(to);
 
     int no_round = GNC_HOW_DENOM_EXACT | GNC_HOW_RND_NEVER;
     if (from_cur == from && to_cur == to)
-        return gnc_numeric_div(gnc_numeric_mul(bal, to_val, GNC_DENOM_AUTO,
-                                               no_round),
-                               from_val, fraction, GNC_HOW_RND_ROUND);
+        return gnc_numeric_div(to_val, from_val, GNC_DENOM_AUTO, no_round);
     if (from_com == from && to_com == to)
-        return gnc_numeric_div(gnc_numeric_mul(bal, from_val, GNC_DENOM_AUTO,
-                                               no_round),
-                               to_val, fraction, GNC_HOW_RND_ROUND);
+        return gnc_numeric_div(from_val, to_val, GNC_DENOM_AUTO, no_round);
     if (from_cur == from)
-        return gnc_numeric_div(bal, gnc_numeric_mul(from_val, to_val,
-                                                    GNC_DENOM_AUTO, no_round),
-                               fraction, GNC_HOW_RND_ROUND);
-    return gnc_numeric_mul(bal, gnc_numeric_mul(from_val, to_val,
-                                                GNC_DENOM_AUTO, no_round),
-                           fraction, GNC_HOW_RND_ROUND);
+        return gnc_numeric_invert(gnc_numeric_mul(from_val, to_val,
+                                                  GNC_DENOM_AUTO, no_round));
+    return gnc_numeric_mul(from_val, to_val, GNC_DENOM_AUTO, no_round);
 
 }
+
 static gnc_numeric
-indirect_balance_conversion (GNCPriceDB *db, gnc_numeric bal,
-                             const gnc_commodity *from, const gnc_commodity *to,
-                             time64 t )
+indirect_price_conversion (GNCPriceDB *db, const gnc_commodity *from,
+                           const gnc_commodity *to, time64 t)
 {
     GList *from_prices = NULL, *to_prices = NULL;
     PriceTuple tuple;
     gnc_numeric zero = gnc_numeric_zero();
+    gnc_numeric price;
     if (from == NULL || to == NULL)
         return zero;
-    if (gnc_numeric_zero_p(bal))
-        return zero;
     if (t == INT64_MAX)
     {
         from_prices = gnc_pricedb_lookup_latest_any_currency(db, from);
@@ -2637,11 +2968,263 @@ indirect_balance_conversion (GNCPriceDB *db, gnc_numeric bal,
     tuple = extract_common_prices(from_prices, to_prices);
     gnc_price_list_destroy(from_prices);
     gnc_price_list_destroy(to_prices);
-    if (tuple.from)
-        return convert_balance(bal, from, to, tuple);
-    return zero;
+    if (!tuple.from)
+        return zero;
+    price = convert_price(from, to, tuple);
+    gnc_price_unref(tuple.from);
+    gnc_price_unref(tuple.to);
+    return price;
+}
+
+/* The conversion graph joins two commodities when there are prices of one
+ * in the other, in either direction.  It's only rebuilt after a price
+ * series has been created or emptied. */
+static void
+pricedb_invalidate_graph (GNCPriceDB *db)
+{
+    if (!db->conversion_graph) return;
+    g_hash_table_destroy (db->conversion_graph);
+    db->conversion_graph = NULL;
+}
+
+static void
+conversion_graph_add_edge (GHashTable *graph, gnc_commodity *a,
+                           gnc_commodity *b)
+{
+    GHashTable *neighbors = g_hash_table_lookup (graph, a);
+    if (!neighbors)
+    {
+        neighbors = g_hash_table_new (NULL, NULL);
+        g_hash_table_insert (graph, a, neighbors);
+    }
+    g_hash_table_add (neighbors, b);
+}
+
+static GHashTable *
+pricedb_get_conversion_graph (GNCPriceDB *db)
+{
+    GHashTableIter com_iter;
+    gpointer commodity, currency_hash;
+
+    if (db->conversion_graph)
+        return db->conversion_graph;
+
+    db->conversion_graph =
+        g_hash_table_new_full (NULL, NULL, NULL,
+                               (GDestroyNotify)g_hash_table_destroy);
+    g_hash_table_iter_init (&com_iter, db->commodity_hash);
+    while (g_hash_table_iter_next (&com_iter, &commodity, &currency_hash))
+    {
+        GHashTableIter cur_iter;
+        gpointer currency;
+
+        g_hash_table_iter_init (&cur_iter, currency_hash);
+        while (g_hash_table_iter_next (&cur_iter, &currency, NULL))
+        {
+            conversion_graph_add_edge (db->conversion_graph, commodity, currency);
+            conversion_graph_add_edge (db->conversion_graph, currency, commodity);
+        }
+    }
+    return db->conversion_graph;
+}
+
+/* Convert along the path with the fewest hops from "from" to "to",
+ * taking the direct price of each hop at t. */
+static gnc_numeric
+graph_price_conversion (GNCPriceDB *db, const gnc_commodity *from,
+                        const gnc_commodity *to, time64 t)
+{
+    GHashTable *graph = pricedb_get_conversion_graph (db);
+    GHashTable *prev = g_hash_table_new (NULL, NULL);
+    GQueue *queue = g_queue_new ();
+    gnc_numeric rate = gnc_numeric_zero ();
+    gpointer node = (gpointer) from;
+    int no_round = GNC_HOW_DENOM_EXACT | GNC_HOW_RND_NEVER;
+
+    g_hash_table_insert (prev, node, node);
+    g_queue_push_tail (queue, node);
+    while ((node = g_queue_pop_head (queue)) != NULL && node != to)
+    {
+        GHashTable *neighbors = g_hash_table_lookup (graph, node);
+        GHashTableIter iter;
+        gpointer next;
+
+        if (!neighbors) continue;
+        g_hash_table_iter_init (&iter, neighbors);
+        while (g_hash_table_iter_next (&iter, &next, NULL))
+        {
+            if (g_hash_table_contains (prev, next)) continue;
+            g_hash_table_insert (prev, next, node);
+            g_queue_push_tail (queue, next);
+        }
+    }
+    g_queue_free (queue);
+
+    /* Walk back from "to", multiplying in each hop's rate. */
+    if (node == to)
+        rate = gnc_numeric_create (1, 1);
+    while (node && node != from)
+    {
+        gpointer hop_from = g_hash_table_lookup (prev, node);
+        gnc_numeric hop = direct_price_conversion (db, hop_from, node, t);
+
+        if (gnc_numeric_zero_p (hop))
+        {
+            rate = gnc_numeric_zero ();
+            break;
+        }
+        rate = gnc_numeric_mul (rate, hop, GNC_DENOM_AUTO, no_round);
+        node = hop_from;
+    }
+    g_hash_table_destroy (prev);
+
+    if (gnc_numeric_check (rate))
+        return gnc_numeric_zero ();
+    return rate;
+}
+
+/* Reports convert the same pairs at the same dates over and over, so the
+ * rates get_nearest_price works out are kept until a price changes. */
+typedef struct
+{
+    const gnc_commodity *from;
+    const gnc_commodity *to;
+    time64 t;
+} PriceRateKey;
+
+#define PRICE_RATE_CACHE_MAX 50000
+
+static guint
+price_rate_key_hash (gconstpointer key)
+{
+    const PriceRateKey *k = key;
+    return g_direct_hash (k->from) ^ (g_direct_hash (k->to) * 31) ^
+        (guint)(k->t ^ (k->t >> 32));
+}
+
+static gboolean
+price_rate_key_equal (gconstpointer a, gconstpointer b)
+{
+    const PriceRateKey *ka = a, *kb = b;
+    return ka->from == kb->from && ka->to == kb->to && ka->t == kb->t;
+}
+
+static void
+pricedb_invalidate_rates (GNCPriceDB *db)
+{
+    if (db->rate_cache && g_hash_table_size (db->rate_cache))
+        g_hash_table_remove_all (db->rate_cache);
+}
+
+static gboolean
+pricedb_lookup_rate (GNCPriceDB *db, const gnc_commodity *from,
+                     const gnc_commodity *to, time64 t, gnc_numeric *rate)
+{
+    PriceRateKey key;
+    gnc_numeric *cached;
+
+    if (!db->rate_cache) return FALSE;
+    key.from = from;
+    key.to = to;
+    key.t = t;
+    cached = g_hash_table_lookup (db->rate_cache, &key);
+    if (!cached) return FALSE;
+    *rate = *cached;
+    return TRUE;
+}
+
+static void
+pricedb_store_rate (GNCPriceDB *db, const gnc_commodity *from,
+                    const gnc_commodity *to, time64 t, gnc_numeric rate)
+{
+    PriceRateKey *key;
+    gnc_numeric *value;
+
+    if (!db->rate_cache)
+        db->rate_cache = g_hash_table_new_full (price_rate_key_hash,
+                                                price_rate_key_equal,
+                                                g_free, g_free);
+    /* Don't let a long run of distinct dates grow it without bound. */
+    else if (g_hash_table_size (db->rate_cache) >= PRICE_RATE_CACHE_MAX)
+        g_hash_table_remove_all (db->rate_cache);
+
+    key = g_new (PriceRateKey, 1);
+    key->from = from;
+    key->to = to;
+    key->t = t;
+    value = g_new (gnc_numeric, 1);
+    *value = rate;
+    g_hash_table_insert (db->rate_cache, key, value);
 }
 
+static gnc_numeric
+get_nearest_price (GNCPriceDB *pdb, const gnc_commodity *orig_curr,
+                   const gnc_commodity *new_curr, time64 t)
+{
+    gnc_numeric price;
+
+    if (gnc_commodity_equiv (orig_curr, new_curr))
+        return gnc_numeric_create (1, 1);
+
+    if (!pdb)
+        return gnc_numeric_zero ();
+
+    if (pricedb_lookup_rate (pdb, orig_curr, new_curr, t, &price))
+        return price;
+
+    /* Look for a direct price. */
+    price = direct_price_conversion (pdb, orig_curr, new_curr, t);
+
+    /*
+     * no direct price found, try if we find a price in another currency
+     * and convert in two stages
+     */
+    if (gnc_numeric_zero_p (price))
+        price = indirect_price_conversion (pdb, orig_curr, new_curr, t);
+
+    /* Still nothing, so go through as many currencies as it takes. */
+    if (gnc_numeric_zero_p (price))
+        price = graph_price_conversion (pdb, orig_curr, new_curr, t);
+
+    pricedb_store_rate (pdb, orig_curr, new_curr, t, price);
+    return price;
+}
+
+gnc_numeric
+gnc_pricedb_get_latest_price (GNCPriceDB *pdb,
+                              const gnc_commodity *orig_currency,
+                              const gnc_commodity *new_currency)
+{
+    return get_nearest_price (pdb, orig_currency, new_currency, INT64_MAX);
+}
+
+gnc_numeric
+gnc_pricedb_get_nearest_price (GNCPriceDB *pdb,
+                               const gnc_commodity *orig_currency,
+                               const gnc_commodity *new_currency,
+                               time64 t)
+{
+    return get_nearest_price (pdb, orig_currency, new_currency, t);
+}
+
+static gnc_numeric
+convert_amount_at_date (GNCPriceDB *pdb, gnc_numeric amount,
+                        const gnc_commodity *orig_currency,
+                        const gnc_commodity *new_currency, time64 t)
+{
+    gnc_numeric price;
+
+    if (gnc_numeric_zero_p (amount))
+        return amount;
+
+    price = get_nearest_price (pdb, orig_currency, new_currency, t);
+    if (gnc_numeric_check (price))
+        return gnc_numeric_zero ();
+
+    return gnc_numeric_mul (amount, price,
+                            gnc_commodity_get_fraction (new_currency),
+                            GNC_HOW_RND_ROUND);
+}
 
 /*
  * Convert a balance from one currency to another.
@@ -2652,24 +3235,10 @@ gnc_pricedb_convert_balance_latest_price(GNCPriceDB *pdb,
         const gnc_commodity *balance_currency,
         const gnc_commodity *new_currency)
 {
-    gnc_numeric new_value;
-
-    if (gnc_numeric_zero_p (balance) ||
-            gnc_commodity_equiv (balance_currency, new_currency))
+    if (gnc_commodity_equiv (balance_currency, new_currency))
         return balance;
-
-    /* Look for a direct price. */
-    new_value = direct_balance_conversion(pdb, balance, balance_currency,
-                                          new_currency, INT64_MAX);
-    if (!gnc_numeric_zero_p(new_value))
-        return new_value;
-
-    /*
-     * no direct price found, try if we find a price in another currency
-     * and convert in two stages
-     */
-    return indirect_balance_conversion(pdb, balance, balance_currency,
-                                       new_currency, INT64_MAX);
+    return convert_amount_at_date (pdb, balance, balance_currency,
+                                   new_currency, INT64_MAX);
 }
 
 gnc_numeric
@@ -2679,24 +3248,10 @@ gnc_pricedb_convert_balance_nearest_price(GNCPriceDB *pdb,
         const gnc_commodity *new_currency,
         time64 t)
 {
-    gnc_numeric new_value;
-
-    if (gnc_numeric_zero_p (balance) ||
-        gnc_commodity_equiv (balance_currency, new_currency))
+    if (gnc_commodity_equiv (balance_currency, new_currency))
         return balance;
-
-    /* Look for a direct price. */
-    new_value = direct_balance_conversion(pdb, balance, balance_currency,
-                                          new_currency, t);
-    if (!gnc_numeric_zero_p(new_value))
-        return new_value;
-
-    /*
-     * no direct price found, try if we find a price in another currency
-     * and convert in two stages
-     */
-    return indirect_balance_conversion(pdb, balance, balance_currency,
-                                       new_currency, t);
+    return convert_amount_at_date (pdb, balance, balance_currency,
+                                   new_currency, t);
 }
 
 
@@ -2714,16 +3269,15 @@ typedef struct
 static void
 pricedb_foreach_pricelist(gpointer key, gpointer val, gpointer user_data)
 {
-    GList *price_list = (GList *) val;
-    GList *node = price_list;
+    GPtrArray *series = (GPtrArray *) val;
     GNCPriceDBForeachData *foreach_data = (GNCPriceDBForeachData *) user_data;
+    guint i;
 
     /* stop traversal when func returns FALSE */
-    while (foreach_data->ok && node)
+    for (i = 0; foreach_data->ok && i < series->len; i++)
     {
-        GNCPrice *p = (GNCPrice *) node->data;
+        GNCPrice *p = g_ptr_array_index (series, i);
         foreach_data->ok = foreach_data->func(p, foreach_data->user_data);
-        node = node->next;
     }
 }
 
@@ -2760,18 +3314,18 @@ unstable_price_traversal(GNCPriceDB *db,
 typedef struct
 {
     gboolean ok;
-    gboolean (*func)(GList *p, gpointer user_data);
+    gboolean (*func)(GPtrArray *series, gpointer user_data);
     gpointer user_data;
 } GNCPriceListForeachData;
 
 static void
 pricedb_pricelist_foreach_pricelist(gpointer key, gpointer val, gpointer user_data)
 {
-    GList *price_list = (GList *) val;
+    GPtrArray *series = (GPtrArray *) val;
     GNCPriceListForeachData *foreach_data = (GNCPriceListForeachData *) user_data;
     if (foreach_data->ok)
     {
-        foreach_data->ok = foreach_data->func(price_list, foreach_data->user_data);
+        foreach_data->ok = foreach_data->func(series, foreach_data->user_data);
     }
 }
 
@@ -2784,7 +3338,7 @@ pricedb_pricelist_foreach_currencies_hash(gpointer key, gpointer val, gpointer u
 
 static gboolean
 pricedb_pricelist_traversal(GNCPriceDB *db,
-                         gboolean (*f)(GList *p, gpointer user_data),
+                         gboolean (*f)(GPtrArray *series, gpointer user_data),
                          gpointer user_data)
 {
     GNCPriceListForeachData foreach_data;
@@ -2856,12 +3410,12 @@ stable_price_traversal(GNCPriceDB *db,
         for (j = price_lists; j; j = j->next)
         {
             HashEntry *pricelist_entry = (HashEntry *) j->data;
-            GList *price_list = (GList *) pricelist_entry->value;
-            GList *node;
+            GPtrArray *series = (GPtrArray *) pricelist_entry->value;
+            guint k;
 
-            for (node = (GList *) price_list; node; node = node->next)
+            for (k = 0; k < series->len; k++)
             {
-                GNCPrice *price = (GNCPrice *) node->data;
+                GNCPrice *price = g_ptr_array_index (series, k);
 
                 /* stop traversal when f returns FALSE */
                 if (FALSE == ok) break;
@@ -3081,16 +3635,13 @@ VoidGNCPriceDBForeachData;
 static void
 void_pricedb_foreach_pricelist(gpointer key, gpointer val, gpointer user_data)
 {
-    GList *price_list = (GList *) val;
-    GList *node = price_list;
+    GPtrArray *series = (GPtrArray *) val;
     VoidGNCPriceDBForeachData *foreach_data = (VoidGNCPriceDBForeachData *) user_data;
+    guint i;
 
-    while (node)
-    {
-        GNCPrice *p = (GNCPrice *) node->data;
-        foreach_data->func(p, foreach_data->user_data);
-        node = node->next;
-    }
+    for (i = 0; i < series->len; i++)
+        foreach_data->func(g_ptr_array_index (series, i),
+                           foreach_data->user_data);
 }
 
 static void
@@ -372,6 +372,23 @@ void gnc_pricedb_set_bulk_update(GNCPriceDB *db, gboolean bulk_update);
  */
 gboolean     gnc_pricedb_add_price(GNCPriceDB *db, GNCPrice *p);
 
+/** @brief Add a batch of prices to the pricedb.
+ *
+ * Applies the same one-price-a-day precedence rules as adding each price
+ * with gnc_pricedb_add_price(), in either direction of a commodity pair,
+ * but each commodity/currency series is merged only once and the pricedb
+ * is committed only once.  Of several prices in the list for the same day
+ * and precedence the last one wins.  The events for the new prices are
+ * delivered together after all of them are in.
+ *
+ * The pricedb takes its own references, so you still own the list and
+ * the prices in it.
+ * @param db The pricedb
+ * @param prices The GNCPrices to add. NULL entries are skipped.
+ * @return The number of prices added.
+ */
+int          gnc_pricedb_add_prices(GNCPriceDB *db, PriceList *prices);
+
 /** @brief Remove a price from the pricedb and unref the price.
  * @param db The Pricedb
  * @param p The price to remove.
@@ -574,6 +591,38 @@ PriceList * gnc_pricedb_lookup_latest_before_any_currency(GNCPriceDB *db,
                                                           Timespec t);
 
 
+/** @brief Retrieve the price for converting one currency to another using
+ * the most recent price between the two, directly or through a third
+ * commodity.
+ * @param pdb The pricedb
+ * @param orig_currency The commodity in which the balance is currently
+ * expressed
+ * @param new_currency The commodity to which the balance should be converted
+ * @return The price to multiply amounts of orig_currency by, 1 if the two
+ * are the same, or gnc_numeric_zero if no price is available.
+ */
+gnc_numeric
+gnc_pricedb_get_latest_price (GNCPriceDB *pdb,
+                              const gnc_commodity *orig_currency,
+                              const gnc_commodity *new_currency);
+
+/** @brief Retrieve the price for converting one currency to another using
+ * the price nearest to the given time, directly or through a third
+ * commodity.
+ * @param pdb The pricedb
+ * @param orig_currency The commodity in which the balance is currently
+ * expressed
+ * @param new_currency The commodity to which the balance should be converted
+ * @param t The time nearest to which price should be used.
+ * @return The price to multiply amounts of orig_currency by, 1 if the two
+ * are the same, or gnc_numeric_zero if no price is available.
+ */
+gnc_numeric
+gnc_pricedb_get_nearest_price (GNCPriceDB *pdb,
+                               const gnc_commodity *orig_currency,
+                               const gnc_commodity *new_currency,
+                               time64 t);
+
 /** @brief Convert a balance from one currency to another using the most recent
  * price between the two.
  * @param pdb The pricedb
@@ -283,6 +283,7 @@ TimeZoneProvider::TimeZoneProvider (const std::string& identifier) :
     if (key_name.empty())
     {
         load_windows_default_tz();
+        build_transitions();
         return;
     }
     std::string subkey = reg_key + key_name;
@@ -302,6 +303,7 @@ TimeZoneProvider::TimeZoneProvider (const std::string& identifier) :
 	this->load_windows_classic_tz (key, names);
     else
 	throw std::invalid_argument ("No data for TZ " + key_name);
+    build_transitions();
 }
 #elif PLATFORM(POSIX)
 using std::to_string;
@@ -708,11 +710,17 @@ TimeZoneProvider::construct(const std::string& tzname)
 TimeZoneProvider::TimeZoneProvider(const std::string& tzname) :  zone_vector {}
 {
     if(construct(tzname))
+    {
+        build_transitions();
         return;
+    }
     DEBUG("%s invalid, trying TZ environment variable.\n", tzname.c_str());
     const char* tz_env = getenv("TZ");
     if(tz_env && construct(tz_env))
+    {
+        build_transitions();
         return;
+    }
     DEBUG("No valid $TZ, resorting to /etc/localtime.\n");
     try
     {
@@ -724,9 +732,84 @@ TimeZoneProvider::TimeZoneProvider(const std::string& tzname) :  zone_vector {}
         TZ_Ptr zone(new PTZ("UTC0"));
         zone_vector.push_back(std::make_pair(max_year, zone));
     }
+    build_transitions();
 }
 #endif
 
+static int64_t
+seconds_since_epoch(const boost::posix_time::ptime& time)
+{
+    static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+    auto since = time - epoch;
+    return since.ticks() / since.ticks_per_second();
+}
+
+/* Each year's zone gives the offset at the start of the year and, if it has
+ * DST, the two transitions during the year. Consecutive entries with the
+ * same offset are merged so that only the real changes are kept.
+ */
+void
+TimeZoneProvider::build_transitions()
+{
+    using boost::gregorian::date;
+    using boost::posix_time::ptime;
+    auto add = [this](int64_t time, int32_t offset, bool is_dst)
+    {
+        if (!transition_vector.empty())
+        {
+            auto& last = transition_vector.back();
+            if (last.offset == offset && last.is_dst == is_dst)
+                return;
+            if (last.time >= time) // A transition right at the new year.
+            {
+                last.offset = offset;
+                last.is_dst = is_dst;
+                return;
+            }
+        }
+        transition_vector.push_back({time, offset, is_dst});
+    };
+
+    transition_vector.clear();
+    for (auto year = min_year; year <= max_year; ++year)
+    {
+        auto zone = get(year);
+        auto start = seconds_since_epoch(ptime(date(year, 1, 1)));
+        int32_t std_off = zone->base_utc_offset().total_seconds();
+        if (!zone->has_dst())
+        {
+            add(start, std_off, false);
+            continue;
+        }
+        int32_t dst_off = std_off + zone->dst_offset().total_seconds();
+        int64_t dst_start, dst_end;
+        try
+        {
+            dst_start = seconds_since_epoch(zone->dst_local_start_time(year)) -
+                std_off;
+            dst_end = seconds_since_epoch(zone->dst_local_end_time(year)) -
+                dst_off;
+        }
+        catch(const std::out_of_range& err) // A rule running past max_year.
+        {
+            add(start, std_off, false);
+            continue;
+        }
+        if (dst_start < dst_end)
+        {
+            add(start, std_off, false);
+            add(dst_start, dst_off, true);
+            add(dst_end, std_off, false);
+        }
+        else // Southern hemisphere, the year starts in DST.
+        {
+            add(start, dst_off, true);
+            add(dst_end, std_off, false);
+            add(dst_start, dst_off, true);
+        }
+    }
+}
+
 
 TZ_Ptr
 TimeZoneProvider::get(int year) const noexcept
@@ -739,3 +822,42 @@ TimeZoneProvider::get(int year) const noexcept
             return zone_vector.front().second;
     return iter->second;
 }
+
+const TZ_Transition&
+TimeZoneProvider::transition(int64_t time) const noexcept
+{
+    auto iter = std::upper_bound(transition_vector.begin(),
+                                 transition_vector.end(), time,
+                                 [](int64_t t, const TZ_Transition& tr)
+                                 { return t < tr.time; });
+    if (iter == transition_vector.begin())
+        return *iter;
+    return *(iter - 1);
+}
+
+bool
+TimeZoneProvider::utc_from_local(int64_t local, int64_t& time) const noexcept
+{
+    auto begin = transition_vector.begin(), end = transition_vector.end();
+    auto iter = std::upper_bound(begin, end, local,
+                                 [](int64_t t, const TZ_Transition& tr)
+                                 { return t < tr.time; });
+    /* Offsets are less than a day and transitions are months apart, so
+     * only the transitions next to the one at local as if it were UTC can
+     * apply.
+     */
+    auto first = iter - begin > 2 ? iter - 2 : begin;
+    auto last = iter == end ? end : iter + 1;
+    unsigned int found = 0;
+    for (auto tr = first; tr != last; ++tr)
+    {
+        auto utc = local - tr->offset;
+        if ((tr == begin || utc >= tr->time) &&
+            (tr + 1 == end || utc < (tr + 1)->time))
+        {
+            time = utc;
+            ++found;
+        }
+    }
+    return found == 1;
+}
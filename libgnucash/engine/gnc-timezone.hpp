@@ -44,6 +44,17 @@ using TZ_Entry = std::pair<int, TZ_Ptr>;
 using TZ_Vector = std::vector<TZ_Entry>;
 using time_zone_names = boost::local_time::time_zone_names;
 
+/* A change in the offset from UTC: From time, in seconds since the epoch UTC,
+ * local time is offset seconds ahead of UTC.
+ */
+struct TZ_Transition
+{
+    int64_t time;
+    int32_t offset;
+    bool is_dst;
+};
+using TZ_Transitions = std::vector<TZ_Transition>;
+
 class TimeZoneProvider
 {
 public:
@@ -55,12 +66,25 @@ public:
     TimeZoneProvider operator=(const TimeZoneProvider&) = delete;
     TimeZoneProvider operator=(const TimeZoneProvider&&) = delete;
     TZ_Ptr get (int year) const noexcept;
+    /** The transition in effect at time, in seconds since the epoch UTC.
+     *  These are worked out from the zones for each year from min_year to
+     *  max_year when the provider is constructed, so this is just a binary
+     *  search.
+     */
+    const TZ_Transition& transition (int64_t time) const noexcept;
+    /** Convert local time, in seconds since the epoch as if it were UTC, to
+     *  UTC.
+     *  @return false if local time was skipped or repeated by a transition.
+     */
+    bool utc_from_local (int64_t local, int64_t& time) const noexcept;
     static const unsigned int min_year; //1400
     static const unsigned int max_year; //9999
 private:
     void parse_file(const std::string& tzname);
     bool construct(const std::string& tzname);
+    void build_transitions();
     TZ_Vector zone_vector;
+    TZ_Transitions transition_vector;
 #if PLATFORM(WINDOWS)
     void load_windows_dynamic_tz(HKEY, time_zone_names);
     void load_windows_classic_tz(HKEY, time_zone_names);
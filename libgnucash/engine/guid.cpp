@@ -88,6 +88,69 @@ GncGUID * guid_convert_create (gnc::GUID const &);
 static gnc::GUID s_null_guid {boost::uuids::uuid { {0}}};
 static GncGUID * s_null_gncguid {guid_convert_create (s_null_guid)};
 
+/* Hex encoding *****************************************************/
+
+/* The value of each hex digit, upper or lower case, and 0x80 for any
+ * other character, so that or-ing together the values of a string's
+ * characters tells whether they were all hex digits. */
+static const unsigned char hex_values[256] =
+{
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+};
+
+static const char hex_digits[] = "0123456789abcdef";
+
+/* Decode the GUID_ENCODING_LENGTH hex digits at str into data, which
+ * is left alone if any of them isn't one. str must have at least that
+ * many characters. */
+static bool
+guid_decode_hex (const char *str, unsigned char *data)
+{
+    auto ustr = reinterpret_cast<const unsigned char*>(str);
+    unsigned char bytes[GUID_DATA_SIZE];
+    unsigned char bad {0};
+
+    for (int i = 0; i < GUID_DATA_SIZE; ++i)
+    {
+        auto hi = hex_values[ustr[2 * i]];
+        auto lo = hex_values[ustr[2 * i + 1]];
+        bad |= hi | lo;
+        bytes[i] = (hi << 4) | lo;
+    }
+    if (bad & 0x80)
+        return false;
+    memcpy (data, bytes, GUID_DATA_SIZE);
+    return true;
+}
+
+/* Write data as GUID_ENCODING_LENGTH lower case hex digits and a null
+ * into str. */
+static void
+guid_encode_hex (const unsigned char *data, char *str)
+{
+    for (int i = 0; i < GUID_DATA_SIZE; ++i)
+    {
+        str[2 * i] = hex_digits[data[i] >> 4];
+        str[2 * i + 1] = hex_digits[data[i] & 0x0f];
+    }
+    str[GUID_ENCODING_LENGTH] = '\0';
+}
+
 /* Memory management routines ***************************************/
 
 /**
@@ -165,9 +228,9 @@ gchar *
 guid_to_string (const GncGUID * guid)
 {
     if (!guid) return nullptr;
-    gnc::GUID temp {*guid};
-    auto temp_str = temp.to_string ();
-    return g_strdup (temp_str.c_str ());
+    auto str = static_cast<gchar*>(g_malloc (GUID_ENCODING_LENGTH + 1));
+    guid_encode_hex (guid->reserved, str);
+    return str;
 }
 
 gchar *
@@ -175,13 +238,8 @@ guid_to_string_buff (const GncGUID * guid, gchar *str)
 {
     if (!str || !guid) return NULL;
 
-    gnc::GUID temp {*guid};
-    auto val = temp.to_string ();
-    /*We need to be sure to copy the terminating null character.
-     * The standard guarantees that std::basic_string::c_str ()
-     * returns with a terminating null character, too.*/
-    std::copy (val.c_str (), val.c_str () + val.size () + 1, str);
-    return str + val.size ();
+    guid_encode_hex (guid->reserved, str);
+    return str + GUID_ENCODING_LENGTH;
 }
 
 gboolean
@@ -189,6 +247,11 @@ string_to_guid (const char * str, GncGUID * guid)
 {
     if (!guid || !str) return false;
 
+    /* Everything we write is plain hex, so try that first and leave
+     * the other forms boost accepts to it. */
+    if (strnlen (str, GUID_ENCODING_LENGTH + 1) == GUID_ENCODING_LENGTH &&
+        guid_decode_hex (str, guid->reserved))
+        return true;
     try
     {
         guid_assign (*guid, gnc::GUID::from_string (str));
@@ -336,17 +399,18 @@ GUID::null_guid () noexcept
 std::string
 GUID::to_string () const noexcept
 {
-    auto const & val = boost::uuids::to_string (implementation);
-    std::string ret;
-    std::for_each (val.begin (), val.end (), [&ret] (char a) {
-        if (a != '-') ret.push_back (a);
-    });
-    return ret;
+    char buff[GUID_ENCODING_LENGTH + 1];
+    guid_encode_hex (implementation.data, buff);
+    return std::string (buff, GUID_ENCODING_LENGTH);
 }
 
 GUID
 GUID::from_string (std::string const & str)
 {
+    boost::uuids::uuid ret;
+    if (str.size () == GUID_ENCODING_LENGTH &&
+        guid_decode_hex (str.c_str (), ret.data))
+        return ret;
     try
     {
         static boost::uuids::string_generator strgen;
@@ -361,6 +425,10 @@ GUID::from_string (std::string const & str)
 bool
 GUID::is_valid_guid (std::string const & str)
 {
+    boost::uuids::uuid ret;
+    if (str.size () == GUID_ENCODING_LENGTH &&
+        guid_decode_hex (str.c_str (), ret.data))
+        return true;
     try
     {
         static boost::uuids::string_generator strgen;
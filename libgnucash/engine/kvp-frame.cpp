@@ -47,12 +47,13 @@ static const char delim = '/';
 
 KvpFrameImpl::KvpFrameImpl(const KvpFrameImpl & rhs) noexcept
 {
+    m_valuemap.reserve(rhs.m_valuemap.size());
     std::for_each(rhs.m_valuemap.begin(), rhs.m_valuemap.end(),
         [this](const map_type::value_type & a)
         {
             auto key = static_cast<char *>(qof_string_cache_insert(a.first));
             auto val = new KvpValueImpl(*a.second);
-            this->m_valuemap.insert({key,val});
+            this->m_valuemap.emplace_back(key, val);
         }
     );
 }
@@ -69,89 +70,107 @@ KvpFrameImpl::~KvpFrameImpl() noexcept
 }
 
 KvpFrame *
-KvpFrame::get_child_frame_or_nullptr (Path const & path) noexcept
+KvpFrame::get_child_frame_or_nullptr (Path::const_iterator begin,
+                                      Path::const_iterator end) noexcept
 {
-    if (!path.size ())
-        return this;
-    auto key = path.front ();
-    if (m_valuemap.find (key.c_str ()) == m_valuemap.end ())
-        return nullptr;
-    auto child = m_valuemap.at (key.c_str ())->get <KvpFrame *> ();
-    Path send;
-    std::copy (path.begin () + 1, path.end (), std::back_inserter (send));
-    return child->get_child_frame_or_nullptr (send);
+    KvpFrame * frame {this};
+    for (; frame && begin != end; ++begin)
+    {
+        auto spot = frame->find (begin->c_str ());
+        if (spot == frame->m_valuemap.end ())
+            return nullptr;
+        frame = spot->second->get <KvpFrame *> ();
+    }
+    return frame;
 }
 
 KvpFrame *
-KvpFrame::get_child_frame_or_create (Path const & path) noexcept
+KvpFrame::get_child_frame_or_create (Path::const_iterator begin,
+                                     Path::const_iterator end) noexcept
 {
-    if (!path.size ())
-        return this;
-    auto key = path.front ();
-    auto spot = m_valuemap.find (key.c_str ());
-    if (spot == m_valuemap.end () || spot->second->get_type () != KvpValue::Type::FRAME)
-        delete set_impl (key.c_str (), new KvpValue {new KvpFrame});
-    Path send;
-    std::copy (path.begin () + 1, path.end (), std::back_inserter (send));
-    auto child_val = m_valuemap.at (key.c_str ());
-    auto child = child_val->get <KvpFrame *> ();
-    return child->get_child_frame_or_create (send);
+    KvpFrame * frame {this};
+    for (; begin != end; ++begin)
+    {
+        auto key = begin->c_str ();
+        auto spot = frame->find (key);
+        if (spot == frame->m_valuemap.end () ||
+            spot->second->get_type () != KvpValue::Type::FRAME)
+        {
+            auto child = new KvpFrame;
+            delete frame->set_impl (key, new KvpValue {child});
+            frame = child;
+        }
+        else
+            frame = spot->second->get <KvpFrame *> ();
+    }
+    return frame;
 }
 
 
 KvpValue *
-KvpFrame::set_impl (std::string const & key, KvpValue * value) noexcept
+KvpFrame::set_impl (const char * key, KvpValue * value) noexcept
 {
     KvpValue * ret {};
-    auto spot = m_valuemap.find (key.c_str ());
-    if (spot != m_valuemap.end ())
+    auto spot = m_valuemap.begin () + (lower_bound (key) - m_valuemap.cbegin ());
+    auto found = spot != m_valuemap.end () &&
+        (spot->first == key || std::strcmp (spot->first, key) == 0);
+    if (found)
     {
-        qof_string_cache_remove (spot->first);
         ret = spot->second;
+        if (value)
+        {
+            spot->second = value;
+            return ret;
+        }
+        qof_string_cache_remove (spot->first);
         m_valuemap.erase (spot);
     }
-    if (value)
+    else if (value)
     {
-        auto cachedkey = static_cast <char const *> (qof_string_cache_insert (key.c_str ()));
-        m_valuemap.emplace (cachedkey, value);
+        auto cachedkey = static_cast <char const *> (qof_string_cache_insert (key));
+        m_valuemap.emplace (spot, cachedkey, value);
     }
     return ret;
 }
 
 KvpValue *
-KvpFrameImpl::set (Path path, KvpValue* value) noexcept
+KvpFrameImpl::set (Path const & path, KvpValue* value) noexcept
 {
     if (path.empty())
         return nullptr;
-    auto key = path.back ();
-    path.pop_back ();
-    auto target = get_child_frame_or_nullptr (path);
+    auto target = get_child_frame_or_nullptr (path.begin (), path.end () - 1);
     if (!target)
         return nullptr;
-    return target->set_impl (key, value);
+    return target->set_impl (path.back ().c_str (), value);
 }
 
 KvpValue *
-KvpFrameImpl::set_path (Path path, KvpValue* value) noexcept
+KvpFrameImpl::set_path (Path const & path, KvpValue* value) noexcept
 {
-    auto key = path.back();
-    path.pop_back();
-    auto target = get_child_frame_or_create (path);
+    if (path.empty())
+        return nullptr;
+    auto target = get_child_frame_or_create (path.begin (), path.end () - 1);
     if (!target)
         return nullptr;
-    return target->set_impl (key, value);
+    return target->set_impl (path.back ().c_str (), value);
 }
 
 KvpValue *
-KvpFrameImpl::get_slot (Path path) noexcept
+KvpFrameImpl::get_slot (Path const & path) noexcept
 {
-    auto key = path.back();
-    path.pop_back();
-    auto target = get_child_frame_or_nullptr (path);
+    if (path.empty())
+        return nullptr;
+    auto target = get_child_frame_or_nullptr (path.begin (), path.end () - 1);
     if (!target)
         return nullptr;
-    auto spot = target->m_valuemap.find (key.c_str ());
-    if (spot != target->m_valuemap.end ())
+    return target->get_slot (path.back ().c_str ());
+}
+
+KvpValue *
+KvpFrameImpl::get_slot (const char * key) noexcept
+{
+    auto spot = find (key);
+    if (spot != m_valuemap.end ())
         return spot->second;
     return nullptr;
 }
@@ -218,7 +237,7 @@ int compare(const KvpFrameImpl & one, const KvpFrameImpl & two) noexcept
 {
     for (const auto & a : one.m_valuemap)
     {
-        auto otherspot = two.m_valuemap.find(a.first);
+        auto otherspot = two.find(a.first);
         if (otherspot == two.m_valuemap.end())
         {
             return 1;
@@ -108,17 +108,10 @@ using KvpEntry = std::pair <std::vector <std::string>, KvpValue*>;
  */
 struct KvpFrameImpl
 {
-    class cstring_comparer
-    {
-    public:
-	/* Returns true if one is less than two. */
-	bool operator()(const char * one, const char * two) const
-	    {
-		auto ret = std::strcmp(one, two) < 0;
-		return ret;
-	    }
-    };
-    using map_type = std::map<const char *, KvpValue*, cstring_comparer>;
+    /* The slots, sorted by strcmp on their keys.  The keys are in the
+     * qof_string_cache.  Most frames hold only a few slots, and a vector
+     * finds those faster than a tree and with fewer allocations. */
+    using map_type = std::vector<std::pair<const char *, KvpValue*>>;
 
     public:
     KvpFrameImpl() noexcept {};
@@ -156,7 +149,7 @@ struct KvpFrameImpl
      * @param newvalue: The value to set at key.
      * @return The old value if there was one or nullptr.
      */
-    KvpValue* set(Path path, KvpValue* newvalue) noexcept;
+    KvpValue* set(Path const & path, KvpValue* newvalue) noexcept;
      /**
      * Set the value with the key in a subframe following the keys in path,
      * replacing and returning the old value if it exists or nullptr if it
@@ -168,7 +161,7 @@ struct KvpFrameImpl
      * @param newvalue: The value to set at key.
      * @return The old value if there was one or nullptr.
      */
-    KvpValue* set_path(Path path, KvpValue* newvalue) noexcept;
+    KvpValue* set_path(Path const & path, KvpValue* newvalue) noexcept;
     /**
      * Make a string representation of the frame. Mostly useful for debugging.
      * @return A std::string representing the frame and all its children.
@@ -191,7 +184,14 @@ struct KvpFrameImpl
      * @param path: Path of keys leading to the desired value.
      * @return The value at the key or nullptr.
      */
-    KvpValue* get_slot(Path keys) noexcept;
+    KvpValue* get_slot(Path const & keys) noexcept;
+
+    /** Get the value for key in the immediate frame or nullptr if it doesn't
+     * exist. Unlike the Path version this doesn't copy the key.
+     * @param key: The key of the desired value.
+     * @return The value at the key or nullptr.
+     */
+    KvpValue* get_slot(const char * key) noexcept;
 
     /** The function should be of the form:
      * <anything> func (char const *, KvpValue *, data_type &);
@@ -229,44 +229,57 @@ struct KvpFrameImpl
     private:
     map_type m_valuemap;
 
-    KvpFrame * get_child_frame_or_nullptr (Path const &) noexcept;
-    KvpFrame * get_child_frame_or_create (Path const &) noexcept;
+    map_type::const_iterator lower_bound (const char *) const noexcept;
+    map_type::const_iterator find (const char *) const noexcept;
+    KvpFrame * get_child_frame_or_nullptr (Path::const_iterator,
+                                           Path::const_iterator) noexcept;
+    KvpFrame * get_child_frame_or_create (Path::const_iterator,
+                                          Path::const_iterator) noexcept;
     void flatten_kvp_impl(std::vector <std::string>, std::vector <KvpEntry> &) const noexcept;
-    KvpValue * set_impl (std::string const &, KvpValue *) noexcept;
+    KvpValue * set_impl (const char *, KvpValue *) noexcept;
 };
 
+inline KvpFrameImpl::map_type::const_iterator
+KvpFrameImpl::lower_bound (const char * key) const noexcept
+{
+    return std::lower_bound (m_valuemap.begin(), m_valuemap.end(), key,
+        [](const map_type::value_type & a, const char * key)
+        {
+            return a.first != key && std::strcmp (a.first, key) < 0;
+        });
+}
+
+/* Keys passed in from the string cache match on the pointer alone. */
+inline KvpFrameImpl::map_type::const_iterator
+KvpFrameImpl::find (const char * key) const noexcept
+{
+    auto spot = lower_bound (key);
+    if (spot != m_valuemap.end() &&
+        (spot->first == key || std::strcmp (spot->first, key) == 0))
+        return spot;
+    return m_valuemap.end();
+}
+
+/* The keys sharing a prefix are all together, starting where the prefix
+ * itself would go. */
 template<typename func_type>
 void KvpFrame::for_each_slot_prefix(std::string const & prefix,
         func_type const & func) const noexcept
 {
-    std::for_each (m_valuemap.begin(), m_valuemap.end(),
-        [&prefix,&func](const KvpFrameImpl::map_type::value_type & a)
-        {
-            std::string temp_key {a.first};
-            if (temp_key.size() < prefix.size())
-                return;
-            /* Testing for prefix matching */
-            if (std::mismatch(prefix.begin(), prefix.end(), temp_key.begin()).first == prefix.end())
-                func (a.first, a.second);
-        }
-    );
+    for (auto spot = lower_bound (prefix.c_str()); spot != m_valuemap.end() &&
+             std::strncmp (spot->first, prefix.c_str(), prefix.size()) == 0;
+         ++spot)
+        func (spot->first, spot->second);
 }
 
 template<typename func_type, typename data_type>
 void KvpFrame::for_each_slot_prefix(std::string const & prefix,
         func_type const & func, data_type & data) const noexcept
 {
-    std::for_each (m_valuemap.begin(), m_valuemap.end(),
-        [&prefix,&func,&data](const KvpFrameImpl::map_type::value_type & a)
-        {
-            std::string temp_key {a.first};
-            if (temp_key.size() < prefix.size())
-                return;
-            /* Testing for prefix matching */
-            if (std::mismatch(prefix.begin(), prefix.end(), temp_key.begin()).first == prefix.end())
-                func (a.first, a.second, data);
-        }
-    );
+    for (auto spot = lower_bound (prefix.c_str()); spot != m_valuemap.end() &&
+             std::strncmp (spot->first, prefix.c_str(), prefix.size()) == 0;
+         ++spot)
+        func (spot->first, spot->second, data);
 }
 
 template <typename func_type>
@@ -32,35 +32,105 @@ extern "C"
 
 #include <ctype.h>
 #include <glib.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include "qof.h"
 }
 
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
 /* Uncomment if you need to log anything.
 static QofLogModule log_module = QOF_MOD_UTIL;
 */
 /* =================================================================== */
 /* The QOF string cache                                                */
 /*                                                                     */
-/* The cache is a GHashTable where a copy of the string is the key,    */
-/* and a ref count is the value                                        */
+/* The cache is split into shards by the strings' hashes, each with    */
+/* its own lock, so that threads interning different strings seldom    */
+/* wait on one another. Each string is stored after its reference      */
+/* count in a single allocation, so the cached char* is the handle and */
+/* stays put for as long as it's referenced.                           */
 /* =================================================================== */
 
-static GHashTable* qof_string_cache = NULL;
+#define STRING_CACHE_SHARDS 32
+
+namespace
+{
+
+struct CacheEntry
+{
+    std::atomic<unsigned> refcount;
+    size_t length;
+
+    char* str () { return reinterpret_cast<char*>(this + 1); }
+};
+
+/* A string that isn't necessarily in the cache, with its hash. */
+struct CacheKey
+{
+    const char* str;
+    size_t length;
+    size_t hash;
+
+    bool operator==(const CacheKey& other) const
+    {
+        return length == other.length && memcmp (str, other.str, length) == 0;
+    }
+};
+
+struct CacheKeyHash
+{
+    size_t operator()(const CacheKey& key) const { return key.hash; }
+};
+
+using CacheMap = std::unordered_map<CacheKey, CacheEntry*, CacheKeyHash>;
+
+struct CacheShard
+{
+    std::mutex mutex;
+    CacheMap map;
+};
+
+}
+
+static CacheShard*
+qof_get_string_cache (void)
+{
+    static CacheShard shards[STRING_CACHE_SHARDS];
+    return shards;
+}
 
-static GHashTable*
-qof_get_string_cache(void)
+/* FNV-1a, which is quick for the short strings we usually see. */
+static CacheKey
+make_key (const char* str)
 {
-    if (!qof_string_cache)
+    uint64_t hash = UINT64_C(14695981039346656037);
+    const char* c = str;
+
+    for (; *c; ++c)
     {
-        qof_string_cache = g_hash_table_new_full(
-                               g_str_hash,               /* hash_func          */
-                               g_str_equal,              /* key_equal_func     */
-                               g_free,                   /* key_destroy_func   */
-                               g_free);                  /* value_destroy_func */
+        hash ^= static_cast<unsigned char>(*c);
+        hash *= UINT64_C(1099511628211);
     }
-    return qof_string_cache;
+    return {str, static_cast<size_t>(c - str),
+            static_cast<size_t>(hash ^ (hash >> 32))};
+}
+
+static CacheShard&
+shard_for (const CacheKey& key)
+{
+    /* The maps' buckets depend mostly on the low bits. */
+    return qof_get_string_cache ()[(key.hash >> 16) % STRING_CACHE_SHARDS];
+}
+
+static CacheEntry*
+entry_of (const char* str)
+{
+    return reinterpret_cast<CacheEntry*>(const_cast<char*>(str)) - 1;
 }
 
 void
@@ -72,11 +142,17 @@ qof_string_cache_init(void)
 void
 qof_string_cache_destroy (void)
 {
-    if (qof_string_cache)
+    auto shards = qof_get_string_cache ();
+    for (int i = 0; i < STRING_CACHE_SHARDS; ++i)
     {
-        g_hash_table_destroy(qof_string_cache);
+        std::lock_guard<std::mutex> lock (shards[i].mutex);
+        for (auto& item : shards[i].map)
+        {
+            item.second->~CacheEntry ();
+            g_free (item.second);
+        }
+        shards[i].map.clear ();
     }
-    qof_string_cache = NULL;
 }
 
 /* If the key exists in the cache, check the refcount.  If 1, just
@@ -86,19 +162,18 @@ qof_string_cache_remove(const char * key)
 {
     if (key)
     {
-        GHashTable* cache = qof_get_string_cache();
-        gpointer value;
-        gpointer cache_key;
-        if (g_hash_table_lookup_extended(cache, key, &cache_key, &value))
+        auto cache_key = make_key (key);
+        auto& shard = shard_for (cache_key);
+        std::lock_guard<std::mutex> lock (shard.mutex);
+        auto iter = shard.map.find (cache_key);
+        if (iter != shard.map.end ())
         {
-            guint* refcount = (guint*)value;
-            if (*refcount == 1)
-            {
-                g_hash_table_remove(cache, key);
-            }
-            else
+            auto entry = iter->second;
+            if (entry->refcount.fetch_sub (1, std::memory_order_acq_rel) == 1)
             {
-                --(*refcount);
+                shard.map.erase (iter);
+                entry->~CacheEntry ();
+                g_free (entry);
             }
         }
     }
@@ -111,27 +186,39 @@ qof_string_cache_insert(const char * key)
 {
     if (key)
     {
-        GHashTable* cache = qof_get_string_cache();
-        gpointer value;
-        gpointer cache_key;
-        if (g_hash_table_lookup_extended(cache, key, &cache_key, &value))
+        auto cache_key = make_key (key);
+        auto& shard = shard_for (cache_key);
+        std::lock_guard<std::mutex> lock (shard.mutex);
+        auto iter = shard.map.find (cache_key);
+        if (iter != shard.map.end ())
         {
-            guint* refcount = (guint*)value;
-            ++(*refcount);
-            return static_cast <char *> (cache_key);
+            iter->second->refcount.fetch_add (1, std::memory_order_relaxed);
+            return iter->second->str ();
         }
         else
         {
-            gpointer new_key = g_strdup(static_cast<const char*>(key));
-            guint* refcount = static_cast<unsigned int*>(g_malloc(sizeof(guint)));
-            *refcount = 1;
-            g_hash_table_insert(cache, new_key, refcount);
-            return static_cast <char *> (new_key);
+            auto mem = g_malloc (sizeof (CacheEntry) + cache_key.length + 1);
+            auto entry = new (mem) CacheEntry {{1}, cache_key.length};
+            memcpy (entry->str (), key, cache_key.length + 1);
+            cache_key.str = entry->str ();
+            shard.map.emplace (cache_key, entry);
+            return entry->str ();
         }
     }
     return NULL;
 }
 
+/* The caller already holds a reference, so the entry can't go away
+ * and there's no need to find it or to lock its shard. */
+char *
+qof_string_cache_ref(const char * str)
+{
+    if (!str)
+        return NULL;
+    entry_of (str)->refcount.fetch_add (1, std::memory_order_relaxed);
+    return const_cast<char*>(str);
+}
+
 char *
 qof_string_cache_replace(char const * dst, char const * src)
 {
@@ -64,7 +64,12 @@ extern "C"
  * function.
  *
  * Note that all the work is done when inserting or removing.  Once
- * cached the strings are just plain C strings.
+ * cached the strings are just plain C strings.  While a string is
+ * referenced, inserting an equal string returns the same pointer, so
+ * cached strings can be compared by address.
+ *
+ * The cache may be used from several threads at once; only
+ * qof_string_cache_destroy must not race with anything else.
  *
  * The string cache is demand-created on first use.
  *
@@ -86,6 +91,16 @@ void qof_string_cache_remove(const char * key);
 */
 char * qof_string_cache_insert(const char * key);
 
+/** Take another reference to a string returned by
+ * qof_string_cache_insert, without looking it up. Release it with
+ * qof_string_cache_remove as usual.
+ *
+ * @param str A cached string to which the caller holds a reference.
+ *
+ * @return str
+ */
+char * qof_string_cache_ref(const char * str);
+
 /** Same as CACHE_REPLACE below, but safe to call from C++.
  */
 char * qof_string_cache_replace(const char * dst, const char * src);
@@ -34,9 +34,17 @@ typedef struct
     gpointer user_data;
 
     gint handler_id;
+
+    /* Only for handlers registered for one type of object */
+    QofEventId event_mask;
 } HandlerInfo;
 
 /* generates an event even when events are suspended! */
 void qof_event_force (QofInstance *entity, QofEventId event_id, gpointer event_data);
 
+/* The number of events generated so far for objects of the given
+ * type, counting those generated while events were suspended.  If it
+ * hasn't changed, no object of that type has announced a change. */
+gsize qof_event_get_generation (QofIdTypeConst type);
+
 #endif
@@ -31,42 +31,75 @@ extern "C"
 #include "qof.h"
 #include "qofevent-p.h"
 
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 /* Static Variables ************************************************/
 static guint   suspend_counter   = 0;
 static gint    next_handler_id   = 1;
 static guint   handler_run_level = 0;
 static guint   pending_deletes   = 0;
 static GList   *handlers  =   NULL;
+static GHashTable *generations = NULL;
+
+/* Handlers registered for one type, in GPtrArrays by type */
+static GHashTable *type_handlers = NULL;
+
+/* The events held back by a batch, as each object and the events it
+ * generated or'ed together, and where to find each object. */
+static guint   batch_level = 0;
+static std::vector<std::pair<QofInstance*, QofEventId>> batch_events;
+static std::unordered_map<QofInstance*, size_t> batch_index;
 
 /* This static indicates the debugging module that this .o belongs to.  */
 static QofLogModule log_module = QOF_MOD_ENGINE;
 
 /* Implementations *************************************************/
 
+static gboolean
+type_handler_id_in_use (gint handler_id)
+{
+    GHashTableIter iter;
+    gpointer value;
+
+    if (!type_handlers)
+        return FALSE;
+
+    g_hash_table_iter_init (&iter, type_handlers);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+        GPtrArray *array = static_cast<GPtrArray*>(value);
+
+        for (guint i = 0; i < array->len; i++)
+            if (static_cast<HandlerInfo*>(g_ptr_array_index (array, i))->
+                handler_id == handler_id)
+                return TRUE;
+    }
+    return FALSE;
+}
+
+static gboolean
+handler_id_in_use (gint handler_id)
+{
+    GList *node;
+
+    for (node = handlers; node; node = node->next)
+        if (static_cast<HandlerInfo*>(node->data)->handler_id == handler_id)
+            return TRUE;
+    return type_handler_id_in_use (handler_id);
+}
+
 static gint
 find_next_handler_id(void)
 {
-    HandlerInfo *hi;
     gint handler_id;
-    GList *node;
 
     /* look for a free handler id */
     handler_id = next_handler_id;
-    node = handlers;
-
-    while (node)
-    {
-        hi = static_cast<HandlerInfo*>(node->data);
+    while (handler_id_in_use (handler_id))
+        handler_id++;
 
-        if (hi->handler_id == handler_id)
-        {
-            handler_id++;
-            node = handlers;
-            continue;
-        }
-
-        node = node->next;
-    }
     /* Update id for next registration */
     next_handler_id = handler_id + 1;
     return handler_id;
@@ -102,6 +135,120 @@ qof_event_register_handler (QofEventHandler handler, gpointer user_data)
     return handler_id;
 }
 
+gint
+qof_event_register_type_handler (QofIdTypeConst obj_type,
+                                 QofEventId event_mask,
+                                 QofEventHandler handler,
+                                 gpointer user_data)
+{
+    HandlerInfo *hi;
+    GPtrArray *array;
+
+    ENTER ("(type=%s, mask=%x, handler=%p, data=%p)", obj_type, event_mask,
+           handler, user_data);
+
+    /* sanity check */
+    if (!obj_type || !handler)
+    {
+        PERR ("no type or handler specified");
+        return 0;
+    }
+
+    hi = g_new0 (HandlerInfo, 1);
+    hi->handler = handler;
+    hi->user_data = user_data;
+    hi->handler_id = find_next_handler_id();
+    hi->event_mask = event_mask;
+
+    if (!type_handlers)
+        type_handlers = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                               (GDestroyNotify)g_ptr_array_unref);
+    array = static_cast<GPtrArray*>(g_hash_table_lookup (type_handlers,
+                                                         obj_type));
+    if (!array)
+    {
+        array = g_ptr_array_new ();
+        g_hash_table_insert (type_handlers, g_strdup (obj_type), array);
+    }
+    g_ptr_array_add (array, hi);
+
+    LEAVE ("(handler=%p, data=%p) handler_id=%d", handler, user_data,
+           hi->handler_id);
+    return hi->handler_id;
+}
+
+/* Unregister a handler registered for one type, in the same way as
+ * qof_event_unregister_handler does the others. */
+static gboolean
+unregister_type_handler (gint handler_id)
+{
+    GHashTableIter iter;
+    gpointer value;
+
+    if (!type_handlers)
+        return FALSE;
+
+    g_hash_table_iter_init (&iter, type_handlers);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+        GPtrArray *array = static_cast<GPtrArray*>(value);
+
+        for (guint i = 0; i < array->len; i++)
+        {
+            HandlerInfo *hi = static_cast<HandlerInfo*>
+                (g_ptr_array_index (array, i));
+
+            if (hi->handler_id != handler_id)
+                continue;
+
+            if (hi->handler)
+                LEAVE ("(handler_id=%d) handler=%p data=%p", handler_id,
+                       hi->handler, hi->user_data);
+            hi->handler = NULL;
+
+            if (handler_run_level == 0)
+            {
+                g_ptr_array_remove_index (array, i);
+                g_free (hi);
+            }
+            else
+            {
+                pending_deletes++;
+            }
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void
+delete_pending_type_handlers (void)
+{
+    GHashTableIter iter;
+    gpointer value;
+
+    if (!type_handlers)
+        return;
+
+    g_hash_table_iter_init (&iter, type_handlers);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+        GPtrArray *array = static_cast<GPtrArray*>(value);
+
+        for (guint i = array->len; i-- > 0;)
+        {
+            HandlerInfo *hi = static_cast<HandlerInfo*>
+                (g_ptr_array_index (array, i));
+
+            if (hi->handler == NULL)
+            {
+                g_ptr_array_remove_index (array, i);
+                g_free (hi);
+            }
+        }
+    }
+}
+
 void
 qof_event_unregister_handler (gint handler_id)
 {
@@ -141,6 +288,9 @@ qof_event_unregister_handler (gint handler_id)
         return;
     }
 
+    if (unregister_type_handler (handler_id))
+        return;
+
     PERR ("no such handler: %d", handler_id);
 }
 
@@ -198,6 +348,28 @@ qof_event_generate_internal (QofInstance *entity, QofEventId event_id,
             hi->handler (entity, event_id, hi->user_data, event_data);
         }
     }
+
+    /* Then the ones for this type and event.  Like the list above,
+     * they're walked from the newest, and any registered meanwhile
+     * are left out. */
+    if (type_handlers && entity->e_type)
+    {
+        GPtrArray *array = static_cast<GPtrArray*>
+            (g_hash_table_lookup (type_handlers, entity->e_type));
+
+        for (guint i = array ? array->len : 0; i-- > 0;)
+        {
+            HandlerInfo *hi = static_cast<HandlerInfo*>
+                (g_ptr_array_index (array, i));
+
+            if (hi->handler && (hi->event_mask & event_id))
+            {
+                PINFO("id=%d hi=%p han=%p data=%p", hi->handler_id, hi,
+                      hi->handler, event_data);
+                hi->handler (entity, event_id, hi->user_data, event_data);
+            }
+        }
+    }
     handler_run_level--;
 
     /* If we're the outermost event runner and we have pending deletes
@@ -217,16 +389,104 @@ qof_event_generate_internal (QofInstance *entity, QofEventId event_id,
                 g_free (hi);
             }
         }
+        delete_pending_type_handlers ();
         pending_deletes = 0;
     }
 }
 
+/* Forget the events a batch held back for the entity, returning them. */
+static QofEventId
+qof_event_drop_entity (QofInstance *entity)
+{
+    auto found = batch_index.find (entity);
+    QofEventId events;
+
+    if (found == batch_index.end ())
+        return QOF_EVENT_NONE;
+
+    events = batch_events[found->second].second;
+    batch_events[found->second].first = NULL;
+    batch_index.erase (found);
+    return events;
+}
+
+/* Deliver the events a batch held back for the entity, one for each
+ * bit, and forget them. */
+static void
+qof_event_flush_entity (QofInstance *entity)
+{
+    QofEventId events = qof_event_drop_entity (entity);
+
+    for (guint bit = 0; bit < sizeof (QofEventId) * 8; bit++)
+        if (events & QOF_MAKE_EVENT (bit))
+            qof_event_generate_internal (entity, QOF_MAKE_EVENT (bit), NULL);
+}
+
+void
+qof_event_begin_batch (void)
+{
+    batch_level++;
+}
+
+void
+qof_event_end_batch (void)
+{
+    if (batch_level == 0)
+    {
+        PERR ("batch level underflow");
+        return;
+    }
+    if (--batch_level)
+        return;
+
+    /* A handler may destroy an object further on, which then flushes
+     * and clears its own entry, so walk by index. */
+    for (size_t i = 0; i < batch_events.size (); i++)
+        if (batch_events[i].first)
+            qof_event_flush_entity (batch_events[i].first);
+    batch_events.clear ();
+    batch_index.clear ();
+}
+
+static void
+qof_event_count (QofInstance *entity, QofEventId event_id)
+{
+    gsize *count;
+
+    if (event_id == QOF_EVENT_NONE || !entity->e_type)
+        return;
+
+    if (!generations)
+        generations = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                             g_free, g_free);
+    count = static_cast<gsize*>(g_hash_table_lookup (generations,
+                                                     entity->e_type));
+    if (!count)
+    {
+        count = g_new0 (gsize, 1);
+        g_hash_table_insert (generations, g_strdup (entity->e_type), count);
+    }
+    (*count)++;
+}
+
+gsize
+qof_event_get_generation (QofIdTypeConst type)
+{
+    gsize *count;
+
+    if (!type || !generations)
+        return 0;
+    count = static_cast<gsize*>(g_hash_table_lookup (generations, type));
+    return count ? *count : 0;
+}
+
 void
 qof_event_force (QofInstance *entity, QofEventId event_id, gpointer event_data)
 {
     if (!entity)
         return;
 
+    qof_event_count (entity, event_id);
     qof_event_generate_internal (entity, event_id, event_data);
 }
 
@@ -236,9 +496,42 @@ qof_event_gen (QofInstance *entity, QofEventId event_id, gpointer event_data)
     if (!entity)
         return;
 
+    qof_event_count (entity, event_id);
+
     if (suspend_counter)
+    {
+        /* Nothing is delivered while suspended, but don't hold on to
+         * an object that's going away. */
+        if (event_id == QOF_EVENT_DESTROY && !batch_index.empty ())
+            qof_event_drop_entity (entity);
         return;
+    }
+
+    /* Deliver what was held back for an object that's going away
+     * before it goes. */
+    if (event_id == QOF_EVENT_DESTROY && !batch_index.empty ())
+        qof_event_flush_entity (entity);
+
+    if (batch_level && !event_data && event_id != QOF_EVENT_DESTROY &&
+        event_id != QOF_EVENT_NONE)
+    {
+        auto found = batch_index.find (entity);
+
+        if (found != batch_index.end ())
+        {
+            batch_events[found->second].second |= event_id;
+        }
+        else
+        {
+            batch_index.emplace (entity, batch_events.size ());
+            batch_events.emplace_back (entity, event_id);
+        }
+        return;
+    }
 
+    /* Events with data go out at once and leave the object's held
+     * events held, so that an account sending a MODIFY with each
+     * ITEM_ADDED still sends one MODIFY for the whole batch. */
     qof_event_generate_internal (entity, event_id, event_data);
 }
 
@@ -104,6 +104,25 @@ gint qof_event_register_handler (QofEventHandler handler, gpointer handler_data)
  */
 void qof_event_unregister_handler (gint handler_id);
 
+/** \brief Register a handler for some events for one type of object.
+ *
+ * The handler is only invoked for objects whose type is obj_type and
+ * for events in event_mask, so it doesn't have to check for them
+ * itself, and the other events cost it nothing.  Unregister it with
+ * qof_event_unregister_handler.
+ *
+ * @param obj_type:  the type of object the handler wants events for
+ * @param event_mask:  the events it wants, or'ed together
+ * @param handler:   handler to register
+ * @param handler_data: data provided when handler is invoked
+ *
+ * @return id identifying handler
+ */
+gint qof_event_register_type_handler (QofIdTypeConst obj_type,
+                                      QofEventId event_mask,
+                                      QofEventHandler handler,
+                                      gpointer handler_data);
+
 /** \brief Invoke all registered event handlers using the given arguments.
 
    Certain default events are used by QOF:
@@ -139,6 +158,25 @@ void qof_event_suspend (void);
 /** Resume engine event generation. */
 void qof_event_resume (void);
 
+/** \brief Start collecting events instead of invoking the handlers.
+ *
+ *   Until the matching qof_event_end_batch, events without event data
+ *   are held back and merged by object, so that an object changed many
+ *   times by a bulk operation invokes the handlers once for each kind
+ *   of event.  Events with event data, such as those for adding and
+ *   removing an item, are still delivered at once, and so may arrive
+ *   before held-back events that were generated ahead of them.
+ *   QOF_EVENT_DESTROY is delivered at once too, after the held-back
+ *   events for the same object.  While events are suspended a
+ *   destroyed object's held-back events are dropped.  Batches nest.
+ */
+void qof_event_begin_batch (void);
+
+/** Deliver the events collected since the outermost
+ *  qof_event_begin_batch, one for each object and kind of event, in
+ *  the order the objects first generated them. */
+void qof_event_end_batch (void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,14 +33,152 @@ extern "C"
 #include "qofid-p.h"
 #include "qofinstance-p.h"
 
+#include <cstdint>
+#include <vector>
+
 static QofLogModule log_module = QOF_MOD_ENGINE;
 
+/* The entities of a collection, kept in one array and found by linear
+ * probing from their GUID's hash.  Each slot holds a copy of the GUID,
+ * so a lookup only has to read the array. */
+class EntityTable
+{
+public:
+    QofInstance *lookup (const GncGUID *guid) const noexcept;
+    void insert (const GncGUID *guid, QofInstance *ent);
+    void remove (const GncGUID *guid) noexcept;
+    void reserve (size_t count);
+    size_t size () const noexcept { return m_count; }
+    std::vector<QofInstance*> values () const;
+
+private:
+    struct Slot
+    {
+        GncGUID guid;
+        QofInstance *ent;       /* NULL if the slot is empty */
+    };
+
+    size_t home (const GncGUID *guid) const noexcept;
+    size_t find (const GncGUID *guid) const noexcept;
+    void resize (size_t capacity);
+
+    std::vector<Slot> m_slots;  /* a power of two long, or empty */
+    size_t m_count = 0;
+};
+
+/* GUIDs are random, so folding their two halves together is enough;
+ * the multiplication just spreads any that aren't over the table. */
+size_t
+EntityTable::home (const GncGUID *guid) const noexcept
+{
+    uint64_t lo, hi;
+
+    memcpy (&lo, guid->reserved, sizeof lo);
+    memcpy (&hi, guid->reserved + sizeof lo, sizeof hi);
+    auto hash = (lo ^ hi) * UINT64_C(0x9e3779b97f4a7c15);
+    return (hash ^ (hash >> 32)) & (m_slots.size() - 1);
+}
+
+/* The slot holding guid, or the empty slot where it would go. */
+size_t
+EntityTable::find (const GncGUID *guid) const noexcept
+{
+    auto mask = m_slots.size() - 1;
+    auto pos = home (guid);
+
+    while (m_slots[pos].ent && !guid_equal (&m_slots[pos].guid, guid))
+        pos = (pos + 1) & mask;
+    return pos;
+}
+
+void
+EntityTable::resize (size_t capacity)
+{
+    std::vector<Slot> old (capacity, Slot {{{0}}, nullptr});
+
+    m_slots.swap (old);
+    for (auto& slot : old)
+        if (slot.ent)
+            m_slots[find (&slot.guid)] = slot;
+}
+
+/* Keep the table at most three quarters full. */
+void
+EntityTable::reserve (size_t count)
+{
+    size_t capacity = m_slots.empty() ? 16 : m_slots.size();
+
+    while (capacity - capacity / 4 < count)
+        capacity *= 2;
+    if (capacity != m_slots.size())
+        resize (capacity);
+}
+
+QofInstance *
+EntityTable::lookup (const GncGUID *guid) const noexcept
+{
+    if (!m_count)
+        return NULL;
+    return m_slots[find (guid)].ent;
+}
+
+/* Insert ent under guid, replacing whatever was there. */
+void
+EntityTable::insert (const GncGUID *guid, QofInstance *ent)
+{
+    reserve (m_count + 1);
+
+    auto& slot = m_slots[find (guid)];
+    if (!slot.ent)
+        ++m_count;
+    slot.guid = *guid;
+    slot.ent = ent;
+}
+
+/* Empty guid's slot, then move back any entry after it that could no
+ * longer be reached across the gap. */
+void
+EntityTable::remove (const GncGUID *guid) noexcept
+{
+    if (!m_count)
+        return;
+
+    auto mask = m_slots.size() - 1;
+    auto gap = find (guid);
+    if (!m_slots[gap].ent)
+        return;
+
+    for (auto pos = (gap + 1) & mask; m_slots[pos].ent; pos = (pos + 1) & mask)
+    {
+        auto want = home (&m_slots[pos].guid);
+        /* Leave it if its home lies cyclically in (gap, pos]. */
+        if (gap <= pos ? (gap < want && want <= pos) : (gap < want || want <= pos))
+            continue;
+        m_slots[gap] = m_slots[pos];
+        gap = pos;
+    }
+    m_slots[gap].ent = NULL;
+    --m_count;
+}
+
+std::vector<QofInstance*>
+EntityTable::values () const
+{
+    std::vector<QofInstance*> entities;
+
+    entities.reserve (m_count);
+    for (auto& slot : m_slots)
+        if (slot.ent)
+            entities.push_back (slot.ent);
+    return entities;
+}
+
 struct QofCollection_s
 {
     QofIdType    e_type;
     gboolean     is_dirty;
 
-    GHashTable * hash_of_entities;
+    EntityTable *entities;
     gpointer     data;       /* place where object class can hang arbitrary data */
 };
 
@@ -52,7 +190,7 @@ qof_collection_new (QofIdType type)
     QofCollection *col;
     col = g_new0(QofCollection, 1);
     col->e_type = static_cast<QofIdType>(CACHE_INSERT (type));
-    col->hash_of_entities = guid_hash_table_new();
+    col->entities = new EntityTable;
     col->data = NULL;
     return col;
 }
@@ -61,9 +199,9 @@ void
 qof_collection_destroy (QofCollection *col)
 {
     CACHE_REMOVE (col->e_type);
-    g_hash_table_destroy(col->hash_of_entities);
+    delete col->entities;
     col->e_type = NULL;
-    col->hash_of_entities = NULL;
+    col->entities = NULL;
     col->data = NULL;   /** XXX there should be a destroy notifier for this */
     g_free (col);
 }
@@ -89,7 +227,7 @@ qof_collection_remove_entity (QofInstance *ent)
     col = qof_instance_get_collection(ent);
     if (!col) return;
     guid = qof_instance_get_guid(ent);
-    g_hash_table_remove (col->hash_of_entities, guid);
+    col->entities->remove (guid);
     qof_instance_set_collection(ent, NULL);
 }
 
@@ -103,7 +241,7 @@ qof_collection_insert_entity (QofCollection *col, QofInstance *ent)
     if (guid_equal(guid, guid_null())) return;
     g_return_if_fail (col->e_type == ent->e_type);
     qof_collection_remove_entity (ent);
-    g_hash_table_insert (col->hash_of_entities, (gpointer)guid, ent);
+    col->entities->insert (guid, ent);
     qof_instance_set_collection(ent, col);
 }
 
@@ -129,7 +267,7 @@ qof_collection_add_entity (QofCollection *coll, QofInstance *ent)
     {
         return FALSE;
     }
-    g_hash_table_insert (coll->hash_of_entities, (gpointer)guid, ent);
+    coll->entities->insert (guid, ent);
     return TRUE;
 }
 
@@ -213,12 +351,9 @@ qof_collection_compare (QofCollection *target, QofCollection *merge)
 QofInstance *
 qof_collection_lookup_entity (const QofCollection *col, const GncGUID * guid)
 {
-    QofInstance *ent;
     g_return_val_if_fail (col, NULL);
     if (guid == NULL) return NULL;
-    ent = static_cast<QofInstance*>(g_hash_table_lookup (col->hash_of_entities,
-							 guid));
-    return ent;
+    return col->entities->lookup (guid);
 }
 
 QofCollection *
@@ -243,10 +378,14 @@ qof_collection_from_glist (QofIdType type, const GList *glist)
 guint
 qof_collection_count (const QofCollection *col)
 {
-    guint c;
+    return col->entities->size();
+}
 
-    c = g_hash_table_size(col->hash_of_entities);
-    return c;
+void
+qof_collection_reserve (QofCollection *col, guint count)
+{
+    g_return_if_fail (col);
+    col->entities->reserve (count);
 }
 
 /* =============================================================== */
@@ -302,40 +441,19 @@ qof_collection_set_data (QofCollection *col, gpointer user_data)
 
 /* =============================================================== */
 
-struct _iterate
-{
-    QofInstanceForeachCB      fcn;
-    gpointer                data;
-};
-
-static void
-foreach_cb (gpointer item, gpointer arg)
-{
-    struct _iterate *iter = static_cast<_iterate*>(arg);
-    QofInstance *ent = static_cast<QofInstance*>(item);
-
-    iter->fcn (ent, iter->data);
-}
-
 void
 qof_collection_foreach (const QofCollection *col, QofInstanceForeachCB cb_func,
                         gpointer user_data)
 {
-    struct _iterate iter;
-    GList *entries;
-
     g_return_if_fail (col);
     g_return_if_fail (cb_func);
 
-    iter.fcn = cb_func;
-    iter.data = user_data;
-
-    PINFO("Hash Table size of %s before is %d", col->e_type, g_hash_table_size(col->hash_of_entities));
+    PINFO("Hash Table size of %s before is %d", col->e_type, qof_collection_count(col));
 
-    entries = g_hash_table_get_values (col->hash_of_entities);
-    g_list_foreach (entries, foreach_cb, &iter);
-    g_list_free (entries);
+    /* Work from a copy so that cb_func can add and remove entities. */
+    for (auto ent : col->entities->values())
+        cb_func (ent, user_data);
 
-    PINFO("Hash Table size of %s after is %d", col->e_type, g_hash_table_size(col->hash_of_entities));
+    PINFO("Hash Table size of %s after is %d", col->e_type, qof_collection_count(col));
 }
 /* =============================================================== */
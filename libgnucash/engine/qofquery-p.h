@@ -71,6 +71,41 @@ QofQueryParamList * qof_query_sort_get_param_path (const QofQuerySort *querysort
 gint qof_query_sort_get_sort_options (const QofQuerySort *querysort);
 gboolean qof_query_sort_get_increasing (const QofQuerySort *querysort);
 
+/* Indexes: An object type can register a way to find the objects that
+ * might match a list of ANDed query terms without visiting every
+ * object in the book, e.g. by looking only at the splits of the
+ * accounts the terms name.  qof_query_run uses it when it can serve
+ * every OR-term of a query, and checks the candidates against the
+ * whole query as usual, so an index may return too many objects but
+ * never too few, not even while an object is being edited.
+ */
+typedef struct
+{
+    /* Whether the index can find the candidates for these ANDed terms.
+     * If explain isn't NULL, append a short description of how. */
+    gboolean (*usable) (GList *and_terms, GString *explain);
+
+    /* Call cb with each object in book that could match the terms, at
+     * most once each.  Only called if usable returned TRUE. */
+    void (*foreach) (QofBook *book, GList *and_terms,
+                     QofInstanceForeachCB cb, gpointer user_data);
+} QofQueryIndex;
+
+/* Register index for obj_name, replacing any registered before, or
+ * remove it if index is NULL.  The index isn't copied. */
+void qof_query_register_index (QofIdTypeConst obj_name,
+                               const QofQueryIndex *index);
+
+/* Declare that the getters of the NULL-terminated list of obj_name's
+ * params only read.  Queries whose terms only go through such params
+ * may check the objects of a big collection on several threads at
+ * once.  Nothing may change the objects while a query runs. */
+void qof_query_register_thread_safe (QofIdTypeConst obj_name,
+                                     const char * const *params);
+
+/* Whether the terms of q only use params registered as thread safe. */
+gboolean qof_query_is_thread_safe (const QofQuery *q);
+
 #ifdef __cplusplus
 }
 #endif
@@ -36,9 +36,16 @@ extern "C"
 #include "qof-backend.hpp"
 #include "qofbook-p.h"
 #include "qofclass-p.h"
+#include "qofevent-p.h"
 #include "qofquery-p.h"
 #include "qofquerycore-p.h"
 
+#include <algorithm>
+#include <atomic>
+#include <system_error>
+#include <thread>
+#include <vector>
+
 static QofLogModule log_module = QOF_MOD_QUERY;
 
 struct _QofQueryTerm
@@ -104,15 +111,45 @@ struct _QofQuery
     gint              changed;
 
     GList *           results;
+
+    /* With cache_results set, qof_query_run returns the results again
+     * while cache_valid is set and the event generations of the
+     * cache_types still add up to cache_generation. */
+    gboolean          cache_results;
+    gboolean          cache_valid;
+    GSList *          cache_types;
+    gsize             cache_generation;
 };
 
+/* The terms of one OR-term, in the order they are to be checked. */
+typedef std::vector<const QofQueryTerm*> QofQueryPlanTerms;
+typedef std::vector<QofQueryPlanTerms> QofQueryPlan;
+
 typedef struct _QofQueryCB
 {
     QofQuery *        query;
     GList *           list;
     gint              count;
+
+    /* How qof_query_run_internal chose to run the query */
+    const QofQueryPlan *    plan;
+    const QofQueryIndex *   index;    /* NULL to visit every object */
+    GHashTable *      seen;           /* when an index may repeat objects */
+    std::vector<gpointer> * candidates; /* to check them all later */
 } QofQueryCB;
 
+/* Object types' indexes, by type */
+static GHashTable *query_indexes = NULL;
+
+/* For each object type, the set of its params whose getters may run on
+ * several threads at once */
+static GHashTable *query_thread_safe = NULL;
+
+/* Collections smaller than this aren't worth starting threads for. */
+#define QUERY_PARALLEL_MIN 20000
+/* The number of objects a thread checks at a time */
+#define QUERY_PARALLEL_CHUNK 2048
+
 /* initial_term will be owned by the new Query */
 static void query_init (QofQuery *q, QofQueryTerm *initial_term)
 {
@@ -133,6 +170,7 @@ static void query_init (QofQuery *q, QofQueryTerm *initial_term)
 
     g_list_free (q->results);
     g_list_free (q->books);
+    g_slist_free (q->cache_types);
 
     g_slist_free (q->primary_sort.param_list);
     g_slist_free (q->secondary_sort.param_list);
@@ -274,6 +312,10 @@ static void free_members (QofQuery *q)
 
     g_list_free(q->results);
     q->results = NULL;
+
+    g_slist_free(q->cache_types);
+    q->cache_types = NULL;
+    q->cache_valid = FALSE;
 }
 
 static int cmp_func (const QofQuerySort *sort, QofSortFunc default_sort,
@@ -363,20 +405,15 @@ sort_func (const gconstpointer a, const gconstpointer b, const gpointer q)
  */
 
 static int
-check_object (const QofQuery *q, gpointer object)
+check_object (const QofQueryPlan *plan, gpointer object)
 {
-    const GList     * and_ptr;
-    const GList     * or_ptr;
-    const QofQueryTerm * qt;
     int       and_terms_ok = 1;
 
-    for (or_ptr = q->terms; or_ptr; or_ptr = or_ptr->next)
+    for (auto& and_terms : *plan)
     {
         and_terms_ok = 1;
-        for (and_ptr = static_cast<GList*>(or_ptr->data); and_ptr;
-	     and_ptr = static_cast<GList*>(and_ptr->next))
+        for (auto qt : and_terms)
         {
-            qt = (QofQueryTerm *)(and_ptr->data);
             if (qt->param_fcns && qt->pred_fcn)
             {
                 const GSList *node;
@@ -416,7 +453,7 @@ check_object (const QofQuery *q, gpointer object)
      * may want to get all objects, but in a particular sorted
      * order.
      */
-    if (NULL == q->terms) return 1;
+    if (plan->empty()) return 1;
     return 0;
 }
 
@@ -508,6 +545,66 @@ compile_sort (QofQuerySort *sort, QofIdType obj)
     LEAVE ("sort=%p id=%s", sort, obj);
 }
 
+static void
+query_add_cache_type (QofQuery *q, QofIdTypeConst type)
+{
+    for (auto node = q->cache_types; node; node = node->next)
+        if (!g_strcmp0 (static_cast<const char*>(node->data), type))
+            return;
+    q->cache_types = g_slist_prepend (q->cache_types,
+                                      const_cast<char*>(type));
+}
+
+static void
+query_add_param_types (QofQuery *q, GSList *param_fcns)
+{
+    for (auto node = param_fcns; node; node = node->next)
+        query_add_cache_type (q, static_cast<const QofParam*>(node->data)->
+                              param_type);
+}
+
+static void
+query_add_param_type_cb (QofParam *param, gpointer user_data)
+{
+    query_add_cache_type (static_cast<QofQuery*>(user_data), param->param_type);
+}
+
+/* Find the types of the objects whose changes may change the results:
+ * the searched-for type, the types its parameters return, which its
+ * default sort or a sort by the object itself may well look at, and
+ * the types along every path the terms and sorts follow.  Core types
+ * are listed too, but nothing generates events for them. */
+static void
+query_find_cache_types (QofQuery *q)
+{
+    g_slist_free (q->cache_types);
+    q->cache_types = NULL;
+
+    query_add_cache_type (q, q->search_for);
+    qof_class_param_foreach (q->search_for, query_add_param_type_cb, q);
+    for (auto or_ptr = q->terms; or_ptr; or_ptr = or_ptr->next)
+        for (auto and_ptr = static_cast<GList*>(or_ptr->data); and_ptr;
+             and_ptr = and_ptr->next)
+            query_add_param_types (q, static_cast<QofQueryTerm*>
+                                   (and_ptr->data)->param_fcns);
+    query_add_param_types (q, q->primary_sort.param_fcns);
+    query_add_param_types (q, q->secondary_sort.param_fcns);
+    query_add_param_types (q, q->tertiary_sort.param_fcns);
+}
+
+/* The sum only grows, so it's unchanged exactly when no event was
+ * generated for any of the types. */
+static gsize
+query_cache_generation (const QofQuery *q)
+{
+    gsize generation = 0;
+
+    for (auto node = q->cache_types; node; node = node->next)
+        generation += qof_event_get_generation (static_cast<const char*>
+                                                (node->data));
+    return generation;
+}
+
 static void compile_terms (QofQuery *q)
 {
     GList *or_ptr, *and_ptr, *node;
@@ -548,6 +645,9 @@ static void compile_terms (QofQuery *q)
     compile_sort (&(q->tertiary_sort), q->search_for);
 
     q->defaultSort = qof_class_get_default_sort (q->search_for);
+
+    if (q->cache_results)
+        query_find_cache_types (q);
 #ifdef QOF_BACKEND_QUERY
     /* Now compile the backend instances */
     for (node = q->books; node; node = node->next)
@@ -573,7 +673,18 @@ static void check_item_cb (gpointer object, gpointer user_data)
 
     if (!object || !ql) return;
 
-    if (check_object (ql->query, object))
+    if (ql->seen)
+    {
+        if (g_hash_table_contains (ql->seen, object))
+            return;
+        g_hash_table_add (ql->seen, object);
+    }
+    if (ql->candidates)
+    {
+        ql->candidates->push_back (object);
+        return;
+    }
+    if (check_object (ql->plan, object))
     {
         ql->list = g_list_prepend (ql->list, object);
         ql->count++;
@@ -723,6 +834,141 @@ void qof_query_purge_terms (QofQuery *q, QofQueryParamList *param_list)
     }
 }
 
+/* A rough relative cost of checking a term, so that the cheap ones
+ * can rule an object out before the dear ones are tried.  Each getter
+ * in the parameter path costs a little more. */
+static int
+query_term_cost (const QofQueryTerm *qt)
+{
+    QofType type = qt->pdata->type_name;
+    int cost = 2 * g_slist_length (qt->param_fcns);
+
+    if (!g_strcmp0 (type, QOF_TYPE_STRING))
+        cost += ((query_string_t)qt->pdata)->is_regex ? 16 : 8;
+    else if (!g_strcmp0 (type, QOF_TYPE_KVP))
+        cost += 8;
+    else if (!g_strcmp0 (type, QOF_TYPE_GUID) ||
+             !g_strcmp0 (type, QOF_TYPE_COLLECT) ||
+             !g_strcmp0 (type, QOF_TYPE_CHOICE))
+        cost += 4;
+    else if (!g_strcmp0 (type, QOF_TYPE_NUMERIC) ||
+             !g_strcmp0 (type, QOF_TYPE_DEBCRED) ||
+             !g_strcmp0 (type, QOF_TYPE_DATE))
+        cost += 2;
+    else
+        cost += 1;
+    return cost;
+}
+
+static gchar *
+query_term_path (const QofQueryTerm *qt)
+{
+    GString *path = g_string_new (NULL);
+
+    for (auto node = qt->param_list; node; node = node->next)
+    {
+        if (node != qt->param_list)
+            g_string_append_c (path, '.');
+        g_string_append (path, static_cast<char*>(node->data));
+    }
+    return g_string_free (path, FALSE);
+}
+
+/* Order each OR-term's terms cheapest first, and see whether the
+ * object type has an index that can find the candidates for all of
+ * them.  The query's own lists are left alone since callers look at
+ * them. */
+static void
+query_plan (QofQuery *q, QofQueryPlan &plan, const QofQueryIndex **index)
+{
+    GString *explain = NULL;
+
+    if (qof_log_check (log_module, QOF_LOG_DEBUG))
+        explain = g_string_new (NULL);
+
+    *index = NULL;
+    if (query_indexes && q->terms)
+        *index = static_cast<const QofQueryIndex*>
+                 (g_hash_table_lookup (query_indexes, q->search_for));
+
+    for (auto or_ptr = q->terms; or_ptr; or_ptr = or_ptr->next)
+    {
+        auto and_terms = static_cast<GList*>(or_ptr->data);
+        std::vector<std::pair<int, const QofQueryTerm*>> costs;
+
+        for (auto and_ptr = and_terms; and_ptr; and_ptr = and_ptr->next)
+        {
+            auto qt = static_cast<const QofQueryTerm*>(and_ptr->data);
+            costs.emplace_back (query_term_cost (qt), qt);
+        }
+        std::stable_sort (costs.begin(), costs.end(),
+                          [](const std::pair<int, const QofQueryTerm*>& a,
+                             const std::pair<int, const QofQueryTerm*>& b)
+                          { return a.first < b.first; });
+
+        plan.emplace_back ();
+        for (auto& cost : costs)
+            plan.back().push_back (cost.second);
+
+        if (explain)
+        {
+            g_string_append_printf (explain, "\n  or-term %zu:", plan.size());
+            for (auto& cost : costs)
+            {
+                auto path = query_term_path (cost.second);
+                g_string_append_printf (explain, " %s%s(cost %d)",
+                                        cost.second->invert ? "NOT " : "",
+                                        path, cost.first);
+                g_free (path);
+            }
+            g_string_append (explain, "\n    candidates: ");
+        }
+        if (*index && !(*index)->usable (and_terms, explain))
+            *index = NULL;
+        if (explain && !*index)
+            g_string_append (explain, "every object");
+    }
+
+    if (explain)
+    {
+        DEBUG ("plan for %s query %p, %s:%s", q->search_for, q,
+               *index ? "using its index" : "scanning every object",
+               explain->str);
+        g_string_free (explain, TRUE);
+    }
+}
+
+/* Sort objects, of which there are count, and keep the last
+ * q->max_results, as a full sort and crop would, but without putting
+ * the rest in order.  Ties are broken by position in the list so that
+ * the result is the same as g_list_sort's stable merge sort gives. */
+static GList *
+query_sort_last (GList *objects, gint count, QofQuery *q)
+{
+    typedef std::pair<gpointer, gint> SortItem;
+    std::vector<SortItem> items;
+    GList *result = NULL;
+    gint pos = 0;
+
+    items.reserve (count);
+    for (auto node = objects; node; node = node->next)
+        items.emplace_back (node->data, pos++);
+    g_list_free (objects);
+
+    auto less = [q](const SortItem& a, const SortItem& b)
+                {
+                    auto rc = sort_func (a.first, b.first, q);
+                    return rc ? rc < 0 : a.second < b.second;
+                };
+    auto first = items.end() - std::min<size_t> (q->max_results, items.size());
+    std::nth_element (items.begin(), first, items.end(), less);
+    std::sort (first, items.end(), less);
+
+    for (auto item = items.end(); item != first;)
+        result = g_list_prepend (result, (--item)->first);
+    return result;
+}
+
 static GList * qof_query_run_internal (QofQuery *q,
                                        void(*run_cb)(QofQueryCB*, gpointer),
                                        gpointer cb_arg)
@@ -736,8 +982,6 @@ static GList * qof_query_run_internal (QofQuery *q,
     g_return_val_if_fail (run_cb, NULL);
     ENTER (" q=%p", q);
 
-    /* XXX: Prioritize the query terms? */
-
     /* prepare the Query for processing */
     if (q->changed)
     {
@@ -752,9 +996,12 @@ static GList * qof_query_run_internal (QofQuery *q,
     /* Now run the query over all the objects and save the results */
     {
         QofQueryCB qcb;
+        QofQueryPlan plan;
 
         memset (&qcb, 0, sizeof (qcb));
         qcb.query = q;
+        query_plan (q, plan, &qcb.index);
+        qcb.plan = &plan;
 
         /* Run the query callback */
         run_cb(&qcb, cb_arg);
@@ -772,11 +1019,20 @@ static GList * qof_query_run_internal (QofQuery *q,
      */
     matching_objects = g_list_reverse(matching_objects);
 
-    /* Now sort the matching objects based on the search criteria */
+    /* Now sort the matching objects based on the search criteria.  If
+     * only a few of them are wanted, just find and sort those. */
     if (q->primary_sort.comp_fcn || q->primary_sort.obj_cmp ||
             (q->primary_sort.use_default && q->defaultSort))
     {
-        matching_objects = g_list_sort_with_data(matching_objects, sort_func, q);
+        if (q->max_results > 0 && q->max_results < object_count / 2)
+        {
+            matching_objects = query_sort_last (matching_objects,
+                                                object_count, q);
+            object_count = q->max_results;
+        }
+        else
+            matching_objects = g_list_sort_with_data(matching_objects,
+                                                     sort_func, q);
     }
 
     /* Crop the list to limit the number of splits. */
@@ -810,11 +1066,66 @@ static GList * qof_query_run_internal (QofQuery *q,
 
     g_list_free(q->results);
     q->results = matching_objects;
+    q->cache_valid = FALSE;
 
     LEAVE (" q=%p", q);
     return matching_objects;
 }
 
+/* Check the candidates on as many threads as there are processors,
+ * each taking a chunk at a time, and add the matches to the list in
+ * the order the candidates were found, just as check_item_cb would. */
+static void
+query_check_parallel (QofQueryCB *qcb, const std::vector<gpointer>& candidates)
+{
+    size_t nchunks = (candidates.size() + QUERY_PARALLEL_CHUNK - 1) /
+                     QUERY_PARALLEL_CHUNK;
+    std::vector<std::vector<gpointer>> matches (nchunks);
+    std::atomic<size_t> next_chunk {0};
+    std::vector<std::thread> threads;
+
+    auto check_chunks = [&]()
+    {
+        size_t chunk;
+        while ((chunk = next_chunk++) < nchunks)
+        {
+            auto begin = chunk * QUERY_PARALLEL_CHUNK;
+            auto end = std::min (begin + QUERY_PARALLEL_CHUNK,
+                                 candidates.size());
+            for (auto i = begin; i < end; ++i)
+                if (check_object (qcb->plan, candidates[i]))
+                    matches[chunk].push_back (candidates[i]);
+        }
+    };
+
+    size_t nthreads = std::min<size_t> (std::thread::hardware_concurrency (),
+                                        nchunks);
+    for (size_t i = 1; i < nthreads; ++i)
+    {
+        try
+        {
+            threads.emplace_back (check_chunks);
+        }
+        catch (const std::system_error&)
+        {
+            /* Make do with the threads we have. */
+            break;
+        }
+    }
+    DEBUG ("checking %zu objects on %zu threads", candidates.size(),
+           threads.size() + 1);
+    check_chunks ();
+    for (auto& thread : threads)
+        thread.join ();
+
+    for (auto& chunk : matches)
+        for (auto object : chunk)
+        {
+            qcb->list = g_list_prepend (qcb->list, object);
+            qcb->count++;
+        }
+}
+
 static void qof_query_run_cb(QofQueryCB* qcb, gpointer cb_arg)
 {
     GList *node;
@@ -840,16 +1151,70 @@ static void qof_query_run_cb(QofQueryCB* qcb, gpointer cb_arg)
             }
         }
 #endif
-        /* And then iterate over all the objects */
-        qof_object_foreach (qcb->query->search_for, book,
-                            (QofInstanceForeachCB) check_item_cb, qcb);
+        /* A big collection of a type whose getters only read can have
+         * its objects gathered first and then checked on several
+         * threads. */
+        std::vector<gpointer> candidates;
+        if (qcb->query->terms &&
+            qof_collection_count (qof_book_get_collection
+                                  (book, qcb->query->search_for))
+            >= QUERY_PARALLEL_MIN &&
+            qof_query_is_thread_safe (qcb->query))
+            qcb->candidates = &candidates;
+
+        /* And then iterate over all the objects, or over the
+         * candidates the index finds for each OR-term. */
+        if (!qcb->index)
+        {
+            qof_object_foreach (qcb->query->search_for, book,
+                                (QofInstanceForeachCB) check_item_cb, qcb);
+        }
+        else
+        {
+            if (qcb->query->terms->next)
+                qcb->seen = g_hash_table_new (NULL, NULL);
+            for (auto or_ptr = qcb->query->terms; or_ptr; or_ptr = or_ptr->next)
+                qcb->index->foreach (book, static_cast<GList*>(or_ptr->data),
+                                     (QofInstanceForeachCB) check_item_cb, qcb);
+            if (qcb->seen)
+                g_hash_table_destroy (qcb->seen);
+            qcb->seen = NULL;
+        }
+
+        if (qcb->candidates)
+        {
+            qcb->candidates = NULL;
+            query_check_parallel (qcb, candidates);
+        }
     }
 }
 
 GList * qof_query_run (QofQuery *q)
 {
-    /* Just a wrapper */
-    return qof_query_run_internal(q, qof_query_run_cb, NULL);
+    GList *results;
+
+    if (q && q->cache_results && q->cache_valid && !q->changed &&
+        query_cache_generation (q) == q->cache_generation)
+    {
+        PINFO ("q=%p nothing changed, returning %p again", q, q->results);
+        return q->results;
+    }
+
+    results = qof_query_run_internal(q, qof_query_run_cb, NULL);
+    if (q && q->cache_results && q->search_for && q->books)
+    {
+        q->cache_generation = query_cache_generation (q);
+        q->cache_valid = TRUE;
+    }
+    return results;
+}
+
+void qof_query_set_cache_results (QofQuery *q, gboolean cache)
+{
+    if (!q) return;
+    q->cache_results = cache;
+    q->cache_valid = FALSE;
+    q->changed = 1;
 }
 
 static void qof_query_run_subq_cb(QofQueryCB* qcb, gpointer cb_arg)
@@ -896,6 +1261,7 @@ void qof_query_clear (QofQuery *query)
     query->books = NULL;
     g_list_free (query->results);
     query->results = NULL;
+    query->cache_valid = FALSE;
     query->changed = 1;
 }
 
@@ -1015,6 +1381,8 @@ QofQuery * qof_query_copy (QofQuery *q)
     copy->terms = copy_or_terms (q->terms);
     copy->books = g_list_copy (q->books);
     copy->results = g_list_copy (q->results);
+    copy->cache_types = NULL;
+    copy->cache_valid = FALSE;
 
     copy_sort (&(copy->primary_sort), &(q->primary_sort));
     copy_sort (&(copy->secondary_sort), &(q->secondary_sort));
@@ -1258,6 +1626,7 @@ void qof_query_set_sort_options (QofQuery *q, gint prim_op, gint sec_op,
     q->primary_sort.options = prim_op;
     q->secondary_sort.options = sec_op;
     q->tertiary_sort.options = tert_op;
+    q->cache_valid = FALSE;
 }
 
 void qof_query_set_sort_increasing (QofQuery *q, gboolean prim_inc,
@@ -1267,12 +1636,14 @@ void qof_query_set_sort_increasing (QofQuery *q, gboolean prim_inc,
     q->primary_sort.increasing = prim_inc;
     q->secondary_sort.increasing = sec_inc;
     q->tertiary_sort.increasing = tert_inc;
+    q->cache_valid = FALSE;
 }
 
 void qof_query_set_max_results (QofQuery *q, int n)
 {
     if (!q) return;
     q->max_results = n;
+    q->cache_valid = FALSE;
 }
 
 void qof_query_add_guid_list_match (QofQuery *q, QofQueryParamList *param_list,
@@ -1352,6 +1723,87 @@ void qof_query_shutdown (void)
 {
     qof_class_shutdown ();
     qof_query_core_shutdown ();
+    if (query_indexes)
+        g_hash_table_destroy (query_indexes);
+    query_indexes = NULL;
+    if (query_thread_safe)
+        g_hash_table_destroy (query_thread_safe);
+    query_thread_safe = NULL;
+}
+
+void qof_query_register_thread_safe (QofIdTypeConst obj_name,
+                                     const char * const *params)
+{
+    GHashTable *safe;
+
+    g_return_if_fail (obj_name);
+    g_return_if_fail (params);
+
+    if (!query_thread_safe)
+        query_thread_safe = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                   NULL,
+                                                   (GDestroyNotify)g_hash_table_destroy);
+    safe = static_cast<GHashTable*>(g_hash_table_lookup (query_thread_safe,
+                                                         obj_name));
+    if (!safe)
+    {
+        safe = g_hash_table_new (g_str_hash, g_str_equal);
+        g_hash_table_insert (query_thread_safe, (gpointer)obj_name, safe);
+    }
+    for (; *params; ++params)
+        g_hash_table_add (safe, (gpointer)*params);
+}
+
+/* Whether every getter along path, starting from an object of type
+ * obj_name, is registered as thread safe. */
+static gboolean
+query_path_is_thread_safe (QofIdTypeConst obj_name, QofQueryParamList *path)
+{
+    for (; path; path = path->next)
+    {
+        auto safe = static_cast<GHashTable*>(g_hash_table_lookup
+                                             (query_thread_safe, obj_name));
+        if (!safe || !g_hash_table_contains (safe, path->data))
+            return FALSE;
+        auto param = qof_class_get_parameter (obj_name,
+                                              static_cast<char*>(path->data));
+        if (!param)
+            return FALSE;
+        obj_name = param->param_type;
+    }
+    return TRUE;
+}
+
+gboolean
+qof_query_is_thread_safe (const QofQuery *q)
+{
+    g_return_val_if_fail (q, FALSE);
+
+    if (!query_thread_safe)
+        return FALSE;
+    for (auto or_ptr = q->terms; or_ptr; or_ptr = or_ptr->next)
+        for (auto and_ptr = static_cast<GList*>(or_ptr->data); and_ptr;
+             and_ptr = and_ptr->next)
+        {
+            auto qt = static_cast<const QofQueryTerm*>(and_ptr->data);
+            if (!query_path_is_thread_safe (q->search_for, qt->param_list))
+                return FALSE;
+        }
+    return TRUE;
+}
+
+void qof_query_register_index (QofIdTypeConst obj_name,
+                               const QofQueryIndex *index)
+{
+    g_return_if_fail (obj_name);
+
+    if (!query_indexes)
+        query_indexes = g_hash_table_new (g_str_hash, g_str_equal);
+    if (index)
+        g_hash_table_insert (query_indexes, (gpointer)obj_name,
+                             (gpointer)index);
+    else
+        g_hash_table_remove (query_indexes, obj_name);
 }
 
 int qof_query_get_max_results (const QofQuery *q)
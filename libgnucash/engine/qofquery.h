@@ -221,6 +221,16 @@ void qof_query_add_boolean_match (QofQuery *q,
  */
 GList * qof_query_run (QofQuery *query);
 
+/** Keep the results of qof_query_run and return them again, without
+ *  searching, until the query is changed or an event is generated for
+ *  an object of a type the query looks at: the searched-for type, the
+ *  types its parameters return and the types along the query's
+ *  parameter paths.  This suits views that re-run the same query
+ *  whenever they refresh.  Don't use it if the results depend on
+ *  objects that change without generating events.
+ */
+void qof_query_set_cache_results (QofQuery *q, gboolean cache);
+
 /** Return the results of the last query, without causing the query to
  *  be re-run.  Do NOT free the resulting list.  This list is managed
  *  internally by QofQuery.
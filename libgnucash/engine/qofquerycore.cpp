@@ -772,6 +772,19 @@ qof_query_guid_predicate (QofGuidMatch options, GList *guid_list)
     return ((QofQueryPredData*)pdata);
 }
 
+gboolean
+qof_query_guid_predicate_get_guids (const QofQueryPredData *pd,
+                                    QofGuidMatch *options, GList **guids)
+{
+    const query_guid_t pdata = (const query_guid_t)pd;
+
+    if (pdata->pd.type_name != query_guid_type)
+        return FALSE;
+    *options = pdata->options;
+    *guids = pdata->guids;
+    return TRUE;
+}
+
 /* ================================================================ */
 /* QOF_TYPE_INT32 */
 
@@ -184,6 +184,11 @@ void qof_query_core_predicate_free (QofQueryPredData *pdata);
 
 /** Retrieve a predicate. */
 gboolean qof_query_date_predicate_get_date (const QofQueryPredData *pd, Timespec *date);
+/** Retrieve the match options and the GUIDs of a GUID predicate.  The
+ *  list belongs to the predicate. */
+gboolean qof_query_guid_predicate_get_guids (const QofQueryPredData *pd,
+                                             QofGuidMatch *options,
+                                             GList **guids);
 /** Return a printable string for a core data object.  Caller needs
  *  to g_free() the returned string.
  */
@@ -280,8 +280,75 @@ TEST(gnc_timezone_constructors, test_IANA_Minsk_tz)
         }
      }
 }
+
+/* The table has to agree with the zone that get() returns for each half hour
+ * of year, and local times in the DST gap and the repeated hour can't be
+ * converted back to UTC.
+ */
+static void
+check_transitions(const TimeZoneProvider& tzp, int year)
+{
+    using boost::posix_time::ptime;
+    using LDT = boost::local_time::local_date_time;
+    const ptime epoch(boost::gregorian::date(1970, 1, 1));
+    auto tz = tzp.get(year);
+    auto to_seconds = [&epoch](ptime t) -> int64_t
+        {
+            auto since = t - epoch;
+            return since.ticks() / since.ticks_per_second();
+        };
+
+    for (ptime t(boost::gregorian::date(year, 1, 1));
+         t.date().year() == year; t += boost::posix_time::minutes(30))
+    {
+        LDT ldt(t, tz);
+        auto& tr = tzp.transition(to_seconds(t));
+        EXPECT_EQ((ldt.local_time() - t).total_seconds(), tr.offset) << t;
+        EXPECT_EQ(ldt.is_dst(), tr.is_dst) << t;
+    }
+
+    int64_t time;
+    auto noon = ptime(boost::gregorian::date(year, 7, 1),
+                      boost::posix_time::hours(12));
+    EXPECT_TRUE(tzp.utc_from_local(to_seconds(noon), time));
+    EXPECT_EQ(to_seconds(LDT(noon.date(), noon.time_of_day(), tz,
+                             LDT::EXCEPTION_ON_ERROR).utc_time()), time);
+    if (!tz->has_dst())
+        return;
+    auto half_hour = boost::posix_time::minutes(30);
+    auto gap = tz->dst_local_start_time(year) + half_hour;
+    auto repeated = tz->dst_local_end_time(year) - half_hour;
+    EXPECT_FALSE(tzp.utc_from_local(to_seconds(gap), time));
+    EXPECT_FALSE(tzp.utc_from_local(to_seconds(repeated), time));
+}
+
+TEST(gnc_timezone_transitions, test_IANA_New_York_tz)
+{
+    TimeZoneProvider tzp("America/New_York");
+    check_transitions(tzp, 1960);
+    check_transitions(tzp, 2017);
+    check_transitions(tzp, 2100);
+}
+
+TEST(gnc_timezone_transitions, test_IANA_Sydney_tz)
+{
+    TimeZoneProvider tzp("Australia/Sydney");
+    check_transitions(tzp, 1990);
+    check_transitions(tzp, 2017);
+    check_transitions(tzp, 2100);
+}
 #endif
 
+TEST(gnc_timezone_transitions, test_posix_timezone)
+{
+    TimeZoneProvider tzp("UTC0");
+    int64_t time;
+    EXPECT_EQ(0, tzp.transition(INT64_C(-12219292800)).offset);
+    EXPECT_EQ(0, tzp.transition(INT64_C(1500000000)).offset);
+    EXPECT_TRUE(tzp.utc_from_local(INT64_C(1500000000), time));
+    EXPECT_EQ(INT64_C(1500000000), time);
+}
+
 TEST(gnc_timezone_constructors, test_bogus_time_constructor)
 {
     TimeZoneProvider tzp ("New York Standard Time");
@@ -0,0 +1,200 @@
+/********************************************************************
+ * perf-account-splits.cpp: Compare the account's split array with  *
+ * the sorted GList it replaced, and time making the splits and     *
+ * computing their balances.                                        *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, you can retrieve it from        *
+ * https://www.gnu.org/licenses/old-licenses/gpl-2.0.html            *
+ * or contact:                                                      *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ ********************************************************************/
+
+/* Not run by ctest; build it with "make perf-account-splits" and pass
+ * the number of splits to use, e.g. "perf-account-splits 200000". */
+
+extern "C"
+{
+#include <config.h>
+#include <glib.h>
+#include <stdlib.h>
+#include "qof.h"
+#include "cashobjects.h"
+#include "Account.h"
+#include "Split.h"
+#include "Transaction.h"
+#include "TransactionP.h"
+#include "TransLog.h"
+#include "gnc-commodity.h"
+}
+
+#ifndef G_OS_WIN32
+#include <sys/resource.h>
+#endif
+#include <vector>
+
+/* The peak resident set size so far in kilobytes, or 0 if unknown. */
+static long
+peak_rss (void)
+{
+#ifndef G_OS_WIN32
+    struct rusage usage;
+
+    if (getrusage (RUSAGE_SELF, &usage) == 0)
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024;
+#else
+        return usage.ru_maxrss;
+#endif
+#endif
+    return 0;
+}
+
+/* Make count splits posted at random in the ten years before start,
+ * or one a day after it if in_order is set. */
+static std::vector<Split*>
+make_splits (QofBook *book, gnc_commodity *curr, int count, time64 start,
+             bool in_order)
+{
+    std::vector<Split*> splits;
+
+    splits.reserve (count);
+    for (int i = 0; i < count; ++i)
+    {
+        auto trans = xaccMallocTransaction (book);
+        auto split = xaccMallocSplit (book);
+        auto amount = gnc_numeric_create (g_random_int_range (-100000, 100000),
+                                          100);
+
+        xaccTransBeginEdit (trans);
+        xaccTransSetCurrency (trans, curr);
+        xaccTransSetDatePostedSecs (trans, in_order ? start + i * 86400 :
+                                    start - g_random_int_range (0, 3650 * 86400));
+        xaccSplitSetParent (split, trans);
+        xaccSplitSetAmount (split, amount);
+        xaccSplitSetValue (split, amount);
+        xaccTransCommitEdit (trans);
+        splits.push_back (split);
+    }
+    return splits;
+}
+
+/* Give a split to acc the way the register and the backends do: the
+ * account takes the split when its transaction is committed. */
+static void
+set_account (Split *split, Account *acc)
+{
+    auto trans = xaccSplitGetParent (split);
+
+    xaccTransBeginEdit (trans);
+    xaccSplitSetAccount (split, acc);
+    xaccTransCommitEdit (trans);
+}
+
+static void
+run_glist (const std::vector<Split*>& splits)
+{
+    GList *list = NULL;
+    GTimer *timer = g_timer_new ();
+
+    for (auto s : splits)
+        if (!g_list_find (list, s))
+            list = g_list_insert_sorted (list, s, (GCompareFunc)xaccSplitOrder);
+    g_print ("  GList  insert: %10.3f s\n", g_timer_elapsed (timer, NULL));
+
+    g_timer_start (timer);
+    for (auto s : splits)
+        list = g_list_delete_link (list, g_list_find (list, s));
+    g_print ("  GList  remove: %10.3f s\n", g_timer_elapsed (timer, NULL));
+    g_timer_destroy (timer);
+}
+
+static void
+run_account (QofBook *book, gnc_commodity *curr,
+             const std::vector<Split*>& splits,
+             const std::vector<Split*>& newer)
+{
+    auto acc = xaccMallocAccount (book);
+    xaccAccountBeginEdit (acc);
+    xaccAccountSetCommodity (acc, curr);
+    xaccAccountCommitEdit (acc);
+    GTimer *timer = g_timer_new ();
+
+    for (auto s : splits)
+        set_account (s, acc);
+    g_print ("  vector insert: %10.3f s\n", g_timer_elapsed (timer, NULL));
+
+    g_timer_start (timer);
+    xaccAccountRecomputeBalance (acc);
+    g_print ("  full balance:  %10.3f s\n", g_timer_elapsed (timer, NULL));
+
+    /* Adding the newest split only has to compute its own balance. */
+    g_timer_start (timer);
+    for (auto s : newer)
+    {
+        set_account (s, acc);
+        xaccAccountRecomputeBalance (acc);
+    }
+    g_print ("  %zu appends:  %10.3f s\n", newer.size(),
+             g_timer_elapsed (timer, NULL));
+    for (auto s : newer)
+        xaccSplitDestroy (s);
+
+    /* Keep the account open so that removing a split doesn't also
+     * recompute the running balances. */
+    xaccAccountBeginEdit (acc);
+    g_timer_start (timer);
+    for (auto s : splits)
+        xaccSplitDestroy (s);
+    g_print ("  vector remove: %10.3f s\n", g_timer_elapsed (timer, NULL));
+    xaccAccountCommitEdit (acc);
+    g_timer_destroy (timer);
+}
+
+int
+main (int argc, char **argv)
+{
+    int count = argc > 1 ? atoi (argv[1]) : 20000;
+
+    qof_init ();
+    if (!cashobjects_register ())
+        return 1;
+    xaccLogDisable ();
+    /* The transactions have a single split; don't balance them. */
+    xaccDisableDataScrubbing ();
+
+    auto session = qof_session_new ();
+    auto book = qof_session_get_book (session);
+    auto curr = gnc_commodity_new (book, "US Dollar", "CURRENCY", "USD",
+                                   "840", 100);
+    auto now = gnc_time (NULL);
+    auto rss = peak_rss ();
+    GTimer *timer = g_timer_new ();
+    auto splits = make_splits (book, curr, count, now, false);
+
+    g_print ("%d splits in random date order:\n", count);
+    g_print ("  create:        %10.3f s, %ld KB\n",
+             g_timer_elapsed (timer, NULL), peak_rss () - rss);
+    g_timer_destroy (timer);
+
+    auto newer = make_splits (book, curr, 1000, now + 86400, true);
+    run_glist (splits);
+    run_account (book, curr, splits, newer);
+
+    qof_session_destroy (session);
+    qof_close ();
+    return 0;
+}
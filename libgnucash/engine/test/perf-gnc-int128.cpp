@@ -0,0 +1,118 @@
+/********************************************************************
+ * perf-gnc-int128.cpp: Time the GncInt128 operations that          *
+ * GncRational depends on.                                          *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, you can retrieve it from        *
+ * https://www.gnu.org/licenses/old-licenses/gpl-2.0.html            *
+ * or contact:                                                      *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ ********************************************************************/
+
+/* Not run by ctest; build "make perf-gnc-int128 perf-gnc-int128-portable"
+ * and compare the two, passing the number of operands to use, e.g.
+ * "perf-gnc-int128 1000000". */
+
+extern "C"
+{
+#include <config.h>
+#include <stdlib.h>
+}
+
+#include "../gnc-int128.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/* Go through the operands this many times. */
+#define ROUNDS 10
+
+using Clock = std::chrono::steady_clock;
+
+static double
+elapsed (Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/* Numerators and denominators like those of prices and amounts: the
+ * numerators up to 2^62, the denominators powers of ten or share counts. */
+static void
+make_operands (std::vector<int64_t>& nums, std::vector<int64_t>& denoms,
+               int count)
+{
+    std::mt19937_64 gen {42};
+    std::uniform_int_distribution<int64_t> num (-(INT64_C(1) << 62),
+                                                INT64_C(1) << 62);
+    std::uniform_int_distribution<int64_t> denom (1, 1000000000);
+
+    for (int i = 0; i < count; ++i)
+    {
+        nums.push_back (num (gen));
+        denoms.push_back (i % 2 ? denom (gen) : INT64_C(1) << (i % 20));
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+    int count = argc > 1 ? atoi (argv[1]) : 100000;
+    std::vector<int64_t> nums, denoms;
+    GncInt128 check {};
+
+    make_operands (nums, denoms, count);
+#ifdef GNC_INT128_NATIVE
+    std::cout << count << " operands, native __int128:\n";
+#else
+    std::cout << count << " operands, portable:\n";
+#endif
+
+    /* The cross products of adding and multiplying two rationals. */
+    auto start = Clock::now();
+    std::vector<GncInt128> products;
+    products.reserve (count);
+    for (int r = 0; r < ROUNDS; ++r)
+    {
+        products.clear();
+        for (int i = 0; i < count; ++i)
+            products.push_back (GncInt128 (nums[i]) *
+                                GncInt128 (denoms[count - i - 1]));
+    }
+    std::cout << "  multiply: " << elapsed (start) << " s\n";
+
+    /* Rounding a product back to a denominator. */
+    start = Clock::now();
+    for (int r = 0; r < ROUNDS; ++r)
+        for (int i = 0; i < count; ++i)
+        {
+            GncInt128 q {}, rem {};
+            products[i].div (GncInt128 (denoms[i]), q, rem);
+            check += rem;
+        }
+    std::cout << "  divide:   " << elapsed (start) << " s\n";
+
+    /* Reducing the products to lowest terms. */
+    start = Clock::now();
+    for (int r = 0; r < ROUNDS; ++r)
+        for (int i = 0; i < count; ++i)
+            check += products[i].gcd (GncInt128 (denoms[i]) *
+                                      GncInt128 (denoms[count - i - 1]));
+    std::cout << "  gcd:      " << elapsed (start) << " s\n";
+
+    std::cout << "  (checksum " << check << ")\n";
+    return 0;
+}
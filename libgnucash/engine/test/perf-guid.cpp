@@ -0,0 +1,131 @@
+/********************************************************************
+ * perf-guid.cpp: Time parsing and printing GUIDs with boost::uuids *
+ * and with guid.cpp's hex routines.                                *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, you can retrieve it from        *
+ * https://www.gnu.org/licenses/old-licenses/gpl-2.0.html            *
+ * or contact:                                                      *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ ********************************************************************/
+
+/* Not run by ctest; build it with "make perf-guid" and pass the number
+ * of GUIDs to use, e.g. "perf-guid 6000000". */
+
+extern "C"
+{
+#include <config.h>
+#include <glib.h>
+#include <stdlib.h>
+#include "qof.h"
+}
+
+#include "../guid.hpp"
+#include <boost/uuid/uuid_generators.hpp>
+#include <boost/uuid/uuid_io.hpp>
+#include <string>
+#include <vector>
+
+static void
+report (const char *what, GTimer *timer, size_t count)
+{
+    auto secs = g_timer_elapsed (timer, NULL);
+    g_print ("  %-22s %10.3f s, %6.1f M/s\n", what, secs,
+             secs > 0 ? count / secs / 1e6 : 0.0);
+}
+
+/* What guid.cpp used to do: boost's generator and a copy without the
+ * dashes. */
+static void
+run_boost (const std::vector<std::string>& strings)
+{
+    boost::uuids::string_generator strgen;
+    std::vector<boost::uuids::uuid> uuids;
+    GTimer *timer = g_timer_new ();
+
+    uuids.reserve (strings.size());
+    for (auto& str : strings)
+        uuids.push_back (strgen (str));
+    report ("boost parse:", timer, strings.size());
+
+    g_timer_start (timer);
+    guint bad = 0;
+    for (auto& uuid : uuids)
+    {
+        auto val = boost::uuids::to_string (uuid);
+        std::string str;
+        for (auto a : val)
+            if (a != '-') str.push_back (a);
+        bad += str.size() != GUID_ENCODING_LENGTH;
+    }
+    report ("boost format:", timer, uuids.size());
+    g_timer_destroy (timer);
+
+    if (bad)
+        g_print ("  %u GUIDs had the wrong length!\n", bad);
+}
+
+static void
+run_guid (const std::vector<std::string>& strings)
+{
+    std::vector<GncGUID> guids (strings.size());
+    char buff[GUID_ENCODING_LENGTH + 1];
+    GTimer *timer = g_timer_new ();
+    guint bad = 0;
+
+    for (size_t i = 0; i < strings.size(); ++i)
+        bad += !string_to_guid (strings[i].c_str(), &guids[i]);
+    report ("string_to_guid:", timer, strings.size());
+
+    g_timer_start (timer);
+    for (auto& guid : guids)
+        guid_to_string_buff (&guid, buff);
+    report ("guid_to_string_buff:", timer, guids.size());
+
+    g_timer_start (timer);
+    for (size_t i = 0; i < guids.size(); ++i)
+        bad += gnc::GUID::from_string (strings[i]) != gnc::GUID {guids[i]};
+    report ("GUID::from_string:", timer, strings.size());
+
+    g_timer_start (timer);
+    for (auto& guid : guids)
+        bad += gnc::GUID {guid}.to_string ().size() != GUID_ENCODING_LENGTH;
+    report ("GUID::to_string:", timer, guids.size());
+    g_timer_destroy (timer);
+
+    if (bad)
+        g_print ("  %u GUIDs didn't round trip!\n", bad);
+}
+
+int
+main (int argc, char **argv)
+{
+    int count = argc > 1 ? atoi (argv[1]) : 1000000;
+    std::vector<std::string> strings;
+
+    qof_init ();
+
+    strings.reserve (count);
+    for (int i = 0; i < count; ++i)
+        strings.push_back (gnc::GUID::create_random ().to_string ());
+
+    g_print ("%d GUIDs:\n", count);
+    run_boost (strings);
+    run_guid (strings);
+
+    qof_close ();
+    return 0;
+}
@@ -0,0 +1,118 @@
+/********************************************************************
+ * perf-qofid.cpp: Compare looking up entities in a QofCollection   *
+ * with the GUID-keyed GHashTable it used to keep them in.          *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, you can retrieve it from        *
+ * https://www.gnu.org/licenses/old-licenses/gpl-2.0.html            *
+ * or contact:                                                      *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ ********************************************************************/
+
+/* Not run by ctest; build it with "make perf-qofid" and pass the number
+ * of entities to use, e.g. "perf-qofid 2000000". */
+
+extern "C"
+{
+#include <config.h>
+#include <glib.h>
+#include <stdlib.h>
+#include "qof.h"
+}
+
+#include <vector>
+
+#define PERF_ID "perf-entity"
+
+/* Look every GUID up this many times. */
+#define ROUNDS 5
+
+static void
+run_ghash (const std::vector<QofInstance*>& ents)
+{
+    auto table = guid_hash_table_new ();
+    GTimer *timer = g_timer_new ();
+    guint found = 0;
+
+    for (auto ent : ents)
+        g_hash_table_insert (table, (gpointer)qof_instance_get_guid (ent), ent);
+    g_print ("  GHashTable insert:     %10.3f s\n",
+             g_timer_elapsed (timer, NULL));
+
+    g_timer_start (timer);
+    for (int i = 0; i < ROUNDS; ++i)
+        for (auto ent : ents)
+            found += g_hash_table_lookup (table, qof_instance_get_guid (ent)) == ent;
+    g_print ("  GHashTable lookup:     %10.3f s (%u found)\n",
+             g_timer_elapsed (timer, NULL), found);
+
+    g_timer_destroy (timer);
+    g_hash_table_destroy (table);
+}
+
+static void
+run_collection (const std::vector<QofInstance*>& ents, bool reserve)
+{
+    auto col = qof_collection_new (PERF_ID);
+    GTimer *timer = g_timer_new ();
+    guint found = 0;
+
+    if (reserve)
+        qof_collection_reserve (col, ents.size());
+    for (auto ent : ents)
+        qof_collection_add_entity (col, ent);
+    g_print ("  QofCollection insert:  %10.3f s%s\n",
+             g_timer_elapsed (timer, NULL), reserve ? " (reserved)" : "");
+
+    g_timer_start (timer);
+    for (int i = 0; i < ROUNDS; ++i)
+        for (auto ent : ents)
+            found += qof_collection_lookup_entity (col, qof_instance_get_guid (ent)) == ent;
+    g_print ("  QofCollection lookup:  %10.3f s (%u found)\n",
+             g_timer_elapsed (timer, NULL), found);
+
+    g_timer_destroy (timer);
+    qof_collection_destroy (col);
+}
+
+int
+main (int argc, char **argv)
+{
+    int count = argc > 1 ? atoi (argv[1]) : 500000;
+    std::vector<QofInstance*> ents;
+
+    qof_init ();
+
+    /* The entities aren't put in a book, so give them GUIDs by hand. */
+    ents.reserve (count);
+    for (int i = 0; i < count; ++i)
+    {
+        GncGUID guid;
+        guid_replace (&guid);
+        auto ent = static_cast<QofInstance*>(g_object_new (QOF_TYPE_INSTANCE,
+                                                           "guid", &guid, NULL));
+        ent->e_type = PERF_ID;
+        ents.push_back (ent);
+    }
+
+    g_print ("%d entities, each looked up %d times:\n", count, ROUNDS);
+    run_ghash (ents);
+    run_collection (ents, false);
+    run_collection (ents, true);
+
+    qof_close ();
+    return 0;
+}
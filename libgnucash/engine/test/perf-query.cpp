@@ -0,0 +1,127 @@
+/********************************************************************
+ * perf-query.cpp: Time a query over a big book of splits, whose    *
+ * objects qofquery.cpp checks on several threads.                  *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, you can retrieve it from        *
+ * https://www.gnu.org/licenses/old-licenses/gpl-2.0.html            *
+ * or contact:                                                      *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ ********************************************************************/
+
+/* Not run by ctest; build it with "make perf-query" and pass the number
+ * of splits to use, e.g. "perf-query 500000". */
+
+extern "C"
+{
+#include <config.h>
+#include <glib.h>
+#include <stdlib.h>
+#include "qof.h"
+#include "cashobjects.h"
+#include "Query.h"
+#include "Split.h"
+#include "Transaction.h"
+#include "TransLog.h"
+#include "gnc-commodity.h"
+}
+
+#include <thread>
+
+static const char flags[] = { NREC, CREC, YREC };
+
+static void
+make_splits (QofBook *book, gnc_commodity *curr, int count)
+{
+    auto now = gnc_time (NULL);
+
+    for (int i = 0; i < count; ++i)
+    {
+        auto trans = xaccMallocTransaction (book);
+        auto split = xaccMallocSplit (book);
+        auto amount = gnc_numeric_create (g_random_int_range (-100000, 100000),
+                                          100);
+
+        xaccTransBeginEdit (trans);
+        xaccTransSetCurrency (trans, curr);
+        xaccTransSetDatePostedSecs (trans,
+                                    now - g_random_int_range (0, 3650 * 86400));
+        xaccSplitSetParent (split, trans);
+        xaccSplitSetAmount (split, amount);
+        xaccSplitSetValue (split, amount);
+        xaccSplitSetMemo (split, i % 7 ? "groceries" : "rent");
+        xaccSplitSetReconcile (split, flags[i % 3]);
+        xaccTransCommitEdit (trans);
+    }
+}
+
+static void
+count_cb (QofInstance *inst, gpointer data)
+{
+    auto split = reinterpret_cast<Split*>(inst);
+    auto count = static_cast<guint*>(data);
+
+    if (xaccSplitGetReconcile (split) == CREC &&
+        gnc_numeric_positive_p (xaccSplitGetValue (split)) &&
+        g_strcmp0 (xaccSplitGetMemo (split), "groceries") == 0)
+        (*count)++;
+}
+
+int
+main (int argc, char **argv)
+{
+    int count = argc > 1 ? atoi (argv[1]) : 200000;
+
+    qof_init ();
+    if (!cashobjects_register ())
+        return 1;
+    xaccLogDisable ();
+
+    auto session = qof_session_new ();
+    auto book = qof_session_get_book (session);
+    auto curr = gnc_commodity_new (book, "US Dollar", "CURRENCY", "USD",
+                                   "840", 100);
+    make_splits (book, curr, count);
+
+    auto q = qof_query_create_for (GNC_ID_SPLIT);
+    qof_query_set_book (q, book);
+    xaccQueryAddClearedMatch (q, CLEARED_CLEARED, QOF_QUERY_AND);
+    xaccQueryAddValueMatch (q, gnc_numeric_zero (), QOF_NUMERIC_MATCH_ANY,
+                            QOF_COMPARE_GT, QOF_QUERY_AND);
+    xaccQueryAddMemoMatch (q, "groceries", TRUE, FALSE, QOF_COMPARE_EQUAL,
+                           QOF_QUERY_AND);
+
+    guint expected = 0;
+    GTimer *timer = g_timer_new ();
+    qof_collection_foreach (qof_book_get_collection (book, GNC_ID_SPLIT),
+                            count_cb, &expected);
+    g_print ("%d splits, %u processors:\n", count,
+             std::thread::hardware_concurrency ());
+    g_print ("  plain loop:  %10.3f s\n", g_timer_elapsed (timer, NULL));
+
+    g_timer_start (timer);
+    auto found = g_list_length (qof_query_run (q));
+    g_print ("  query:       %10.3f s\n", g_timer_elapsed (timer, NULL));
+    g_timer_destroy (timer);
+
+    if (found != expected)
+        g_print ("  the query found %u splits, not %u!\n", found, expected);
+
+    qof_query_destroy (q);
+    qof_session_destroy (session);
+    qof_close ();
+    return 0;
+}
@@ -1560,6 +1560,65 @@ test_qof_scan_date (void)
     setlocale (LC_TIME, locale);
     g_free (locale);
 }
+/* Printed and scanned dates are cached per format; make sure that
+ * changing the format, the locale or the completion setting throws them
+ * away.
+ */
+static void
+test_qof_date_caches (void)
+{
+    QofDateFormat fmt = qof_date_format_get ();
+    gchar buff[MAX_DATE_LENGTH], t_buff[MAX_DATE_LENGTH];
+    gchar *locale = g_strdup (setlocale (LC_TIME, NULL));
+    struct tm tm = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, NULL};
+    int day = 0, mo = 0, yr = 0;
+
+    qof_date_format_set (QOF_DATE_FORMAT_US);
+    qof_print_date_dmy_buff (buff, sizeof (buff), 2, 1, 2017);
+    g_assert_cmpstr (buff, ==, "01/02/2017");
+    g_assert (qof_scan_date ("01/02/2017", &day, &mo, &yr));
+    g_assert_cmpint (day, ==, 2);
+    g_assert_cmpint (mo, ==, 1);
+    g_assert_cmpint (yr, ==, 2017);
+    /* Again, from the cache. */
+    day = mo = yr = 0;
+    g_assert (qof_scan_date ("01/02/2017", &day, &mo, &yr));
+    g_assert_cmpint (day, ==, 2);
+    g_assert_cmpint (mo, ==, 1);
+    g_assert_cmpint (yr, ==, 2017);
+
+    qof_date_format_set (QOF_DATE_FORMAT_UK);
+    qof_print_date_dmy_buff (buff, sizeof (buff), 2, 1, 2017);
+    g_assert_cmpstr (buff, ==, "02/01/2017");
+    g_assert (qof_scan_date ("01/02/2017", &day, &mo, &yr));
+    g_assert_cmpint (day, ==, 1);
+    g_assert_cmpint (mo, ==, 2);
+    g_assert_cmpint (yr, ==, 2017);
+
+    qof_date_format_set (QOF_DATE_FORMAT_ISO);
+    qof_print_date_dmy_buff (buff, sizeof (buff), 2, 1, 2017);
+    g_assert_cmpstr (buff, ==, "2017-01-02");
+
+    /* The same day printed after a change of locale. */
+    qof_date_format_set (QOF_DATE_FORMAT_LOCALE);
+    tm_set_dmy (&tm, 1974, 11, 23);
+    test_gnc_setlocale (LC_TIME, "en_US");
+    strftime (t_buff, MAX_DATE_LENGTH, GNC_D_FMT, &tm);
+    qof_print_date_dmy_buff (buff, sizeof (buff), 23, 11, 1974);
+    g_assert_cmpstr (buff, ==, t_buff);
+    test_gnc_setlocale (LC_TIME, "en_GB");
+    strftime (t_buff, MAX_DATE_LENGTH, GNC_D_FMT, &tm);
+    qof_print_date_dmy_buff (buff, sizeof (buff), 23, 11, 1974);
+    g_assert_cmpstr (buff, ==, t_buff);
+    test_gnc_setlocale (LC_TIME, "fr_FR");
+    strftime (t_buff, MAX_DATE_LENGTH, GNC_D_FMT, &tm);
+    qof_print_date_dmy_buff (buff, sizeof (buff), 23, 11, 1974);
+    g_assert_cmpstr (buff, ==, t_buff);
+
+    setlocale (LC_TIME, locale);
+    g_free (locale);
+    qof_date_format_set (fmt);
+}
 /* dateSeparator
 return date character
 char dateSeparator (void)// C: 1  Local: 0:0:0
@@ -2263,6 +2322,7 @@ test_suite_gnc_date (void)
 // GNC_TEST_ADD_FUNC (suitename, "floordiv", test_floordiv);
 // GNC_TEST_ADD_FUNC (suitename, "qof scan date internal", test_qof_scan_date_internal);
     GNC_TEST_ADD_FUNC (suitename, "qof scan date", test_qof_scan_date);
+    GNC_TEST_ADD_FUNC (suitename, "qof date caches", test_qof_date_caches);
 // GNC_TEST_ADD_FUNC (suitename, "dateSeparator", test_dateSeparator);
 // GNC_TEST_ADD_FUNC (suitename, "qof time format from utf8", test_qof_time_format_from_utf8);
 // GNC_TEST_ADD_FUNC (suitename, "qof formatted time to utf8", test_qof_formatted_time_to_utf8);
@@ -89,6 +89,20 @@ TEST (GncGUID, from_string)
         EXPECT_FALSE (fail) << "Perhaps boost uuid is fixed.";
 }
 
+TEST (GncGUID, from_string_forms)
+{
+    std::string lower {"0123456789abcdef1234567890abcdef"};
+    auto guid = gnc::GUID::from_string (lower);
+    EXPECT_EQ (guid.to_string (), lower);
+    EXPECT_EQ (gnc::GUID::from_string ("0123456789ABCDEF1234567890ABCDEF"),
+               guid);
+    EXPECT_EQ (gnc::GUID::from_string ("01234567-89ab-cdef-1234-567890abcdef"),
+               guid);
+    EXPECT_TRUE (gnc::GUID::is_valid_guid (lower));
+    if (BOOST_VERSION >= 106600)
+        EXPECT_FALSE (gnc::GUID::is_valid_guid ("0123456789abcdef1234567890abcdeg"));
+}
+
 TEST (GncGUID, round_trip)
 {
     auto guid1 = gnc::GUID::create_random ();
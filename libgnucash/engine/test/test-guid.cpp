@@ -36,6 +36,8 @@ extern "C"
 #include "test-engine-stuff.h"
 #include "qof.h"
 }
+#include <vector>
+
 #define NENT 50123
 
 static void test_null_guid(void)
@@ -88,6 +90,47 @@ run_test (void)
     qof_session_destroy(sess);
 }
 
+/* Removing entities mustn't lose any of the others in the table. */
+static void
+run_remove_test (void)
+{
+    QofSession *sess = get_random_session ();
+    QofBook *book = qof_session_get_book (sess);
+    QofCollection *col = qof_book_get_collection (book, "qwer");
+    QofIdType type = qof_collection_get_type (col);
+    std::vector<QofInstance*> ents;
+    int i;
+
+    qof_collection_reserve (col, NENT / 2);
+    for (i = 0; i < NENT; i++)
+    {
+        GncGUID guid;
+        guid_replace (&guid);
+        auto ent = static_cast<QofInstance*>(g_object_new(QOF_TYPE_INSTANCE,
+                                                          "guid", &guid, NULL));
+        ent->e_type = type;
+        qof_collection_insert_entity (col, ent);
+        ents.push_back (ent);
+    }
+    do_test (qof_collection_count (col) == NENT, "wrong count after inserts");
+
+    for (i = 0; i < NENT; i += 2)
+        qof_collection_remove_entity (ents[i]);
+    do_test (qof_collection_count (col) == NENT - (NENT + 1) / 2,
+             "wrong count after removals");
+
+    for (i = 0; i < NENT; i++)
+    {
+        auto found = qof_collection_lookup_entity (col, qof_instance_get_guid (ents[i]));
+        if (i % 2)
+            do_test (found == ents[i], "kept guid not found");
+        else
+            do_test (found == NULL, "removed guid found");
+    }
+
+    qof_session_destroy (sess);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -96,6 +139,7 @@ main (int argc, char **argv)
     {
         test_null_guid();
         run_test ();
+        run_remove_test ();
         print_test_results();
     }
     qof_close();
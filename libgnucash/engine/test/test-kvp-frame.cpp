@@ -181,6 +181,22 @@ TEST_F (KvpFrameTest, GetSlotPath)
     EXPECT_EQ (v1, t_root.get_slot(path3a));
 }
 
+TEST_F (KvpFrameTest, GetSlotKey)
+{
+    auto f1 = t_root.get_slot("top")->get<KvpFrame*>();
+    auto v1 = new KvpValueImpl {15.0};
+
+    EXPECT_EQ (nullptr, t_root.get_slot("first"));
+    EXPECT_EQ (t_int_val, f1->get_slot("first"));
+    EXPECT_EQ (t_int_val, f1->set({"first"}, v1));
+    EXPECT_EQ (v1, f1->get_slot("first"));
+    EXPECT_EQ (t_str_val, f1->get_slot("third"));
+    f1->set({"aaa"}, new KvpValue{new KvpFrame});
+    auto keys = f1->get_keys();
+    EXPECT_TRUE (std::is_sorted (keys.begin(), keys.end()));
+    delete t_int_val;
+}
+
 TEST_F (KvpFrameTest, Empty)
 {
     KvpFrameImpl f1, f2;
@@ -664,6 +664,60 @@ check_add_subtract_overflow (void)
 
 /* ======================================================= */
 
+static void
+check_sum (void)
+{
+    gnc_numeric a = gnc_numeric_create(123, 100);
+    gnc_numeric b = gnc_numeric_create(-456, 100);
+    gnc_numeric c = gnc_numeric_create(7, 3);
+    gnc_numeric z = gnc_numeric_create(0, 3);
+    gnc_numeric big = gnc_numeric_create(G_MAXINT64 - 8, 100);
+    gnc_numeric small = gnc_numeric_create(20, 100);
+    gnc_numeric values[] = {a, b, a, a, b};
+    gnc_numeric mixed[] = {a, c, b};
+    gnc_numeric result;
+
+    /* Same denominator, lcd or fixed. */
+    check_binary_op (gnc_numeric_create(-333, 100),
+                     gnc_numeric_add(a, b, GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD),
+                     a, b, "expected %s got %s = %s + %s for add lcd");
+    check_binary_op (gnc_numeric_create(579, 100),
+                     gnc_numeric_sub(a, b, 100, GNC_HOW_DENOM_FIXED),
+                     a, b, "expected %s got %s = %s - %s for sub fixed");
+    check_binary_op (gnc_numeric_create(579, 100),
+                     gnc_numeric_sub_fixed(a, b),
+                     a, b, "expected %s got %s = %s - %s for sub fixed");
+
+    /* Adding zero with another denominator. */
+    check_binary_op (a, gnc_numeric_add_fixed(a, z),
+                     a, z, "expected %s got %s = %s + %s for add fixed");
+    check_binary_op (a, gnc_numeric_add_fixed(z, a),
+                     z, a, "expected %s got %s = %s + %s for add fixed");
+
+    /* A numerator overflow still goes through the general code. */
+    result = gnc_numeric_add_fixed(big, small);
+    do_test (gnc_numeric_check(result) != GNC_ERROR_OK,
+             "same denominator overflow raises an error");
+
+    /* Batch sums agree with adding the values in turn. */
+    check_binary_op (gnc_numeric_create(-543, 100),
+                     gnc_numeric_sum(values, G_N_ELEMENTS(values),
+                                     GNC_DENOM_AUTO, GNC_HOW_DENOM_FIXED),
+                     a, b, "expected %s got %s = sum of %s and %s");
+    check_binary_op (gnc_numeric_add(gnc_numeric_add(a, c, GNC_DENOM_AUTO,
+                                                     GNC_HOW_DENOM_LCD),
+                                     b, GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD),
+                     gnc_numeric_sum(mixed, G_N_ELEMENTS(mixed),
+                                     GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD),
+                     a, c, "expected %s got %s = sum of %s and %s");
+    check_binary_op (gnc_numeric_zero(),
+                     gnc_numeric_sum(NULL, 0, GNC_DENOM_AUTO,
+                                     GNC_HOW_DENOM_FIXED),
+                     a, b, "expected %s got %s = empty sum");
+}
+
+/* ======================================================= */
+
 
 static void
 check_mult_div (void)
@@ -898,6 +952,7 @@ run_test (void)
     check_neg();
     check_add_subtract();
     check_add_subtract_overflow ();
+    check_sum ();
     check_mult_div ();
 }
 
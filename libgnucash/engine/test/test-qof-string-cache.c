@@ -77,8 +77,68 @@ test_qof_string_cache( void )
     g_assert(str1_1 != str1_4);
 }
 
+static void
+test_qof_string_cache_ref( void )
+{
+    gchar* str1_1 = qof_string_cache_insert("str1"); /* Refcount = 1 */
+    gchar* str1_2 = qof_string_cache_ref(str1_1);    /* Refcount = 2 */
+    g_assert(str1_1 == str1_2);
+    qof_string_cache_remove("str1");                 /* Refcount = 1 */
+    g_assert(qof_string_cache_insert("str1") == str1_1); /* Refcount = 2 */
+    qof_string_cache_remove(str1_1);                 /* Refcount = 1 */
+    qof_string_cache_remove(str1_2);                 /* Refcount = 0 */
+    g_assert(qof_string_cache_ref(NULL) == NULL);
+}
+
+#define CACHE_THREADS 4
+#define CACHE_STRINGS 500
+
+static gpointer
+insert_and_remove( gpointer data )
+{
+    gchar** cached = (gchar**)data;
+    gchar str[20];
+    gint i, j;
+
+    for (j = 0; j < 20; ++j)
+        for (i = 0; i < CACHE_STRINGS; ++i)
+        {
+            gchar* ins;
+            g_snprintf(str, sizeof(str), "str%d", i);
+            ins = qof_string_cache_insert(str);
+            if (ins != cached[i])
+                return GINT_TO_POINTER(FALSE);
+            qof_string_cache_remove(ins);
+        }
+    return GINT_TO_POINTER(TRUE);
+}
+
+static void
+test_qof_string_cache_threads( void )
+{
+    /* Every thread must get the same address for the same string. */
+    gchar* cached[CACHE_STRINGS];
+    GThread* threads[CACHE_THREADS];
+    gchar str[20];
+    gint i;
+
+    for (i = 0; i < CACHE_STRINGS; ++i)
+    {
+        g_snprintf(str, sizeof(str), "str%d", i);
+        cached[i] = qof_string_cache_insert(str);
+    }
+    for (i = 0; i < CACHE_THREADS; ++i)
+        threads[i] = g_thread_new("string-cache", insert_and_remove, cached);
+    for (i = 0; i < CACHE_THREADS; ++i)
+        g_assert(g_thread_join(threads[i]));
+    for (i = 0; i < CACHE_STRINGS; ++i)
+        qof_string_cache_remove(cached[i]);
+}
+
 void
 test_suite_qof_string_cache ( void )
 {
     GNC_TEST_ADD_FUNC( suitename, "string-cache", test_qof_string_cache);
+    GNC_TEST_ADD_FUNC( suitename, "string-cache ref", test_qof_string_cache_ref);
+    GNC_TEST_ADD_FUNC( suitename, "string-cache threads", test_qof_string_cache_threads);
 }
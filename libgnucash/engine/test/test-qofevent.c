@@ -0,0 +1,196 @@
+/********************************************************************
+ * test-qofevent.c: GLib g_test test suite for qofevent.cpp         *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+#include <config.h>
+#include <glib.h>
+#include <unittest-support.h>
+#include "qof.h"
+
+static const gchar *suitename = "/qof/qofevent";
+void test_suite_qofevent ( void );
+
+typedef struct
+{
+    QofInstance *a;
+    QofInstance *b;
+    GList *seen;        /* of EventSeen, newest first */
+} Fixture;
+
+typedef struct
+{
+    QofInstance *inst;
+    QofEventId event;
+} EventSeen;
+
+static void
+setup( Fixture *fixture, gconstpointer pData )
+{
+    fixture->a = g_object_new (QOF_TYPE_INSTANCE, NULL);
+    fixture->a->e_type = "test-a";
+    fixture->b = g_object_new (QOF_TYPE_INSTANCE, NULL);
+    fixture->b->e_type = "test-b";
+    fixture->seen = NULL;
+}
+
+static void
+teardown( Fixture *fixture, gconstpointer pData )
+{
+    g_object_unref (fixture->a);
+    g_object_unref (fixture->b);
+    g_list_free_full (fixture->seen, g_free);
+}
+
+static void
+record_event (QofInstance *inst, QofEventId event, gpointer user_data,
+              gpointer event_data)
+{
+    Fixture *fixture = user_data;
+    EventSeen *seen = g_new (EventSeen, 1);
+
+    seen->inst = inst;
+    seen->event = event;
+    fixture->seen = g_list_prepend (fixture->seen, seen);
+}
+
+static void
+assert_seen (Fixture *fixture, guint index, QofInstance *inst,
+             QofEventId event)
+{
+    GList *node = g_list_nth (fixture->seen,
+                              g_list_length (fixture->seen) - 1 - index);
+    EventSeen *seen;
+
+    g_assert (node);
+    seen = node->data;
+    g_assert (seen->inst == inst);
+    g_assert_cmpint (seen->event, ==, event);
+}
+
+static void
+test_event_type_handler( Fixture *fixture, gconstpointer pData )
+{
+    gint id = qof_event_register_type_handler ("test-a",
+                                               QOF_EVENT_MODIFY |
+                                               QOF_EVENT_DESTROY,
+                                               record_event, fixture);
+    g_assert_cmpint (id, !=, 0);
+
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    qof_event_gen (fixture->b, QOF_EVENT_MODIFY, NULL);
+    qof_event_gen (fixture->a, QOF_EVENT_CREATE, NULL);
+    qof_event_gen (fixture->a, QOF_EVENT_DESTROY, NULL);
+    g_assert_cmpint (g_list_length (fixture->seen), ==, 2);
+    assert_seen (fixture, 0, fixture->a, QOF_EVENT_MODIFY);
+    assert_seen (fixture, 1, fixture->a, QOF_EVENT_DESTROY);
+
+    qof_event_unregister_handler (id);
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    g_assert_cmpint (g_list_length (fixture->seen), ==, 2);
+}
+
+/* A type handler and an ordinary one mustn't be given the same id. */
+static void
+test_event_handler_ids( Fixture *fixture, gconstpointer pData )
+{
+    gint id1 = qof_event_register_type_handler ("test-a", QOF_EVENT_ALL,
+                                                record_event, fixture);
+    gint id2 = qof_event_register_handler (record_event, fixture);
+
+    g_assert_cmpint (id1, !=, id2);
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    g_assert_cmpint (g_list_length (fixture->seen), ==, 2);
+
+    qof_event_unregister_handler (id1);
+    qof_event_unregister_handler (id2);
+}
+
+static void
+test_event_batch( Fixture *fixture, gconstpointer pData )
+{
+    gint id = qof_event_register_handler (record_event, fixture);
+    gint data = 0;
+
+    qof_event_begin_batch ();
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    qof_event_gen (fixture->b, QOF_EVENT_CREATE, NULL);
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    qof_event_begin_batch ();
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    qof_event_end_batch ();
+    g_assert (fixture->seen == NULL);
+
+    /* Events with data go at once and leave those held back held, so
+     * that they still merge with later ones. */
+    qof_event_gen (fixture->b, QOF_EVENT_ADD, &data);
+    g_assert_cmpint (g_list_length (fixture->seen), ==, 1);
+    assert_seen (fixture, 0, fixture->b, QOF_EVENT_ADD);
+
+    qof_event_gen (fixture->b, QOF_EVENT_MODIFY, NULL);
+    qof_event_gen (fixture->b, QOF_EVENT_ADD, &data);
+    qof_event_gen (fixture->b, QOF_EVENT_MODIFY, NULL);
+    qof_event_end_batch ();
+    g_assert_cmpint (g_list_length (fixture->seen), ==, 5);
+    assert_seen (fixture, 1, fixture->b, QOF_EVENT_ADD);
+    assert_seen (fixture, 2, fixture->a, QOF_EVENT_MODIFY);
+    assert_seen (fixture, 3, fixture->b, QOF_EVENT_CREATE);
+    assert_seen (fixture, 4, fixture->b, QOF_EVENT_MODIFY);
+
+    qof_event_unregister_handler (id);
+}
+
+static void
+test_event_batch_destroy( Fixture *fixture, gconstpointer pData )
+{
+    gint id = qof_event_register_handler (record_event, fixture);
+
+    qof_event_begin_batch ();
+    qof_event_gen (fixture->a, QOF_EVENT_CREATE, NULL);
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    qof_event_gen (fixture->a, QOF_EVENT_DESTROY, NULL);
+    g_assert_cmpint (g_list_length (fixture->seen), ==, 3);
+    assert_seen (fixture, 0, fixture->a, QOF_EVENT_CREATE);
+    assert_seen (fixture, 1, fixture->a, QOF_EVENT_MODIFY);
+    assert_seen (fixture, 2, fixture->a, QOF_EVENT_DESTROY);
+    qof_event_end_batch ();
+    g_assert_cmpint (g_list_length (fixture->seen), ==, 3);
+
+    /* Nothing is delivered while events are suspended, not even what
+     * was held back for an object that is destroyed. */
+    qof_event_begin_batch ();
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    qof_event_suspend ();
+    qof_event_gen (fixture->a, QOF_EVENT_DESTROY, NULL);
+    g_assert_cmpint (g_list_length (fixture->seen), ==, 3);
+    qof_event_resume ();
+    qof_event_end_batch ();
+    g_assert_cmpint (g_list_length (fixture->seen), ==, 3);
+
+    qof_event_unregister_handler (id);
+}
+
+void
+test_suite_qofevent ( void )
+{
+    GNC_TEST_ADD( suitename, "type handler", Fixture, NULL, setup, test_event_type_handler, teardown );
+    GNC_TEST_ADD( suitename, "handler ids", Fixture, NULL, setup, test_event_handler_ids, teardown );
+    GNC_TEST_ADD( suitename, "batch", Fixture, NULL, setup, test_event_batch, teardown );
+    GNC_TEST_ADD( suitename, "batch destroy", Fixture, NULL, setup, test_event_batch_destroy, teardown );
+}
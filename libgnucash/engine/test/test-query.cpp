@@ -27,6 +27,8 @@ extern "C"
 #include "qof.h"
 #include "cashobjects.h"
 #include "Transaction.h"
+#include "Query.h"
+#include "qofquery-p.h"
 #include "TransLog.h"
 #include "gnc-engine.h"
 #include "test-engine-stuff.h"
@@ -67,6 +69,288 @@ test_trans_query (Transaction *trans, gpointer data)
     return 0;
 }
 
+typedef struct
+{
+    Account *acc1;
+    Account *acc2;
+    time64 start;
+    time64 end;
+    guint count;
+} RangeData;
+
+static gboolean
+split_in_range (Split *split, const RangeData *data)
+{
+    Account *acc = xaccSplitGetAccount (split);
+    Transaction *trans = xaccSplitGetParent (split);
+    time64 posted;
+
+    if (!acc || !trans)
+        return FALSE;
+    if (data->acc1 && acc != data->acc1 && acc != data->acc2)
+        return FALSE;
+    posted = xaccTransGetDate (trans);
+    return posted >= data->start && posted <= data->end;
+}
+
+static void
+count_in_range (QofInstance *inst, gpointer user_data)
+{
+    RangeData *data = (RangeData*)user_data;
+
+    if (split_in_range (GNC_SPLIT (inst), data))
+        ++data->count;
+}
+
+/* The split index finds the candidates for account and date terms;
+ * check that it finds the same splits as looking at every one. */
+static void
+test_range_query (QofBook *book, RangeData *data)
+{
+    QofQuery *q = qof_query_create_for (GNC_ID_SPLIT);
+    GList *list, *node;
+    gboolean ok = TRUE;
+
+    qof_query_set_book (q, book);
+    if (data->acc1)
+    {
+        xaccQueryAddSingleAccountMatch (q, data->acc1, QOF_QUERY_AND);
+        xaccQueryAddSingleAccountMatch (q, data->acc2, QOF_QUERY_OR);
+    }
+    xaccQueryAddDateMatchTT (q, TRUE, data->start, TRUE, data->end,
+                             QOF_QUERY_AND);
+
+    data->count = 0;
+    qof_collection_foreach (qof_book_get_collection (book, GNC_ID_SPLIT),
+                            count_in_range, data);
+
+    list = qof_query_run (q);
+    for (node = list; node; node = node->next)
+        ok = ok && split_in_range (GNC_SPLIT (node->data), data);
+    do_test_args (ok && g_list_length (list) == data->count,
+                  "range query", __FILE__, __LINE__,
+                  "%u splits found, %u expected", g_list_length (list),
+                  data->count);
+    qof_query_destroy (q);
+}
+
+static void
+run_range_tests (QofBook *book)
+{
+    QofQuery *q = qof_query_create_for (GNC_ID_SPLIT);
+    GList *splits;
+    RangeData data = { NULL, NULL, 0, 0, 0 };
+    time64 date1, date2;
+    guint n;
+
+    qof_query_set_book (q, book);
+    splits = qof_query_run (q);
+    n = g_list_length (splits);
+    if (n < 2)
+    {
+        qof_query_destroy (q);
+        return;
+    }
+
+    date1 = xaccTransGetDate (xaccSplitGetParent (GNC_SPLIT (g_list_nth_data (splits, n / 3))));
+    date2 = xaccTransGetDate (xaccSplitGetParent (GNC_SPLIT (g_list_nth_data (splits, 2 * n / 3))));
+    data.start = MIN (date1, date2);
+    data.end = MAX (date1, date2);
+    test_range_query (book, &data);
+
+    data.acc1 = xaccSplitGetAccount (GNC_SPLIT (splits->data));
+    data.acc2 = xaccSplitGetAccount (GNC_SPLIT (g_list_last (splits)->data));
+    if (data.acc1 && data.acc2)
+    {
+        GList *node;
+
+        test_range_query (book, &data);
+
+        /* A split moved into acc1 in an edit that is still open isn't
+         * in acc1's split list yet, but the query must find it. */
+        for (node = splits; node; node = node->next)
+        {
+            Split *split = GNC_SPLIT (node->data);
+            Transaction *trans = xaccSplitGetParent (split);
+            Account *acc = xaccSplitGetAccount (split);
+
+            if (!trans || !acc || acc == data.acc1 || acc == data.acc2)
+                continue;
+            data.start = MIN (data.start, xaccTransGetDate (trans));
+            data.end = MAX (data.end, xaccTransGetDate (trans));
+            xaccTransBeginEdit (trans);
+            xaccSplitSetAccount (split, data.acc1);
+            test_range_query (book, &data);
+            xaccTransRollbackEdit (trans);
+            test_range_query (book, &data);
+            break;
+        }
+    }
+
+    qof_query_destroy (q);
+}
+
+/* With max_results set, only the last few matches are sorted; they
+ * must come out just as they would from sorting them all.  Sorting
+ * by reconcile state makes plenty of ties. */
+static void
+test_max_results_sort (QofBook *book, const char *param)
+{
+    QofQuery *q = qof_query_create_for (GNC_ID_SPLIT);
+    GList *all, *last, *node;
+    guint n, k;
+
+    qof_query_set_book (q, book);
+    qof_query_set_sort_order (q, qof_query_build_param_list (param, NULL),
+                              NULL, NULL);
+    all = g_list_copy (qof_query_run (q));
+    n = g_list_length (all);
+    k = n / 5;
+
+    qof_query_set_max_results (q, k);
+    last = qof_query_run (q);
+    do_test_args (g_list_length (last) == k, "max results", __FILE__,
+                  __LINE__, "%u splits, %u expected", g_list_length (last), k);
+    for (node = g_list_nth (all, n - k); node && last;
+         node = node->next, last = last->next)
+        if (node->data != last->data)
+            break;
+    do_test (node == NULL, "max results sort order");
+
+    g_list_free (all);
+    qof_query_destroy (q);
+}
+
+/* A caching query returns its last results until an event says
+ * something it looks at has changed.  Changing a split inside an open
+ * transaction generates no event until the commit. */
+static void
+test_cached_query (QofBook *book)
+{
+    QofQuery *q = qof_query_create_for (GNC_ID_SPLIT);
+    QofQuery *all_q = qof_query_create_for (GNC_ID_SPLIT);
+    const char *memo = "test_cached_query";
+    Split *split;
+    Transaction *trans;
+
+    qof_query_set_book (all_q, book);
+    split = GNC_SPLIT (g_list_nth_data (qof_query_run (all_q), 0));
+    qof_query_destroy (all_q);
+    if (!split || !xaccSplitGetParent (split))
+    {
+        qof_query_destroy (q);
+        return;
+    }
+    trans = xaccSplitGetParent (split);
+
+    qof_query_set_book (q, book);
+    xaccQueryAddMemoMatch (q, memo, TRUE, FALSE, QOF_COMPARE_EQUAL,
+                           QOF_QUERY_AND);
+    qof_query_set_cache_results (q, TRUE);
+    do_test (qof_query_run (q) == NULL, "cached query, no match");
+
+    xaccSplitSetMemo (split, memo);
+    do_test (g_list_length (qof_query_run (q)) == 1 &&
+             qof_query_run (q)->data == split,
+             "cached query sees committed change");
+
+    xaccTransBeginEdit (trans);
+    xaccSplitSetMemo (split, "");
+    do_test (g_list_length (qof_query_run (q)) == 1,
+             "cached query reuses results");
+    xaccTransCommitEdit (trans);
+    do_test (qof_query_run (q) == NULL, "cached query sees commit");
+
+    qof_query_destroy (q);
+}
+
+static void
+count_present_nonnegative (QofInstance *inst, gpointer user_data)
+{
+    Account *acc = xaccSplitGetAccount (GNC_SPLIT (inst));
+
+    if (acc && gnc_numeric_compare (xaccAccountGetPresentBalance (acc),
+                                    gnc_numeric_zero ()) >= 0)
+        ++*(guint*)user_data;
+}
+
+/* Getting an account's present balance sorts its splits, so a query
+ * on it mustn't check splits on several threads, even for a book with
+ * enough splits that one on the splits' own fields would. */
+static void
+run_parallel_test (void)
+{
+    QofSession *session = get_random_session ();
+    QofBook *book = qof_session_get_book (session);
+    Account *root = gnc_book_get_root_account (book);
+    gnc_commodity *comm = get_random_commodity (book);
+    Account *acc1 = xaccMallocAccount (book);
+    Account *acc2 = xaccMallocAccount (book);
+    QofQuery *q;
+    guint count = 0;
+    int i;
+
+    xaccAccountBeginEdit (acc1);
+    xaccAccountSetCommodity (acc1, comm);
+    gnc_account_append_child (root, acc1);
+    xaccAccountCommitEdit (acc1);
+    xaccAccountBeginEdit (acc2);
+    xaccAccountSetCommodity (acc2, comm);
+    gnc_account_append_child (root, acc2);
+    xaccAccountCommitEdit (acc2);
+
+    /* The splits are added to the accounts in random date order, so
+     * both accounts will have to sort them. */
+    for (i = 0; i < 10000; i++)
+    {
+        Transaction *trans = xaccMallocTransaction (book);
+        Split *split1 = xaccMallocSplit (book);
+        Split *split2 = xaccMallocSplit (book);
+        gnc_numeric amount = gnc_numeric_create (rand () % 2001 - 1000, 1);
+
+        xaccTransBeginEdit (trans);
+        xaccTransSetCurrency (trans, comm);
+        xaccTransSetDatePostedSecs (trans, (time64)(rand () % 3650) * 86400);
+        xaccSplitSetParent (split1, trans);
+        xaccSplitSetParent (split2, trans);
+        xaccSplitSetAccount (split1, acc1);
+        xaccSplitSetAccount (split2, acc2);
+        xaccSplitSetAmount (split1, amount);
+        xaccSplitSetValue (split1, amount);
+        xaccSplitSetAmount (split2, gnc_numeric_neg (amount));
+        xaccSplitSetValue (split2, gnc_numeric_neg (amount));
+        xaccTransCommitEdit (trans);
+    }
+
+    q = qof_query_create_for (GNC_ID_SPLIT);
+    qof_query_set_book (q, book);
+    qof_query_add_term (q, qof_query_build_param_list (SPLIT_ACCOUNT,
+                                                       ACCOUNT_PRESENT_,
+                                                       NULL),
+                        qof_query_numeric_predicate (QOF_COMPARE_GTE,
+                                                     QOF_NUMERIC_MATCH_ANY,
+                                                     gnc_numeric_zero ()),
+                        QOF_QUERY_AND);
+    do_test (!qof_query_is_thread_safe (q), "balance query isn't thread safe");
+    qof_collection_foreach (qof_book_get_collection (book, GNC_ID_SPLIT),
+                            count_present_nonnegative, &count);
+    do_test_args (g_list_length (qof_query_run (q)) == count, "balance query",
+                  __FILE__, __LINE__, "%u splits found, %u expected",
+                  g_list_length (qof_query_run (q)), count);
+    qof_query_destroy (q);
+
+    q = qof_query_create_for (GNC_ID_SPLIT);
+    qof_query_set_book (q, book);
+    xaccQueryAddSingleAccountMatch (q, acc1, QOF_QUERY_AND);
+    xaccQueryAddMemoMatch (q, "", TRUE, FALSE, QOF_COMPARE_EQUAL,
+                           QOF_QUERY_AND);
+    do_test (qof_query_is_thread_safe (q), "memo query is thread safe");
+    do_test (g_list_length (qof_query_run (q)) == 10000, "memo query");
+    qof_query_destroy (q);
+
+    qof_session_end (session);
+}
+
 static void
 run_test (void)
 {
@@ -81,6 +365,10 @@ run_test (void)
     add_random_transactions_to_book (book, 20);
 
     xaccAccountTreeForEachTransaction (root, test_trans_query, book);
+    run_range_tests (book);
+    test_max_results_sort (book, SPLIT_RECONCILE);
+    test_max_results_sort (book, QUERY_DEFAULT_SORT);
+    test_cached_query (book);
 
     qof_session_end (session);
 }
@@ -108,6 +396,7 @@ main (int argc, char **argv)
     {
         run_test ();
     }
+    run_parallel_test ();
     success("queries seem to work");
 
 cleanup:
@@ -887,7 +887,7 @@ test_xaccFreeAccount (Fixture *fixture, gconstpointer pData)
     /* Check that we've got children, lots, and splits to remove */
     g_assert (p_priv->children != NULL);
     g_assert (p_priv->lots != NULL);
-    g_assert (p_priv->splits != NULL);
+    g_assert (!p_priv->splits.empty());
     g_assert (p_priv->parent != NULL);
     g_assert (p_priv->commodity != NULL);
     g_assert_cmpint (check1->hits, ==, 0);
@@ -1002,7 +1002,7 @@ test_xaccAccountCommitEdit (Fixture *fixture, gconstpointer pData)
     /* Check that we've got children, lots, and splits to remove */
     g_assert (p_priv->children != NULL);
     g_assert (p_priv->lots != NULL);
-    g_assert (p_priv->splits != NULL);
+    g_assert (!p_priv->splits.empty());
     g_assert (p_priv->parent != NULL);
     g_assert (p_priv->commodity != NULL);
     g_assert_cmpint (check1->hits, ==, 0);
@@ -1018,7 +1018,7 @@ test_xaccAccountCommitEdit (Fixture *fixture, gconstpointer pData)
     test_signal_assert_hits (sig2, 0);
     g_assert (p_priv->children != NULL);
     g_assert (p_priv->lots != NULL);
-    g_assert (p_priv->splits != NULL);
+    g_assert (!p_priv->splits.empty());
     g_assert (p_priv->parent != NULL);
     g_assert (p_priv->commodity != NULL);
     g_assert_cmpint (check1->hits, ==, 0);
@@ -1082,6 +1082,7 @@ test_gnc_account_insert_remove_split (Fixture *fixture, gconstpointer pData)
     Split *split2 = xaccMallocSplit (book);
     Split *split3 = xaccMallocSplit (book);
     TestSignal sig1, sig2, sig3;
+    GList *slist;
     AccountPrivate *priv = fixture->func->get_private (fixture->acct);
     auto msg1 = ": assertion 'GNC_IS_ACCOUNT(acc)' failed";
     auto msg2 = ": assertion 'GNC_IS_SPLIT(s)' failed";
@@ -1102,19 +1103,19 @@ test_gnc_account_insert_remove_split (Fixture *fixture, gconstpointer pData)
 
     /* Check that the call fails with invalid account and split (throws) */
     g_assert (!gnc_account_insert_split (NULL, split1));
-    g_assert_cmpuint (g_list_length (priv->splits), == , 0);
+    g_assert_cmpuint (priv->splits.size(), == , 0);
     g_assert (!priv->sort_dirty);
     g_assert (!priv->balance_dirty);
     test_signal_assert_hits (sig1, 0);
     test_signal_assert_hits (sig2, 0);
     g_assert (!gnc_account_insert_split (fixture->acct, NULL));
-    g_assert_cmpuint (g_list_length (priv->splits), == , 0);
+    g_assert_cmpuint (priv->splits.size(), == , 0);
     g_assert (!priv->sort_dirty);
     g_assert (!priv->balance_dirty);
     test_signal_assert_hits (sig1, 0);
     test_signal_assert_hits (sig2, 0);
     /* g_assert (!gnc_account_insert_split (fixture->acct, (Split*)priv)); */
-    /* g_assert_cmpuint (g_list_length (priv->splits), == , 0); */
+    /* g_assert_cmpuint (priv->splits.size(), == , 0); */
     /* g_assert (!priv->sort_dirty); */
     /* g_assert (!priv->balance_dirty); */
     /* test_signal_assert_hits (sig1, 0); */
@@ -1127,7 +1128,7 @@ test_gnc_account_insert_remove_split (Fixture *fixture, gconstpointer pData)
 
     /* Check that it works the first time */
     g_assert (gnc_account_insert_split (fixture->acct, split1));
-    g_assert_cmpuint (g_list_length (priv->splits), == , 1);
+    g_assert_cmpuint (priv->splits.size(), == , 1);
     g_assert (!priv->sort_dirty);
     g_assert (priv->balance_dirty);
     test_signal_assert_hits (sig1, 1);
@@ -1139,7 +1140,7 @@ test_gnc_account_insert_remove_split (Fixture *fixture, gconstpointer pData)
     sig3 = test_signal_new (&fixture->acct->inst, GNC_EVENT_ITEM_ADDED, split2);
     /* Now add a second split to the account and check that sort_dirty isn't set. We have to bump the editlevel to force this. */
     g_assert (gnc_account_insert_split (fixture->acct, split2));
-    g_assert_cmpuint (g_list_length (priv->splits), == , 2);
+    g_assert_cmpuint (priv->splits.size(), == , 2);
     g_assert (!priv->sort_dirty);
     g_assert (priv->balance_dirty);
     test_signal_assert_hits (sig1, 2);
@@ -1150,7 +1151,7 @@ test_gnc_account_insert_remove_split (Fixture *fixture, gconstpointer pData)
     qof_instance_increase_editlevel (fixture->acct);
     g_assert (gnc_account_insert_split (fixture->acct, split3));
     qof_instance_decrease_editlevel (fixture->acct);
-    g_assert_cmpuint (g_list_length (priv->splits), == , 3);
+    g_assert_cmpuint (priv->splits.size(), == , 3);
     g_assert (priv->sort_dirty);
     g_assert (priv->balance_dirty);
     test_signal_assert_hits (sig1, 3);
@@ -1161,7 +1162,7 @@ test_gnc_account_insert_remove_split (Fixture *fixture, gconstpointer pData)
     sig3 = test_signal_new (&fixture->acct->inst, GNC_EVENT_ITEM_REMOVED,
                             split3);
     g_assert (gnc_account_remove_split (fixture->acct, split3));
-    g_assert_cmpuint (g_list_length (priv->splits), == , 2);
+    g_assert_cmpuint (priv->splits.size(), == , 2);
     g_assert (priv->sort_dirty);
     g_assert (!priv->balance_dirty);
     test_signal_assert_hits (sig1, 4);
@@ -1169,11 +1170,26 @@ test_gnc_account_insert_remove_split (Fixture *fixture, gconstpointer pData)
     /* And do it again to make sure that it fails when the split has
      * already been removed */
     g_assert (!gnc_account_remove_split (fixture->acct, split3));
-    g_assert_cmpuint (g_list_length (priv->splits), == , 2);
+    g_assert_cmpuint (priv->splits.size(), == , 2);
     g_assert (priv->sort_dirty);
     g_assert (!priv->balance_dirty);
     test_signal_assert_hits (sig1, 4);
     test_signal_assert_hits (sig3, 1);
+    /* The list from xaccAccountGetSplitList has to follow the splits
+     * as they're added and removed. */
+    slist = xaccAccountGetSplitList (fixture->acct);
+    g_assert (!priv->sort_dirty);
+    g_assert_cmpuint (g_list_length (slist), == , 2);
+    g_assert (gnc_account_insert_split (fixture->acct, split3));
+    g_assert (gnc_account_remove_split (fixture->acct, split1));
+    slist = priv->split_list;
+    g_assert_cmpuint (g_list_length (slist), == , priv->splits.size());
+    for (auto s : priv->splits)
+    {
+        g_assert (slist->data == s);
+        slist = slist->next;
+    }
+    g_assert (xaccAccountGetSplitList (fixture->acct) == priv->split_list);
 
     /* Clean up the handlers */
     test_signal_free (sig3);
@@ -1183,8 +1199,48 @@ test_gnc_account_insert_remove_split (Fixture *fixture, gconstpointer pData)
 void
 xaccAccountSortSplits (Account *acc, gboolean force)// C: 4 in 2
 Make static?
-Passthrough, no test.
+Only the duplicate removal is tested here.
 */
+static void
+test_xaccAccountSortSplits_duplicate (Fixture *fixture, gconstpointer pData)
+{
+    QofBook *book = gnc_account_get_book (fixture->acct);
+    Split *split1 = xaccMallocSplit (book);
+    Split *split2 = xaccMallocSplit (book);
+    AccountPrivate *priv = fixture->func->get_private (fixture->acct);
+    auto loglevel = static_cast<GLogLevelFlags>(G_LOG_LEVEL_CRITICAL | G_LOG_FLAG_FATAL);
+    auto check = test_error_struct_new ("gnc.engine", loglevel,
+                                        "duplicate splits");
+    GLogFunc oldlogger;
+    GList *slist;
+
+    g_assert (gnc_account_insert_split (fixture->acct, split1));
+    /* Inside an edit the second insert can't see the first once
+     * sort_dirty is set, so the split is appended twice. */
+    qof_instance_increase_editlevel (fixture->acct);
+    g_assert (gnc_account_insert_split (fixture->acct, split2));
+    g_assert (priv->sort_dirty);
+    g_assert (gnc_account_insert_split (fixture->acct, split2));
+    qof_instance_decrease_editlevel (fixture->acct);
+    g_assert_cmpuint (priv->splits.size(), == , 3);
+
+    oldlogger = g_log_set_default_handler ((GLogFunc)test_null_handler, check);
+    g_test_log_set_fatal_handler ((GTestLogFatalFunc)test_checked_substring_handler, check);
+    xaccAccountSortSplits (fixture->acct, TRUE);
+    g_log_set_default_handler (oldlogger, NULL);
+    g_assert_cmpint (check->hits, ==, 1);
+    g_assert (!priv->sort_dirty);
+    g_assert_cmpuint (priv->splits.size(), == , 2);
+    g_assert (priv->splits[0] != priv->splits[1]);
+    slist = xaccAccountGetSplitList (fixture->acct);
+    g_assert_cmpuint (g_list_length (slist), == , 2);
+    for (auto s : priv->splits)
+    {
+        g_assert (slist->data == s);
+        slist = slist->next;
+    }
+    test_error_struct_free (check);
+}
 /* xaccAccountBringUpToDate
 static void
 xaccAccountBringUpToDate (Account *acc)// 3
@@ -1327,6 +1383,23 @@ test_xaccAccountRecomputeBalance (Fixture *fixture, gconstpointer pData)
     g_assert (gnc_numeric_eq (priv->cleared_balance, clr_bal));
     g_assert (gnc_numeric_eq (priv->reconciled_balance, rec_bal));
     g_assert (!priv->balance_dirty);
+    /* Changing a split recomputes only from there on, which must come
+     * to the same as starting over. */
+    xaccAccountSortSplits (fixture->acct, TRUE);
+    xaccAccountRecomputeBalance (fixture->acct);
+    xaccSplitSetReconcile (priv->splits[1], NREC);
+    g_assert (!priv->balance_dirty);
+    clr_bal = gnc_numeric_zero ();
+    for (auto split : priv->splits)
+    {
+        if (xaccSplitGetReconcile (split) != NREC)
+            clr_bal = gnc_numeric_add_fixed (clr_bal,
+                                             xaccSplitGetAmount (split));
+        g_assert (gnc_numeric_eq (xaccSplitGetClearedBalance (split),
+                                  clr_bal));
+    }
+    g_assert (gnc_numeric_eq (priv->cleared_balance, clr_bal));
+    g_assert (gnc_numeric_eq (priv->balance, bal));
 }
 
 /* xaccAccountOrder
@@ -1638,6 +1711,37 @@ test_gnc_account_get_descendants_sorted (Fixture *fixture, gconstpointer pData)
     g_assert_cmpint (g_list_index (list, fixture->acct), == , 10);
     g_list_free (list);
 }
+/* The descendant lists come from arrays cached for each tree, which have
+ * to be rebuilt when accounts move or change their sort keys. */
+static void
+test_gnc_account_descendants_after_changes (Fixture *fixture, gconstpointer pData)
+{
+    Account *root = gnc_account_get_root (fixture->acct);
+    Account *expense = gnc_account_lookup_by_name (root, "expense");
+    Account *taxable = gnc_account_lookup_by_name (root, "taxable");
+    Account *target = gnc_account_lookup_by_code (root, "4160");
+    GList *list;
+
+    g_assert_cmpint (gnc_account_n_descendants (taxable), == , 8);
+    list = gnc_account_get_descendants_sorted (root);
+    g_assert (g_list_nth_data (list, 0) != expense);
+    g_list_free (list);
+
+    gnc_account_append_child (root, target);
+    g_assert_cmpint (gnc_account_n_descendants (taxable), == , 7);
+    g_assert_cmpint (gnc_account_n_descendants (root), == , 34);
+    list = gnc_account_get_descendants (root);
+    g_assert (g_list_last (list)->data == target);
+    g_list_free (list);
+    list = gnc_account_get_descendants (taxable);
+    g_assert (g_list_find (list, target) == NULL);
+    g_list_free (list);
+
+    xaccAccountSetCode (expense, "1000");
+    list = gnc_account_get_descendants_sorted (root);
+    g_assert (g_list_nth_data (list, 0) == expense);
+    g_list_free (list);
+}
 /* gnc_account_lookup_by_name
 Account *
 gnc_account_lookup_by_name (const Account *parent, const char * name)// C: 22 in 12 */
@@ -1743,6 +1847,43 @@ test_gnc_account_lookup_by_full_name (Fixture *fixture, gconstpointer pData)
     g_assert (target == NULL);
     g_free (code);
 }
+/* The lookups go through an index that has to follow the accounts as
+ * they are renamed, moved and destroyed. */
+static void
+test_gnc_account_lookup_after_changes (Fixture *fixture, gconstpointer pData)
+{
+    Account *root = gnc_account_get_root (fixture->acct);
+    Account *taxable, *target;
+
+    target = gnc_account_lookup_by_full_name (root, "income:taxable:int");
+    g_assert (target != NULL);
+    g_assert (gnc_account_lookup_by_code (root, "4160") == target);
+    taxable = gnc_account_get_parent (target);
+
+    xaccAccountSetName (taxable, "taxed");
+    g_assert (gnc_account_lookup_by_full_name (root, "income:taxable:int") == NULL);
+    g_assert (gnc_account_lookup_by_full_name (root, "income:taxed:int") == target);
+    g_assert (gnc_account_lookup_by_name (root, "taxed") == taxable);
+    g_assert (gnc_account_lookup_by_name (root, "taxable") == NULL);
+
+    xaccAccountSetCode (target, "4161");
+    g_assert (gnc_account_lookup_by_code (root, "4160") == NULL);
+    g_assert (gnc_account_lookup_by_code (root, "4161") == target);
+
+    gnc_account_append_child (root, target);
+    g_assert (gnc_account_lookup_by_full_name (root, "income:taxed:int") == NULL);
+    g_assert (gnc_account_lookup_by_full_name (root, "int") == target);
+    g_assert (gnc_account_lookup_by_name (taxable, "int") == NULL);
+    g_assert (gnc_account_lookup_by_name (root, "int") == target);
+
+    xaccAccountBeginEdit (target);
+    xaccAccountDestroy (target);
+    g_assert (gnc_account_lookup_by_full_name (root, "int") == NULL);
+    g_assert (gnc_account_lookup_by_code (root, "4161") == NULL);
+    target = gnc_account_lookup_by_name (root, "int");
+    g_assert (target != NULL);
+    g_assert (gnc_account_lookup_by_full_name (root, "income:exempt:int") == target);
+}
 
 static void
 thunk (Account *s, gpointer data)
@@ -1958,6 +2099,153 @@ test_xaccAccountGetPresentBalance (Fixture *fixture, gconstpointer pData)
     dval = gnc_numeric_to_double (val);
     g_assert_cmpfloat (dval, == , dbal);
 }
+/* xaccAccountGetClearedBalanceAsOfDate
+gnc_numeric
+xaccAccountGetClearedBalanceAsOfDate (Account *acc, time64 date)
+xaccAccountGetReconciledBalanceAsOfDate
+gnc_numeric
+xaccAccountGetReconciledBalanceAsOfDate (Account *acc, time64 date)
+*/
+static void
+test_xaccAccountGetClearedBalanceAsOfDate (Fixture *fixture,
+                                           gconstpointer pData)
+{
+    gnc_numeric val;
+    time64 yesterday = gnc_time (NULL) - 24 * 3600;
+    time64 last_week = gnc_time (NULL) - 24 * 3600 * 8;
+
+    xaccAccountRecomputeBalance (fixture->acct);
+    /* waldo is not reconciled, pepper is cleared and salt reconciled. */
+    val = xaccAccountGetClearedBalanceAsOfDate (fixture->acct, yesterday);
+    g_assert (gnc_numeric_equal (val, gnc_numeric_create (43760, 100)));
+    val = xaccAccountGetReconciledBalanceAsOfDate (fixture->acct, yesterday);
+    g_assert (gnc_numeric_equal (val, gnc_numeric_create (31415, 100)));
+    val = xaccAccountGetClearedBalanceAsOfDate (fixture->acct, last_week);
+    g_assert (gnc_numeric_zero_p (val));
+    val = xaccAccountGetReconciledBalanceAsOfDate (fixture->acct, last_week);
+    g_assert (gnc_numeric_zero_p (val));
+    /* Before the first split there's only the starting balance. */
+    val = xaccAccountGetBalanceAsOfDate (fixture->acct, gnc_time (NULL) -
+                                         24 * 3600 * 30);
+    g_assert (gnc_numeric_zero_p (val));
+    /* After the last one it's the balance of the whole account. */
+    val = xaccAccountGetClearedBalanceAsOfDate (fixture->acct, gnc_time (NULL) +
+                                                24 * 3600 * 30);
+    g_assert (gnc_numeric_equal (val,
+                                 xaccAccountGetClearedBalance (fixture->acct)));
+}
+/* xaccAccountGetBalancesAsOfDates
+GArray *
+xaccAccountGetBalancesAsOfDates (Account *acc, const time64 *dates,
+                                 gsize n_dates,
+                                 gnc_commodity *report_commodity,
+                                 gboolean include_children)
+xaccAccountGetBalanceChangesForPeriods
+GArray *
+xaccAccountGetBalanceChangesForPeriods (Account *acc, const time64 *dates,
+                                        gsize n_dates, gboolean recurse)
+*/
+static void
+test_xaccAccountGetBalancesAsOfDates (Fixture *fixture, gconstpointer pData)
+{
+    QofBook *book = gnc_account_get_book (fixture->acct);
+    Account *root = gnc_account_get_root (fixture->acct);
+    Account *bar = gnc_account_lookup_by_name (root, "bar");
+    Account *foo = gnc_account_lookup_by_name (root, "foo");
+    gnc_commodity *usd = gnc_commodity_new (book, "US Dollar", "CURRENCY",
+                                            "USD", "0", 100);
+    GList *accts = gnc_account_get_descendants (root);
+    time64 now = gnc_time (NULL);
+    /* Before, between and after the fixture's splits, and out of order
+     * at the end. */
+    time64 dates[] = { now - 30 * 86400, now - 8 * 86400, now - 3 * 86400,
+                       now, now + 4 * 86400, now + 30 * 86400,
+                       now - 8 * 86400 };
+    /* meh's running balance at each date; baz's is the negative. */
+    gint64 expected[] = { 0, 150000, 162345, 193760, 170014, 171157, 150000 };
+    const gsize n_dates = G_N_ELEMENTS (dates);
+    GArray *balances, *changes;
+
+    /* xaccAccountSetCommodity would commit the fixture's splits, which
+     * were inserted behind their transactions' backs, so poke the
+     * commodity in directly. */
+    accts = g_list_prepend (accts, root);
+    for (GList *node = accts; node; node = g_list_next (node))
+    {
+        AccountPrivate *priv =
+            fixture->func->get_private (static_cast<Account*>(node->data));
+        priv->commodity = usd;
+        priv->commodity_scu = gnc_commodity_get_fraction (usd);
+        gnc_commodity_increment_usage_count (usd);
+    }
+    g_list_free (accts);
+
+    balances = xaccAccountGetBalancesAsOfDates (fixture->acct, dates, n_dates,
+                                                usd, FALSE);
+    g_assert_cmpuint (balances->len, ==, n_dates);
+    for (gsize i = 0; i < n_dates; ++i)
+    {
+        auto bal = g_array_index (balances, gnc_numeric, i);
+        g_assert (gnc_numeric_equal (bal, gnc_numeric_create (expected[i],
+                                                              100)));
+        g_assert (gnc_numeric_equal (bal,
+                                     xaccAccountGetBalanceAsOfDate (fixture->acct,
+                                                                    dates[i])));
+    }
+    g_array_free (balances, TRUE);
+
+    /* bar has no splits of its own, so only recursion finds meh's. */
+    balances = xaccAccountGetBalancesAsOfDates (bar, dates, n_dates, usd,
+                                                FALSE);
+    for (gsize i = 0; i < n_dates; ++i)
+        g_assert (gnc_numeric_zero_p (g_array_index (balances, gnc_numeric,
+                                                     i)));
+    g_array_free (balances, TRUE);
+
+    balances = xaccAccountGetBalancesAsOfDates (bar, dates, n_dates, usd,
+                                                TRUE);
+    changes = xaccAccountGetBalanceChangesForPeriods (bar, dates, n_dates,
+                                                      TRUE);
+    g_assert_cmpuint (balances->len, ==, n_dates);
+    g_assert_cmpuint (changes->len, ==, n_dates - 1);
+    for (gsize i = 0; i < n_dates; ++i)
+    {
+        auto bal = g_array_index (balances, gnc_numeric, i);
+        g_assert (gnc_numeric_equal (bal, gnc_numeric_create (expected[i],
+                                                              100)));
+        g_assert (gnc_numeric_equal (bal,
+                                     xaccAccountGetBalanceAsOfDateInCurrency (bar,
+                                                                              dates[i],
+                                                                              usd,
+                                                                              TRUE)));
+        if (i == 0)
+            continue;
+        auto change = g_array_index (changes, gnc_numeric, i - 1);
+        g_assert (gnc_numeric_equal (change,
+                                     gnc_numeric_create (expected[i] -
+                                                         expected[i - 1],
+                                                         100)));
+        g_assert (gnc_numeric_equal (change,
+                                     xaccAccountGetBalanceChangeForPeriod (bar,
+                                                                           dates[i - 1],
+                                                                           dates[i],
+                                                                           TRUE)));
+    }
+    g_array_free (balances, TRUE);
+    g_array_free (changes, TRUE);
+
+    /* The report commodity defaults to the account's own. */
+    balances = xaccAccountGetBalancesAsOfDates (foo, dates, n_dates, NULL,
+                                                TRUE);
+    for (gsize i = 0; i < n_dates; ++i)
+        g_assert (gnc_numeric_equal (g_array_index (balances, gnc_numeric, i),
+                                     gnc_numeric_create (-expected[i], 100)));
+    g_array_free (balances, TRUE);
+
+    changes = xaccAccountGetBalanceChangesForPeriods (bar, dates, 1, TRUE);
+    g_assert_cmpuint (changes->len, ==, 0);
+    g_array_free (changes, TRUE);
+}
 /*
  * xaccAccountConvertBalanceToCurrency
  * xaccAccountConvertBalanceToCurrencyAsOfDate are wrappers around
@@ -2558,6 +2846,7 @@ test_suite_account (void)
 // GNC_TEST_ADD (suitename, "xaccAcctChildrenEqual", Fixture, NULL, setup, test_xaccAcctChildrenEqual,  teardown );
 // GNC_TEST_ADD (suitename, "xaccAccountEqual", Fixture, NULL, setup, test_xaccAccountEqual,  teardown );
     GNC_TEST_ADD (suitename, "gnc account insert & remove split", Fixture, NULL, setup, test_gnc_account_insert_remove_split,  teardown );
+    GNC_TEST_ADD (suitename, "xaccAccountSortSplits duplicate", Fixture, NULL, setup, test_xaccAccountSortSplits_duplicate,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccount Insert and Remove Lot", Fixture, &good_data, setup, test_xaccAccountInsertRemoveLot,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountRecomputeBalance", Fixture, &some_data, setup, test_xaccAccountRecomputeBalance,  teardown );
     GNC_TEST_ADD_FUNC (suitename, "xaccAccountOrder", test_xaccAccountOrder );
@@ -2568,10 +2857,12 @@ test_suite_account (void)
     GNC_TEST_ADD (suitename, "gnc account get tree depth", Fixture, &complex, setup, test_gnc_account_get_tree_depth,  teardown );
     GNC_TEST_ADD (suitename, "gnc account get descendants", Fixture, &complex, setup, test_gnc_account_get_descendants,  teardown );
     GNC_TEST_ADD (suitename, "gnc account get descendants sorted", Fixture, &complex, setup, test_gnc_account_get_descendants_sorted,  teardown );
+    GNC_TEST_ADD (suitename, "gnc account descendants after changes", Fixture, &complex, setup, test_gnc_account_descendants_after_changes,  teardown );
     GNC_TEST_ADD (suitename, "gnc account lookup by name", Fixture, &complex, setup, test_gnc_account_lookup_by_name,  teardown );
     GNC_TEST_ADD (suitename, "gnc account lookup by code", Fixture, &complex, setup, test_gnc_account_lookup_by_code,  teardown );
     GNC_TEST_ADD (suitename, "gnc account lookup by full name helper", Fixture, &complex, setup, test_gnc_account_lookup_by_full_name_helper,  teardown );
     GNC_TEST_ADD (suitename, "gnc account lookup by full name", Fixture, &complex, setup, test_gnc_account_lookup_by_full_name,  teardown );
+    GNC_TEST_ADD (suitename, "gnc account lookup after changes", Fixture, &complex, setup, test_gnc_account_lookup_after_changes,  teardown );
     GNC_TEST_ADD (suitename, "gnc account foreach child", Fixture, &complex, setup, test_gnc_account_foreach_child,  teardown );
     GNC_TEST_ADD (suitename, "gnc account foreach descendant", Fixture, &complex, setup, test_gnc_account_foreach_descendant,  teardown );
     GNC_TEST_ADD (suitename, "gnc account foreach descendant until", Fixture, &complex, setup, test_gnc_account_foreach_descendant_until,  teardown );
@@ -2579,6 +2870,8 @@ test_suite_account (void)
     GNC_TEST_ADD (suitename, "xaccAccountGetProjectedMinimumBalance", Fixture, &some_data, setup, test_xaccAccountGetProjectedMinimumBalance,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetBalanceAsOfDate", Fixture, &some_data, setup, test_xaccAccountGetBalanceAsOfDate,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetPresentBalance", Fixture, &some_data, setup, test_xaccAccountGetPresentBalance,  teardown );
+    GNC_TEST_ADD (suitename, "xaccAccountGetClearedBalanceAsOfDate", Fixture, &some_data, setup, test_xaccAccountGetClearedBalanceAsOfDate,  teardown );
+    GNC_TEST_ADD (suitename, "xaccAccountGetBalancesAsOfDates", Fixture, &some_data, setup, test_xaccAccountGetBalancesAsOfDates,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountFindOpenLots", Fixture, &complex_data, setup, test_xaccAccountFindOpenLots,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountForEachLot", Fixture, &complex_data, setup, test_xaccAccountForEachLot,  teardown );
 
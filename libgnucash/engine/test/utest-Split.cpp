@@ -364,21 +364,40 @@ static void
 test_mark_split (Fixture *fixture, gconstpointer pData)
 {
     gboolean sort_dirty, balance_dirty;
-    g_object_get (fixture->split->acc,
+    Account *acc = fixture->split->acc;
+    g_object_get (acc,
                   "sort-dirty", &sort_dirty,
                   "balance-dirty", &balance_dirty,
                   NULL);
     g_assert_cmpint (sort_dirty, ==, FALSE);
     g_assert_cmpint (balance_dirty, ==, FALSE);
 
+    /* The fixture's split isn't in its account yet, so there's nothing
+     * to mark. */
     mark_split (fixture->split);
 
-    g_object_get (fixture->split->acc,
+    g_object_get (acc,
                   "sort-dirty", &sort_dirty,
                   "balance-dirty", &balance_dirty,
                   NULL);
-    g_assert_cmpint (sort_dirty, ==, TRUE);
+    g_assert_cmpint (sort_dirty, ==, FALSE);
+    g_assert_cmpint (balance_dirty, ==, FALSE);
+
+    /* Once it is, its balance needs recomputing; a lone split can't be
+     * out of order. */
+    fixture->split->orig_acc = acc;
+    g_assert (gnc_account_insert_split (acc, fixture->split));
+    xaccAccountRecomputeBalance (acc);
+    mark_split (fixture->split);
+
+    g_object_get (acc,
+                  "sort-dirty", &sort_dirty,
+                  "balance-dirty", &balance_dirty,
+                  NULL);
+    g_assert_cmpint (sort_dirty, ==, FALSE);
     g_assert_cmpint (balance_dirty, ==, TRUE);
+    g_assert (gnc_account_remove_split (acc, fixture->split));
+    fixture->split->orig_acc = NULL;
 }
 // Not Used
 /* xaccSplitEqualCheckBal
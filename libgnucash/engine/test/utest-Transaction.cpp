@@ -273,7 +273,7 @@ test_xaccTransStillHasSplit (Fixture *fixture, gconstpointer pData)
 /* mark_trans
 void mark_trans (Transaction *trans)// Local: 3:0:0
 */
-#define check_split_dirty(xsplit, test)                \
+#define check_split_dirty(xsplit, sort, balance)       \
 {                                                      \
     gboolean sort_dirty, balance_dirty;                \
     auto split = xsplit;                             \
@@ -281,8 +281,8 @@ void mark_trans (Transaction *trans)// Local: 3:0:0
 		  "sort-dirty", &sort_dirty,           \
 		  "balance-dirty", &balance_dirty,     \
 		  NULL);                               \
-    g_assert_cmpint (sort_dirty, ==, test);            \
-    g_assert_cmpint (balance_dirty, ==, test);         \
+    g_assert_cmpint (sort_dirty, ==, sort);            \
+    g_assert_cmpint (balance_dirty, ==, balance);      \
 }
 
 static void
@@ -295,7 +295,7 @@ test_mark_trans (Fixture *fixture, gconstpointer pData)
     {
         if (!splits->data) continue;
         g_assert (!qof_instance_get_dirty_flag (splits->data));
-        check_split_dirty (static_cast<Split*>(splits->data), FALSE);
+        check_split_dirty (static_cast<Split*>(splits->data), FALSE, FALSE);
     }
     fixture->func->mark_trans (fixture->txn);
     g_assert (!qof_instance_get_dirty_flag (fixture->txn));
@@ -303,7 +303,9 @@ test_mark_trans (Fixture *fixture, gconstpointer pData)
     {
         if (!splits->data) continue;
         g_assert (!qof_instance_get_dirty_flag (splits->data));
-        check_split_dirty (static_cast<Split*>(splits->data), TRUE);
+        /* Each split is alone in its account, so it can't be out of
+         * order, but its balance has to be recomputed. */
+        check_split_dirty (static_cast<Split*>(splits->data), FALSE, TRUE);
     }
 }
 /* gen_event_trans
@@ -737,6 +737,70 @@ gnc_pricedb_add_price(GNCPriceDB *db, GNCPrice *p)// C: 7 in 7 SCM: 1  Local: 0:
 test_gnc_pricedb_add_price (Fixture *fixture, gconstpointer pData)
 {
 }*/
+/* gnc_pricedb_add_prices
+int
+gnc_pricedb_add_prices (GNCPriceDB *db, PriceList *prices)// C: 1 in 1  Local: 0:0:0
+*/
+static void
+test_gnc_pricedb_add_prices (PriceDBFixture *fixture, gconstpointer pData)
+{
+    GNCPriceDB *db = fixture->pricedb;
+    QofBook *book = qof_instance_get_book(QOF_INSTANCE(db));
+    Commodities *c = fixture->com;
+    GNCPrice *price;
+    PriceList *prices = NULL;
+    /* Loses to the Finance::Quote price already on that day. */
+    GNCPrice *worse = construct_price(book, c->usd, c->aud,
+                                      gnc_dmy2timespec(12, 11, 2014),
+                                      PRICE_SOURCE_USER_PRICE,
+                                      gnc_numeric_create(2, 1));
+    /* Two the same day, the other way round: the editor's price wins. */
+    GNCPrice *fq = construct_price(book, c->usd, c->aud,
+                                   gnc_dmy2timespec(13, 11, 2014),
+                                   PRICE_SOURCE_FQ, gnc_numeric_create(3, 1));
+    GNCPrice *edited = construct_price(book, c->aud, c->usd,
+                                       gnc_dmy2timespec(13, 11, 2014),
+                                       PRICE_SOURCE_EDIT_DLG,
+                                       gnc_numeric_create(4, 1));
+    GNCPrice *newer = construct_price(book, c->usd, c->aud,
+                                      gnc_dmy2timespec(14, 11, 2014),
+                                      PRICE_SOURCE_FQ,
+                                      gnc_numeric_create(5, 1));
+    /* Replaces the Finance::Quote price of that day. */
+    GNCPrice *better = construct_price(book, c->usd, c->aud,
+                                       gnc_dmy2timespec(11, 4, 2009),
+                                       PRICE_SOURCE_EDIT_DLG,
+                                       gnc_numeric_create(6, 1));
+
+    prices = g_list_prepend(prices, better);
+    prices = g_list_prepend(prices, newer);
+    prices = g_list_prepend(prices, NULL);
+    prices = g_list_prepend(prices, edited);
+    prices = g_list_prepend(prices, fq);
+    prices = g_list_prepend(prices, worse);
+    g_assert_cmpint(gnc_pricedb_add_prices(db, prices), ==, 3);
+    g_assert_cmpint(gnc_pricedb_get_num_prices(db), ==, 44);
+
+    price = gnc_pricedb_lookup_day(db, c->usd, c->aud,
+                                   gnc_dmy2timespec(12, 11, 2014));
+    g_assert(gnc_numeric_equal(gnc_price_get_value(price),
+                               gnc_numeric_create(114784, 100000)));
+    gnc_price_unref(price);
+    price = gnc_pricedb_lookup_day(db, c->usd, c->aud,
+                                   gnc_dmy2timespec(13, 11, 2014));
+    g_assert(price == edited);
+    gnc_price_unref(price);
+    price = gnc_pricedb_lookup_latest(db, c->usd, c->aud);
+    g_assert(price == newer);
+    gnc_price_unref(price);
+    price = gnc_pricedb_lookup_day(db, c->usd, c->aud,
+                                   gnc_dmy2timespec(11, 4, 2009));
+    g_assert(price == better);
+    gnc_price_unref(price);
+
+    g_list_foreach(prices, (GFunc)gnc_price_unref, NULL);
+    g_list_free(prices);
+}
 /* remove_price
 static gboolean
 remove_price(GNCPriceDB *db, GNCPrice *p, gboolean cleanup)// Local: 4:0:0
@@ -1093,11 +1157,25 @@ test_gnc_pricedb_lookup_day (PriceDBFixture *fixture, gconstpointer pData)
     g_log_set_default_handler (hdlr, 0);
 }
 
-// Not Used
 /* gnc_pricedb_lookup_at_time
 GNCPrice *
 gnc_pricedb_lookup_at_time(GNCPriceDB *db,// Local: 0:0:0
 */
+static void
+test_gnc_pricedb_lookup_at_time (PriceDBFixture *fixture, gconstpointer pData)
+{
+    Timespec t = gnc_dmy2timespec(17, 11, 2012);
+    GNCPrice *price = gnc_pricedb_lookup_at_time(fixture->pricedb,
+                                                 fixture->com->usd,
+                                                 fixture->com->gbp, t);
+    g_assert_cmpstr(GET_COM_NAME(price), ==, "GBP");
+    g_assert_cmpstr(GET_CUR_NAME(price), ==, "USD");
+    gnc_price_unref(price);
+    t.tv_sec += 1;
+    price = gnc_pricedb_lookup_at_time(fixture->pricedb, fixture->com->usd,
+                                       fixture->com->gbp, t);
+    g_assert(price == NULL);
+}
 /* lookup_nearest_in_time
 static GNCPrice *
 lookup_nearest_in_time(GNCPriceDB *db,// Local: 2:0:0
@@ -1125,17 +1203,40 @@ test_gnc_pricedb_lookup_nearest_in_time (PriceDBFixture *fixture, gconstpointer
     g_assert_cmpstr(GET_CUR_NAME(price), ==, "AUD");
     g_assert_cmpstr(GET_COM_NAME(price), ==, "USD");
 }
-// Not Used
 /* gnc_pricedb_lookup_latest_before
 GNCPrice *
 gnc_pricedb_lookup_latest_before (GNCPriceDB *db,// Local: 0:0:0
 */
-/* direct_balance_conversion
+static void
+test_gnc_pricedb_lookup_latest_before (PriceDBFixture *fixture, gconstpointer pData)
+{
+    Timespec t1 = gnc_dmy2timespec(1, 1, 2012);
+    Timespec t2 = gnc_dmy2timespec(1, 1, 2015);
+    Timespec t3 = gnc_dmy2timespec(1, 1, 2009);
+    GNCPrice *price =
+        gnc_pricedb_lookup_latest_before(fixture->pricedb, fixture->com->usd,
+                                         fixture->com->aud, t1);
+    /* The reverse price of 20 July 2011 is newer than the forward one. */
+    g_assert_cmpstr(GET_COM_NAME(price), ==, "AUD");
+    g_assert_cmpstr(GET_CUR_NAME(price), ==, "USD");
+    gnc_price_unref(price);
+    price =
+        gnc_pricedb_lookup_latest_before(fixture->pricedb, fixture->com->usd,
+                                         fixture->com->aud, t2);
+    g_assert_cmpstr(GET_COM_NAME(price), ==, "USD");
+    g_assert_cmpstr(GET_CUR_NAME(price), ==, "AUD");
+    gnc_price_unref(price);
+    price =
+        gnc_pricedb_lookup_latest_before(fixture->pricedb, fixture->com->usd,
+                                         fixture->com->aud, t3);
+    g_assert(price == NULL);
+}
+/* direct_price_conversion
 static gnc_numeric
-direct_balance_conversion (GNCPriceDB *db, gnc_numeric bal,// Local: 2:0:0
+direct_price_conversion (GNCPriceDB *db, const gnc_commodity *from,// Local: 1:0:0
 */
 /* static void
-test_direct_balance_conversion (Fixture *fixture, gconstpointer pData)
+test_direct_price_conversion (Fixture *fixture, gconstpointer pData)
 {
 }*/
 /* extract_common_prices
@@ -1146,22 +1247,67 @@ extract_common_prices (PriceList *from_prices, PriceList *to_prices)// Local: 1:
 test_extract_common_prices (Fixture *fixture, gconstpointer pData)
 {
 }*/
-/* convert_balance
+/* convert_price
 static gnc_numeric
-convert_balance(gnc_numeric bal, const gnc_commodity *from,// Local: 1:0:0
+convert_price (const gnc_commodity *from, const gnc_commodity *to,// Local: 1:0:0
 */
 /* static void
-test_convert_balance (Fixture *fixture, gconstpointer pData)
+test_convert_price (Fixture *fixture, gconstpointer pData)
 {
 }*/
-/* indirect_balance_conversion
+/* indirect_price_conversion
 static gnc_numeric
-indirect_balance_conversion (GNCPriceDB *db, gnc_numeric bal,// Local: 2:0:0
+indirect_price_conversion (GNCPriceDB *db, const gnc_commodity *from,// Local: 1:0:0
 */
 /* static void
-test_indirect_balance_conversion (Fixture *fixture, gconstpointer pData)
+test_indirect_price_conversion (Fixture *fixture, gconstpointer pData)
 {
 }*/
+/* gnc_pricedb_get_latest_price
+gnc_numeric
+gnc_pricedb_get_latest_price (GNCPriceDB *pdb,// C: 1  Local: 0:0:0
+*/
+static void
+test_gnc_pricedb_get_latest_price (PriceDBFixture *fixture, gconstpointer pData)
+{
+    gnc_numeric from = gnc_numeric_create(10000, 100);
+    gnc_numeric price =
+        gnc_pricedb_get_latest_price(fixture->pricedb, fixture->com->usd,
+                                     fixture->com->usd);
+    g_assert(gnc_numeric_equal(price, gnc_numeric_create(1, 1)));
+    /* Direct */
+    price = gnc_pricedb_get_latest_price(fixture->pricedb, fixture->com->usd,
+                                         fixture->com->aud);
+    price = gnc_numeric_mul(from, price, 100, GNC_HOW_RND_ROUND);
+    g_assert_cmpint(price.num, ==, 11478);
+    /* Through a third currency */
+    price = gnc_pricedb_get_latest_price(fixture->pricedb, fixture->com->gbp,
+                                         fixture->com->dkk);
+    price = gnc_numeric_mul(from, price, 100, GNC_HOW_RND_ROUND);
+    g_assert_cmpint(price.num, ==, 94389);
+    /* Through USD and GBP */
+    price = gnc_pricedb_get_latest_price(fixture->pricedb, fixture->com->amzn,
+                                         fixture->com->eur);
+    price = gnc_numeric_mul(from, price, 100, GNC_HOW_RND_ROUND);
+    g_assert_cmpint(price.num, ==, 2506101);
+    /* A new price replaces the remembered rate */
+    gnc_pricedb_add_price(fixture->pricedb,
+                          construct_price(qof_instance_get_book(fixture->pricedb),
+                                          fixture->com->gbp, fixture->com->eur,
+                                          gnc_dmy2timespec(13, 11, 2014),
+                                          PRICE_SOURCE_FQ,
+                                          gnc_numeric_create(2, 1)));
+    price = gnc_pricedb_get_latest_price(fixture->pricedb, fixture->com->amzn,
+                                         fixture->com->eur);
+    price = gnc_numeric_mul(from, price, 100, GNC_HOW_RND_ROUND);
+    g_assert_cmpint(price.num, ==, 3951718);
+    /* And at a date */
+    price = gnc_pricedb_get_nearest_price(fixture->pricedb, fixture->com->amzn,
+                                          fixture->com->aud,
+                                          gnc_dmy2time64(15, 8, 2011));
+    price = gnc_numeric_mul(from, price, 100, GNC_HOW_RND_ROUND);
+    g_assert_cmpint(price.num, ==, 2089782);
+}
 /* gnc_pricedb_convert_balance_latest_price
 gnc_numeric
 gnc_pricedb_convert_balance_latest_price(GNCPriceDB *pdb,// C: 2 in 2  Local: 0:0:0
@@ -1462,6 +1608,7 @@ test_suite_gnc_pricedb (void)
 // GNC_TEST_ADD (suitename, "insert or replace price", Fixture, NULL, setup, test_insert_or_replace_price, teardown);
 // GNC_TEST_ADD (suitename, "add price", Fixture, NULL, setup, test_add_price, teardown);
 // GNC_TEST_ADD (suitename, "gnc pricedb add price", Fixture, NULL, setup, test_gnc_pricedb_add_price, teardown);
+    GNC_TEST_ADD (suitename, "gnc pricedb add prices", PriceDBFixture, NULL, setup, test_gnc_pricedb_add_prices, teardown);
 // GNC_TEST_ADD (suitename, "remove price", Fixture, NULL, setup, test_remove_price, teardown);
 // GNC_TEST_ADD (suitename, "gnc pricedb remove price", Fixture, NULL, setup, test_gnc_pricedb_remove_price, teardown);
 // GNC_TEST_ADD (suitename, "check one price date", Fixture, NULL, setup, test_check_one_price_date, teardown);
@@ -1485,11 +1632,14 @@ test_suite_gnc_pricedb (void)
     GNC_TEST_ADD (suitename, "gnc pricedb get prices", PriceDBFixture, NULL, setup, test_gnc_pricedb_get_prices, teardown);
     GNC_TEST_ADD (suitename, "gnc pricedb lookup day", PriceDBFixture, NULL, setup, test_gnc_pricedb_lookup_day, teardown);
 // GNC_TEST_ADD (suitename, "lookup nearest in time", Fixture, NULL, setup, test_lookup_nearest_in_time, teardown);
+    GNC_TEST_ADD (suitename, "gnc pricedb lookup at time", PriceDBFixture, NULL, setup, test_gnc_pricedb_lookup_at_time, teardown);
     GNC_TEST_ADD (suitename, "gnc pricedb lookup nearest in time", PriceDBFixture, NULL, setup, test_gnc_pricedb_lookup_nearest_in_time, teardown);
-// GNC_TEST_ADD (suitename, "direct balance conversion", Fixture, NULL, setup, test_direct_balance_conversion, teardown);
+    GNC_TEST_ADD (suitename, "gnc pricedb lookup latest before", PriceDBFixture, NULL, setup, test_gnc_pricedb_lookup_latest_before, teardown);
+// GNC_TEST_ADD (suitename, "direct price conversion", Fixture, NULL, setup, test_direct_price_conversion, teardown);
 // GNC_TEST_ADD (suitename, "extract common prices", Fixture, NULL, setup, test_extract_common_prices, teardown);
-// GNC_TEST_ADD (suitename, "convert balance", Fixture, NULL, setup, test_convert_balance, teardown);
-// GNC_TEST_ADD (suitename, "indirect balance conversion", Fixture, NULL, setup, test_indirect_balance_conversion, teardown);
+// GNC_TEST_ADD (suitename, "convert price", Fixture, NULL, setup, test_convert_price, teardown);
+// GNC_TEST_ADD (suitename, "indirect price conversion", Fixture, NULL, setup, test_indirect_price_conversion, teardown);
+    GNC_TEST_ADD (suitename, "gnc pricedb get latest price", PriceDBFixture, NULL, setup, test_gnc_pricedb_get_latest_price, teardown);
     GNC_TEST_ADD (suitename, "gnc pricedb convert balance latest price", PriceDBFixture, NULL, setup, test_gnc_pricedb_convert_balance_latest_price, teardown);
     GNC_TEST_ADD (suitename, "gnc pricedb convert balance nearest price", PriceDBFixture, NULL, setup, test_gnc_pricedb_convert_balance_nearest_price, teardown);
 // GNC_TEST_ADD (suitename, "pricedb foreach pricelist", Fixture, NULL, setup, test_pricedb_foreach_pricelist, teardown);
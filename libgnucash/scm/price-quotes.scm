@@ -455,15 +455,11 @@
       ))
 
   (define (book-add-prices! book prices)
-    (let ((pricedb (gnc-pricedb-get-db book)))
-      (for-each
-       (lambda (price)
-         (if price
-             (begin
-               (gnc-pricedb-add-price pricedb price)
-               (gnc-price-unref price)
-               #f)))
-       prices)))
+    (let ((pricedb (gnc-pricedb-get-db book))
+          (new-prices (filter identity prices)))
+      ;; Add them in one go so the pricedb is only committed once.
+      (gnc-pricedb-add-prices pricedb new-prices)
+      (for-each gnc-price-unref new-prices)))
 
   ;; Add the alphavantage api key to the environment. This value is taken from
   ;; the Online Quotes preference tab